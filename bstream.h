@@ -7,9 +7,64 @@
 #include <fstream>
 #include <cstring>
 #include <cassert>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <functional>
+#include <memory>
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+#include <cerrno>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#endif
+
+#if defined(BSTREAM_ASYNC) && defined(__cpp_impl_coroutine) && defined(__unix__)
+#include <coroutine>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <cerrno>
+#endif
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__x86_64__) && (defined(__SSE4_2__) || defined(__GNUC__))
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
 
 namespace bStream {
 
+uint64_t swap64(uint64_t v);
 uint32_t swap32(uint32_t v);
 uint16_t swap16(uint16_t v);
 
@@ -38,8 +93,151 @@ enum Endianess{
 
 Endianess getSystemEndianess();
 
+enum PageBacking {
+	NormalPages,
+	HugePages
+};
+
+enum StreamError {
+	NoError,
+	OutOfBounds,
+	// A write to a stream over read only memory, such as a CMappedFileStream opened for reading
+	ReadOnly,
+	// writeOffsetAt32 was asked to store a position past 4 GiB, use writeOffsetAt64
+	OffsetOverflow,
+	// A chunk shared with a snapshot could not be copied before writing to it
+	AllocationFailed
+};
+
+// Transcoders between UTF-8 and the Shift-JIS (code page 932) and UTF-16BE text found in asset
+// names. Each returns the number of bytes written to out, which needs room for 3 * len bytes when
+// decoding to UTF-8 and 2 * len when encoding. Invalid input becomes U+FFFD, or '?' in Shift-JIS.
+std::size_t sjisToUtf8(const uint8_t*, std::size_t, char*);
+std::size_t utf16beToUtf8(const uint8_t*, std::size_t, char*);
+std::size_t utf8ToSjis(const char*, std::size_t, uint8_t*);
+std::size_t utf8ToUtf16be(const char*, std::size_t, uint8_t*);
+
+// Define BSTREAM_INSTRUMENTATION before including bStream to count reads, writes, seeks and
+// buffer growth per stream. When it is not defined the counters compile away entirely.
+#if defined(BSTREAM_INSTRUMENTATION)
+
+struct StreamStats {
+	uint64_t bytesRead = 0;
+	uint64_t bytesWritten = 0;
+	uint64_t reads = 0;
+	uint64_t writes = 0;
+	uint64_t seeks = 0;
+	uint64_t peeks = 0;
+	uint64_t reallocations = 0;
+	uint64_t bytesCopiedByGrowth = 0;
+	uint64_t ioNanoseconds = 0;
+
+	void reset();
+	StreamStats& operator+=(const StreamStats&);
+};
+
+// Per stream counters, registered with CStatsRegistry for as long as the owning stream lives
+class CStreamStats : public StreamStats {
+public:
+	std::string name;
+
+	CStreamStats(const char* n = "");
+	CStreamStats(const CStreamStats&);
+	CStreamStats& operator=(const CStreamStats&);
+	~CStreamStats();
+};
+
+class CStatsRegistry {
+private:
+	std::mutex mLock;
+	std::vector<CStreamStats*> mLive;
+	StreamStats mRetired;
+
+public:
+	static CStatsRegistry& instance();
+
+	void add(CStreamStats*);
+	void remove(CStreamStats*);
+
+	// Sum of every live stream plus every stream that has already been destroyed
+	StreamStats total();
+	void dump(std::ostream& out = std::cout);
+};
+
+class CScopedIOTimer {
+private:
+	StreamStats& mStats;
+	std::chrono::steady_clock::time_point mStart;
+
+public:
+	CScopedIOTimer(StreamStats& s) : mStats(s), mStart(std::chrono::steady_clock::now()) {}
+	~CScopedIOTimer(){
+		mStats.ioNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart).count();
+	}
+};
+
+#define BSTREAM_STAT_READ(n) (mStats.reads++, mStats.bytesRead += (n))
+#define BSTREAM_STAT_WRITE(n) (mStats.writes++, mStats.bytesWritten += (n))
+#define BSTREAM_STAT_SEEK() (mStats.seeks++)
+#define BSTREAM_STAT_PEEK(n) (mStats.peeks++, mStats.bytesRead += (n))
+#define BSTREAM_STAT_GROW(copied) (mStats.reallocations++, mStats.bytesCopiedByGrowth += (copied))
+#define BSTREAM_IO_TIMER() bStream::CScopedIOTimer bstreamIOTimer(mStats)
+
+#else
+
+#define BSTREAM_STAT_READ(n) ((void)0)
+#define BSTREAM_STAT_WRITE(n) ((void)0)
+#define BSTREAM_STAT_SEEK() ((void)0)
+#define BSTREAM_STAT_PEEK(n) ((void)0)
+#define BSTREAM_STAT_GROW(copied) ((void)0)
+#define BSTREAM_IO_TIMER() ((void)0)
+
+#endif
+
+enum ChecksumType {
+	Crc32,
+	Crc32c
+};
+
+// Running checksum fed by the stream read and write functions. Crc32 matches zlib, Crc32c uses
+// the SSE4.2 / ARMv8 crc32 instructions when the compiler targets them.
+class CChecksum {
+	private:
+		ChecksumType mType;
+		uint32_t mCrc;
+
+	public:
+		void update(const void*, std::size_t);
+		void reset();
+		uint32_t value();
+		ChecksumType getType();
+
+		CChecksum(ChecksumType type = ChecksumType::Crc32) : mType(type), mCrc(0xFFFFFFFF) {}
+};
+
+#define BSTREAM_CHECKSUM(ptr, n) do { if(mChecksum) mChecksum->update((ptr), (n)); } while(0)
+
+// One attribute of an interleaved record for readAttributes, e.g. { 12, 4, 3, normals } for three
+// floats 12 bytes into each vertex. width is 1, 2, 4 or 8, out receives count values per record
+// in host order and needs room for records * count * width bytes.
+struct StreamAttribute {
+	std::size_t offset;
+	uint8_t width;
+	std::size_t count;
+	void* out;
+};
+
+// One request for readRanges, length bytes at the absolute stream offset are copied to out
+struct ReadRange {
+	std::size_t offset;
+	std::size_t length;
+	void* out;
+};
+
 class CStream {
 	public:
+		virtual ~CStream() = default;
+
 		virtual bool seek(std::size_t, bool = false) = 0;
 		virtual void skip(std::size_t) = 0;
 		virtual std::size_t tell() = 0;
@@ -49,10 +247,13 @@ class CStream {
 		virtual uint8_t readUInt8() = 0;
 		virtual uint16_t readUInt16() = 0;
 		virtual uint32_t readUInt32() = 0;
+		// The 64 bit calls fall back on readBytesTo, writeBytes and seek for streams that predate them
+		virtual uint64_t readUInt64();
 
 		virtual int8_t readInt8() = 0;
 		virtual int16_t readInt16() = 0;
 		virtual int32_t readInt32() = 0;
+		virtual int64_t readInt64();
 
 		virtual float readFloat() = 0;
 		virtual void writeFloat(float) = 0;
@@ -67,13 +268,17 @@ class CStream {
 		virtual uint16_t peekUInt16(std::size_t) = 0;
 
 		virtual int32_t peekInt32(std::size_t) = 0;
+		virtual int64_t peekInt64(std::size_t);
 		virtual uint32_t peekUInt32(std::size_t) = 0;
+		virtual uint64_t peekUInt64(std::size_t);
 
 		virtual void writeInt8(int8_t) = 0;
 		virtual void writeUInt8(uint8_t) = 0;
 
 		virtual void writeInt32(int32_t) = 0;
+		virtual void writeInt64(int64_t);
 		virtual void writeUInt32(uint32_t) = 0;
+		virtual void writeUInt64(uint64_t);
 
 		virtual void writeInt16(int16_t) = 0;
 		virtual void writeUInt16(uint16_t) = 0;
@@ -85,6 +290,7 @@ class CStream {
 
 		virtual void writeOffsetAt16(std::size_t) = 0;
 		virtual void writeOffsetAt32(std::size_t) = 0;
+		virtual void writeOffsetAt64(std::size_t);
 
 		virtual void writeString(std::string) = 0;
 		virtual std::string peekString(std::size_t, std::size_t) = 0;
@@ -92,8 +298,39 @@ class CStream {
 
 		virtual Endianess getOrder() = 0;
 		virtual void setOrder(Endianess) = 0;
+
+		// Copies up to len bytes from the current position into dst, stopping at the end of the source.
+		// Returns the number of bytes copied
+		virtual std::size_t copyTo(CStream&, std::size_t);
+
+		// Read len bytes of Shift-JIS or UTF-16BE text as UTF-8, stopping at the end of the stream.
+		// The buffer versions decode into out, which needs 3 * len bytes, and return the UTF-8 length.
+		std::string readStringSJIS(std::size_t);
+		std::string readStringUTF16BE(std::size_t);
+		virtual std::size_t readStringSJIS(std::size_t, char*);
+		virtual std::size_t readStringUTF16BE(std::size_t, char*);
+
+		// Encode UTF-8 text and write it, returns the number of bytes written
+		std::size_t writeStringSJIS(const std::string& str) { return writeStringSJIS(str.data(), str.size()); }
+		std::size_t writeStringUTF16BE(const std::string& str) { return writeStringUTF16BE(str.data(), str.size()); }
+		virtual std::size_t writeStringSJIS(const char*, std::size_t);
+		virtual std::size_t writeStringUTF16BE(const char*, std::size_t);
+
+		// Reads count records of stride bytes and splits each attribute out into its own array.
+		// Returns false without reading if an attribute does not fit in the stride or the stream
+		// holds fewer than count records.
+		virtual bool readAttributes(std::size_t, std::size_t, const std::vector<StreamAttribute>&);
+
+		// Reads a batch of ranges in offset order. Ranges separated by at most maxGap bytes are
+		// fetched together, the gap being read and thrown away. Like peeks this leaves the position
+		// where it was and skips the checksum. Returns false if any range could not be read in full,
+		// the indices of those ranges are appended to failed when it is given.
+		virtual bool readRanges(const std::vector<ReadRange>&, std::size_t maxGap = 0x1000, std::vector<std::size_t>* failed = nullptr);
 };
 
+class CWriteBehind;
+class CChunkStore;
+
 class CFileStream : public CStream {
 private:
 	std::fstream base;
@@ -101,14 +338,29 @@ private:
 	OpenMode mode;
 	Endianess order;
 	Endianess systemOrder;
+#if defined(BSTREAM_INSTRUMENTATION)
+	CStreamStats mStats { "file" };
+#endif
+	CChecksum* mChecksum = nullptr;
+	CWriteBehind* mWriteBehind = nullptr;
+	// Set to OffsetOverflow when a 32 bit offset would not fit, that patch is skipped
+	StreamError mError = StreamError::NoError;
+
+	void writeRaw(const void*, std::size_t);
+	void writePatch(std::size_t, const void*, std::size_t);
+	void peekRaw(std::size_t, void*, std::size_t);
+	std::size_t copyBuffered(CStream&, std::size_t);
 
 public:
 
 	template<typename T>
 	T readStruct(){
 		assert(mode == OpenMode::In);
+		BSTREAM_IO_TIMER();
+		BSTREAM_STAT_READ(sizeof(T));
 		T out;
 		base.read((char*)&out, sizeof(T));
+		BSTREAM_CHECKSUM(&out, base.gcount());
 		return out;
 	}
 
@@ -118,13 +370,18 @@ public:
 	int16_t readInt16();
 	uint16_t readUInt16();
 	int32_t readInt32();
+	int64_t readInt64();
 	uint32_t readUInt32();
+	uint64_t readUInt64();
 	float readFloat();
 	double readDouble();
 	char* readBytes(std::size_t);
 	std::string readWString(std::size_t);
 	std::string readString(std::size_t);
 	void readBytesTo(uint8_t*, std::size_t);
+	std::size_t copyTo(CStream&, std::size_t);
+	// Coalesced ranges become one preadv each on POSIX systems
+	bool readRanges(const std::vector<ReadRange>&, std::size_t maxGap = 0x1000, std::vector<std::size_t>* failed = nullptr);
 
 	//write functions
 	void writeInt8(int8_t);
@@ -132,7 +389,9 @@ public:
 	void writeInt16(int16_t);
 	void writeUInt16(uint16_t);
 	void writeInt32(int32_t);
+	void writeInt64(int64_t);
 	void writeUInt32(uint32_t);
+	void writeUInt64(uint64_t);
 	void writeFloat(float);
 	void writeDouble(double);
 	void writeBytes(uint8_t*, std::size_t);
@@ -142,6 +401,7 @@ public:
 
 	void writeOffsetAt16(std::size_t);
 	void writeOffsetAt32(std::size_t);
+	void writeOffsetAt64(std::size_t);
 
 	Endianess getOrder();
 	void setOrder(Endianess);
@@ -160,34 +420,236 @@ public:
 	uint16_t peekUInt16(std::size_t);
 
 	int32_t peekInt32(std::size_t);
+	int64_t peekInt64(std::size_t);
 	uint32_t peekUInt32(std::size_t);
+	uint64_t peekUInt64(std::size_t);
 
 	std::string peekString(std::size_t, std::size_t);
 
 	std::fstream &getStream();
 
+	StreamError getError() { return mError; }
+	bool good() { return mError == StreamError::NoError; }
+	void clearError() { mError = StreamError::NoError; }
+
+	// Every byte read or written from here on is fed to checksum, pass nullptr to detach.
+	// Peeks and writeOffsetAt patches are not included.
+	void setChecksum(CChecksum*);
+
+	// Buffers output and flushes it from a background thread while the next buffer fills.
+	// When expectedSize is known the file is preallocated up front and trimmed on close.
+	bool enableWriteBehind(std::size_t bufferSize = 0x100000, std::size_t expectedSize = 0);
+	// Flushes any buffered output, returns false if a background write failed
+	bool disableWriteBehind();
+
+#if defined(BSTREAM_INSTRUMENTATION)
+	const StreamStats& getStats() { return mStats; }
+	void resetStats() { mStats.reset(); }
+#endif
+
 	CFileStream(std::string, Endianess, OpenMode mod = OpenMode::In);
 	CFileStream(std::string, OpenMode mod = OpenMode::In);
 	CFileStream() {}
-	~CFileStream() { this->base.close(); }
+	~CFileStream() { disableWriteBehind(); this->base.close(); }
 };
 
-class CMemoryStream : public CStream {
+// Describes a table of fixed size records for in place byte swapping. fields lists the width in
+// bytes (1, 2, 4 or 8) of each field of a record in order, stride is the distance between record
+// starts and defaults to the sum of the field widths.
+struct SwapLayout {
+	std::vector<uint8_t> fields;
+	std::size_t stride;
+	std::size_t count;
+};
+
+// Recycles CMemoryStream buffers in power of two size classes. Each thread keeps a small cache
+// of its own so parallel workers rarely touch the shared lists. Pooled buffers are not cleared
+// when handed out again.
+class CBufferPool {
+	public:
+		static const std::size_t MinClassShift = 8;
+		static const std::size_t MaxClassShift = 26;
+		static const std::size_t ClassCount = MaxClassShift - MinClassShift + 1;
+		static const std::size_t ThreadCacheDepth = 8;
+
+		struct Stats {
+			uint64_t acquires;
+			uint64_t hits;
+			double hitRate;
+			std::size_t retainedBytes;
+			std::size_t peakRetainedBytes;
+		};
+
 	private:
-		uint8_t* mBuffer;
-		std::size_t mPosition;
-		std::size_t mSize;
-		std::size_t mCapacity;
-		int8_t mHasInternalBuffer;
+		std::mutex mLock;
+		std::vector<uint8_t*> mShared[ClassCount];
+		std::size_t mMaxRetained;
+		std::atomic<uint64_t> mAcquires;
+		std::atomic<uint64_t> mHits;
+		std::atomic<std::size_t> mRetained;
+		std::atomic<std::size_t> mPeakRetained;
 
-		OpenMode mOpenMode;
-		Endianess order;
-		Endianess systemOrder;
+		struct ThreadCache {
+			std::vector<uint8_t*> classes[ClassCount];
+			~ThreadCache();
+		};
+
+		static ThreadCache& threadCache();
+		static std::size_t classIndex(std::size_t);
+
+		void retain(std::size_t);
+		bool releaseShared(uint8_t*, std::size_t);
+
+		CBufferPool();
+		~CBufferPool();
+
+	public:
+		static CBufferPool& instance();
+
+		// Returns a buffer of at least capacity bytes, capacity is updated to the real size
+		uint8_t* acquire(std::size_t& capacity);
+		void release(uint8_t*, std::size_t capacity);
+
+		// Buffers beyond this many retained bytes are freed instead of pooled
+		void setMaxRetained(std::size_t);
+		// Frees every buffer held in the shared lists and the calling thread's cache
+		void trim();
+
+		Stats getStats();
+};
+
+class CMemoryStream : public CStream {
+	protected:
+		uint8_t* mBuffer = nullptr;
+		std::size_t mPosition = 0;
+		std::size_t mSize = 0;
+		std::size_t mCapacity = 0;
+		int8_t mHasInternalBuffer = false;
+
+		OpenMode mOpenMode = OpenMode::In;
+		Endianess order = getSystemEndianess();
+		Endianess systemOrder = getSystemEndianess();
+#if defined(BSTREAM_INSTRUMENTATION)
+		CStreamStats mStats { "memory" };
+#endif
+		CChecksum* mChecksum = nullptr;
+		StreamError mError = StreamError::NoError;
+		CBufferPool* mPool = nullptr;
+		PageBacking mBacking = PageBacking::NormalPages;
+		bool mBufferMapped = false;
+		// Set for memory that must never be written, such as a read only file mapping
+		bool mReadOnly = false;
+
+		// A region converted with convertToNative, records of stride bytes from start to end whose
+		// first fields bytes were swapped. Padding after the fields was left alone.
+		struct NativeRange {
+			std::size_t start;
+			std::size_t end;
+			std::size_t stride;
+			std::size_t fields;
+		};
+
+		// Sorted and non overlapping. Reads and writes that land on converted fields skip swapping.
+		std::vector<NativeRange> mNativeRanges;
+		std::size_t mLastNativeRange = 0;
+
+		bool inNativeRange(std::size_t);
+
+		bool needsSwap(std::size_t at){
+			if(order == systemOrder) return false;
+			return mNativeRanges.empty() || !inNativeRange(at);
+		}
+
+		bool swapRegion(std::size_t, const SwapLayout&, std::size_t&, bool);
+
+		uint8_t* allocateBuffer(std::size_t&);
+		void releaseBuffer(uint8_t*, std::size_t, bool);
+		void growBuffer(std::size_t);
+		// Makes room for at least capacity bytes, returns false if the buffer can't grow
+		virtual bool grow(std::size_t);
+
+		// Set once the stream has been snapshotted. The buffer is then a view stitched together
+		// from chunks of a store shared with the snapshots, mChunkSlots gives each chunk's slot
+		// and mChunkOwned marks chunks no other view maps, which can be written in place.
+		std::shared_ptr<CChunkStore> mChunks;
+		std::vector<uint32_t> mChunkSlots;
+		std::vector<uint8_t> mChunkOwned;
+
+		bool shareBuffer();
+		bool shareInto(CMemoryStream&);
+		uint8_t* mapChunks(std::size_t);
+		bool growChunks(std::size_t);
+		void releaseChunks();
+		// Gives this view a private copy of every shared chunk in [at, at + len), returns false if
+		// a copy could not be made
+		bool unshare(std::size_t, std::size_t);
+
+		friend class CFileStream;
+		friend class CFileLoader;
+
+		// Makes room for len bytes at at and copies any chunks shared with a snapshot, on failure
+		// the stream is flagged and the write is skipped
+		bool prepareWrite(std::size_t at, std::size_t len){
+			if(mReadOnly){
+				mError = StreamError::ReadOnly;
+				return false;
+			}
+			if(!Reserve(at + len)){
+				mError = StreamError::OutOfBounds;
+				return false;
+			}
+			if(mChunks && !unshare(at, len)){
+				mError = StreamError::AllocationFailed;
+				return false;
+			}
+			return true;
+		}
 
 	public:
 		bool Reserve(std::size_t);
 		bool setSize(std::size_t);
 
+		// Validates that len bytes can be read from the current position, or from at for ensureAt.
+		// A failed check flags the stream as OutOfBounds until clearError is called. The regular
+		// reads and peeks check themselves this way and return 0 or an empty string on failure.
+		// A parser that calls ensure once per record can then use readUnchecked for its fields.
+		bool ensure(std::size_t len){
+			return ensureAt(mPosition, len);
+		}
+
+		bool ensureAt(std::size_t at, std::size_t len){
+			if(at <= mSize && len <= mSize - at) return true;
+			mError = StreamError::OutOfBounds;
+			return false;
+		}
+
+		// Reads a number from a region already validated with ensure, without checking the bounds
+		// again. Reading past the ensured region is undefined, debug builds assert.
+		template<typename T>
+		T readUnchecked(){
+			static_assert(std::is_arithmetic<T>::value, "readUnchecked reads plain numbers");
+			assert(mOpenMode == OpenMode::In);
+			assert(mPosition <= mSize && sizeof(T) <= mSize - mPosition);
+			BSTREAM_STAT_READ(sizeof(T));
+			const uint8_t* in = mBuffer + mPosition;
+			BSTREAM_CHECKSUM(in, sizeof(T));
+			T r;
+			if(sizeof(T) > 1 && needsSwap(mPosition)){
+				// Compilers turn the reversed copy into a single byte swap instruction
+				uint8_t bytes[sizeof(T)];
+				for(std::size_t i = 0; i < sizeof(T); i++) bytes[i] = in[sizeof(T) - 1 - i];
+				memcpy(&r, bytes, sizeof(T));
+			} else {
+				memcpy(&r, in, sizeof(T));
+			}
+			mPosition += sizeof(T);
+			return r;
+		}
+
+		StreamError getError() { return mError; }
+		bool good() { return mError == StreamError::NoError; }
+		void clearError() { mError = StreamError::NoError; }
+
 		std::size_t getSize();
 		std::size_t getCapacity();
 
@@ -198,7 +660,9 @@ class CMemoryStream : public CStream {
 		uint16_t readUInt16();
 
 		int32_t readInt32();
+		int64_t readInt64();
 		uint32_t readUInt32();
+		uint64_t readUInt64();
 
 		float readFloat();
 		double readDouble();
@@ -210,7 +674,9 @@ class CMemoryStream : public CStream {
 		uint16_t peekUInt16(std::size_t);
 
 		int32_t peekInt32(std::size_t);
+		int64_t peekInt64(std::size_t);
 		uint32_t peekUInt32(std::size_t);
+		uint64_t peekUInt64(std::size_t);
 
 		void writeInt8(int8_t);
 		void writeUInt8(uint8_t);
@@ -219,7 +685,9 @@ class CMemoryStream : public CStream {
 		void writeUInt16(uint16_t);
 
 		void writeInt32(int32_t);
+		void writeInt64(int64_t);
 		void writeUInt32(uint32_t);
+		void writeUInt64(uint64_t);
 
 		void writeDouble(double);
 		void writeFloat(float);
@@ -230,6 +698,7 @@ class CMemoryStream : public CStream {
 
 		void writeOffsetAt16(std::size_t);
 		void writeOffsetAt32(std::size_t);
+		void writeOffsetAt64(std::size_t);
 
 		Endianess getOrder();
 		void setOrder(Endianess);
@@ -237,6 +706,21 @@ class CMemoryStream : public CStream {
 		std::string readString(std::size_t);
 		std::string peekString(std::size_t, std::size_t);
 		void readBytesTo(uint8_t*, std::size_t);
+		std::size_t copyTo(CStream&, std::size_t);
+
+		// Transcode straight from and into the buffer without a staging copy
+		using CStream::readStringSJIS;
+		using CStream::readStringUTF16BE;
+		using CStream::writeStringSJIS;
+		using CStream::writeStringUTF16BE;
+		std::size_t readStringSJIS(std::size_t, char*);
+		std::size_t readStringUTF16BE(std::size_t, char*);
+		std::size_t writeStringSJIS(const char*, std::size_t);
+		std::size_t writeStringUTF16BE(const char*, std::size_t);
+
+		// Deinterleaves straight out of the buffer, fails if the records run past the end
+		bool readAttributes(std::size_t, std::size_t, const std::vector<StreamAttribute>&);
+		bool readRanges(const std::vector<ReadRange>&, std::size_t maxGap = 0x1000, std::vector<std::size_t>* failed = nullptr);
 
 		bool seek(std::size_t, bool = false);
 		void skip(std::size_t);
@@ -244,872 +728,5875 @@ class CMemoryStream : public CStream {
 
 		uint8_t* getBuffer();
 
-		bool changeMode(OpenMode mode);
+		// Byte swaps the table described by layout at offset to host order in one pass, the region
+		// can then be accessed directly through getBuffer and reads of it no longer swap.
+		// Returns false if the table does not fit inside the stream or overlaps a converted region.
+		bool convertToNative(std::size_t, const SwapLayout&);
+		// Swaps a region converted with convertToNative back to the stream's byte order. Returns false
+		// unless offset and layout match an earlier convertToNative exactly.
+		bool convertFromNative(std::size_t, const SwapLayout&);
+
+		virtual bool changeMode(OpenMode mode);
+
+		// Records that len bytes at offset were modified outside the write functions, e.g. through
+		// getBuffer. Only streams that write back to storage track this.
+		virtual void markDirty(std::size_t, std::size_t) {}
+
+		// Every byte read or written from here on is fed to checksum, pass nullptr to detach.
+		// Peeks and writeOffsetAt patches are not included.
+		void setChecksum(CChecksum*);
+
+		// Returns a copy of the stream that shares memory with it in 64 KiB chunks. A chunk is only
+		// duplicated when one side first writes to it through the write functions, so writes made
+		// through getBuffer must be avoided while snapshots are alive. The first snapshot of a
+		// stream moves its buffer into shared memory once. Streams over a caller's buffer, and
+		// systems without memfd, get a full copy.
+		std::unique_ptr<CMemoryStream> snapshot();
+
+#if defined(BSTREAM_INSTRUMENTATION)
+		const StreamStats& getStats() { return mStats; }
+		void resetStats() { mStats.reset(); }
+#endif
 
 		CMemoryStream(uint8_t*, std::size_t, Endianess, OpenMode);
 		CMemoryStream(std::size_t, Endianess, OpenMode);
+		// Takes its buffer from pool and hands it back on destruction, the contents start out unspecified
+		CMemoryStream(CBufferPool&, std::size_t, Endianess, OpenMode);
+		// With HugePages the internal buffer comes from explicit huge pages when the system has them
+		// reserved, otherwise from a 2 MiB aligned mapping advised for transparent huge pages.
+		// Capacity is rounded up to whole huge pages, buffers under 2 MiB stay on the heap.
+		CMemoryStream(std::size_t, Endianess, OpenMode, PageBacking);
 		CMemoryStream(){}
-		~CMemoryStream(){
-			if(mHasInternalBuffer){
-				delete[] mBuffer;
+		virtual ~CMemoryStream(){
+			if(mChunks){
+				releaseChunks();
+			} else if(mHasInternalBuffer){
+				releaseBuffer(mBuffer, mCapacity, mBufferMapped);
 			}
 		}
 
 };
-}
 
-#if defined(BSTREAM_IMPLEMENTATION)
-namespace bStream {
+#if defined(__unix__)
 
-uint32_t swap32(uint32_t r){
-	return ( ((r>>24)&0xFF) | ((r<<8) & 0xFF0000) | ((r>>8)&0xFF00) | ((r<<24)&0xFF000000));
-}
+// View of a whole file through the CMemoryStream interface, backed by mmap.
+// Opened writable, edits go straight to the mapping and flush writes back only the pages
+// that were touched. Writing past the end grows the file.
+class CMappedFileStream : public CMemoryStream {
+	protected:
+		int mFd;
+		std::string filePath;
+		std::size_t mMappedSize;
+		bool mWritable;
+		std::size_t mPageSize;
 
-uint16_t swap16(uint16_t r){
-	return ( ((r<<8)&0xFF00) | ((r>>8)&0x00FF) );
-}
+		// Page aligned [start, end) ranges modified since the last flush, keyed by start
+		std::map<std::size_t, std::size_t> mDirty;
+		std::size_t mLastDirtyStart;
+		std::size_t mLastDirtyEnd;
 
-Endianess getSystemEndianess(){
-	union {
-		uint32_t integer;
-		uint8_t bytes[sizeof(uint32_t)];
-	} check;
-	check.integer = 0x01020304U;
-	return (check.bytes[0] == 0x01 ? Endianess::Big : Endianess::Little);
-}
+		bool map(std::size_t, int, PageBacking);
+		void unmap();
+		bool grow(std::size_t);
 
-CFileStream::CFileStream(std::string path, Endianess ord, OpenMode mod){
-	base.open(path, (mod == OpenMode::In ? std::ios::in : std::ios::out) | std::ios::binary);
-	base.exceptions(std::ifstream::badbit);
-	filePath = path;
-	order = ord;
-	mode = mod;
-	systemOrder = getSystemEndianess();
-}
+	public:
+		bool isOpen();
+		bool isWritable() { return mWritable; }
+		std::string getPath();
 
-CFileStream::CFileStream(std::string path, OpenMode mod){
-	base.open(path, (mod == OpenMode::In ? std::ios::in : std::ios::out) | std::ios::binary);
-	base.exceptions(std::ifstream::badbit);
-	filePath = path;
-	mode = mod;
-	systemOrder = getSystemEndianess();
-	order = getSystemEndianess();
-}
+		void writeInt8(int8_t);
+		void writeUInt8(uint8_t);
 
-std::fstream &CFileStream::getStream(){
-	return base;
-}
+		void writeInt16(int16_t);
+		void writeUInt16(uint16_t);
 
-std::string CFileStream::getPath(){
-	return filePath;
-}
+		void writeInt32(int32_t);
+		void writeInt64(int64_t);
+		void writeUInt32(uint32_t);
+		void writeUInt64(uint64_t);
 
-bool CFileStream::seek(std::size_t pos, bool fromCurrent){
-	try {
-		base.seekg(pos, (fromCurrent ? base.cur : base.beg));
-		return true;
-	} catch (const std::ifstream::failure& f) {
-		return false;
-	}
-}
+		void writeDouble(double);
+		void writeFloat(float);
+		void writeBytes(uint8_t*, std::size_t);
+		void writeString(std::string);
 
-void CFileStream::skip(std::size_t amount){
-	base.seekg(amount, base.cur);
-}
+		void alignTo(std::size_t);
 
-std::size_t CFileStream::tell(){
-	return base.tellg();
-}
+		void writeOffsetAt16(std::size_t);
+		void writeOffsetAt32(std::size_t);
+		void writeOffsetAt64(std::size_t);
 
-uint32_t CFileStream::readUInt32(){
-	assert(mode == OpenMode::In);
-	uint32_t r;
-	base.read((char*)&r, sizeof(uint32_t));
-	if(order != systemOrder){
-		return swap32(r);
-	}
-	else{
-		return r;
-	}
-}
+		// Writable mappings can switch between reading and writing at any time
+		bool changeMode(OpenMode mode);
+		void markDirty(std::size_t, std::size_t);
+		const std::map<std::size_t, std::size_t>& getDirtyRanges() { return mDirty; }
+
+		// msyncs the dirty pages and forgets them, returns false if any range failed to write back
+		bool flush();
+
+		// HugePages advises the kernel to back the mapping with transparent huge pages, which
+		// needs file THP support and silently stays on normal pages otherwise
+		CMappedFileStream(std::string, Endianess, PageBacking backing = PageBacking::NormalPages);
+		// Out maps the file writable, creating it if needed, and starts in write mode
+		CMappedFileStream(std::string, Endianess, OpenMode, PageBacking backing = PageBacking::NormalPages);
+		// Flushes, trims the file to the written size and unmaps
+		~CMappedFileStream();
+};
 
-int32_t CFileStream::readInt32(){
-	assert(mode == OpenMode::In);
-	int32_t r;
-	base.read((char*)&r, sizeof(int32_t));
-	if(order != systemOrder){
-		return swap32(r);
-	}
-	else{
-		return r;
-	}
-}
+#endif
+enum TraceOp : uint8_t {
+	TraceRead,
+	TraceWrite,
+	TracePeek,
+	TraceSeek
+};
 
-uint16_t CFileStream::readUInt16(){
-	assert(mode == OpenMode::In);
-	uint16_t r;
-	base.read((char*)&r, sizeof(uint16_t));
-	if(order != systemOrder){
-		return swap16(r);
-	}
-	else{
-		return r;
-	}
-}
+struct TraceEntry {
+	std::size_t offset;
+	std::size_t length;
+	TraceOp op;
+};
 
-int16_t CFileStream::readInt16(){
-	assert(mode == OpenMode::In);
-	int16_t r;
-	base.read((char*)&r, sizeof(int16_t));
-	if(order != systemOrder){
-		return swap16(r);
-	}
-	else{
-		return r;
-	}
-}
+struct TraceRange {
+	std::size_t offset;
+	std::size_t length;
+	std::size_t accesses;
+};
 
-uint8_t CFileStream::readUInt8(){
-	assert(mode == OpenMode::In);
-	uint8_t r;
-	base.read((char*)&r, sizeof(uint8_t));
-	return r;
-}
+struct TraceStats {
+	std::size_t reads = 0;
+	std::size_t writes = 0;
+	std::size_t peeks = 0;
+	std::size_t seeks = 0;
+	std::size_t bytesRead = 0;
+	std::size_t bytesReRead = 0;
+	double reReadRatio = 0.0;
+	// seekHistogram[i] counts jumps between accesses whose distance d satisfies 2^(i-1) <= d < 2^i, [0] is sequential
+	std::vector<std::size_t> seekHistogram;
+	std::vector<TraceRange> hotRanges;
+
+	void dump(std::ostream& out = std::cout);
+};
 
-int8_t CFileStream::readInt8(){
-	assert(mode == OpenMode::In);
-	int8_t r;
-	base.read((char*)&r, sizeof(int8_t));
-	return r;
-}
+struct OffsetPatch {
+	std::size_t at;
+	std::size_t value;
+	std::size_t width;
+};
 
-float CFileStream::readFloat(){
-	assert(mode == OpenMode::In);
-	char buff[sizeof(float)];
-	base.read(buff, sizeof(float));
-	if(order != systemOrder){
-		char temp[sizeof(float)];
-		temp[0] = buff[3];
-		temp[1] = buff[2];
-		temp[2] = buff[1];
-		temp[3] = buff[0];
-		return *((float*)temp);
-	}
-	return *((float*)buff);
-}
+// Measures a writer without storing anything. Run the serializer against a CCountingStream
+// first to learn the final size, alignment and offset targets, then Reserve exactly that much
+// on the real output. Reads and peeks only advance the position and yield zeros.
+class CCountingStream : public CStream {
+	private:
+		std::size_t mPosition;
+		std::size_t mSize;
+		std::size_t mMaxAlignment;
+		Endianess order;
+		std::vector<OffsetPatch> mPatches;
+		StreamError mError = StreamError::NoError;
 
-double CFileStream::readDouble(){
-	assert(mode == OpenMode::In);
-	char buff[sizeof(double)];
-	base.read(buff, sizeof(double));
-	if(order != systemOrder){
-		char temp[sizeof(double)];
-		temp[0] = buff[7];
-		temp[1] = buff[6];
-		temp[2] = buff[5];
-		temp[3] = buff[4];
+		void advance(std::size_t amount){
+			mPosition += amount;
+			if(mPosition > mSize) mSize = mPosition;
+		}
+
+	public:
+		bool seek(std::size_t, bool = false);
+		void skip(std::size_t);
+		std::size_t tell();
+
+		std::size_t getSize();
+		// Largest alignment requested through alignTo
+		std::size_t getMaxAlignment();
+		// Every writeOffsetAt16/32 call in order, with the offset that would have been written
+		const std::vector<OffsetPatch>& getPatches();
+		void reset();
+
+		// Set to OffsetOverflow when a 32 bit offset would not fit, that patch is not recorded
+		StreamError getError() { return mError; }
+		bool good() { return mError == StreamError::NoError; }
+		void clearError() { mError = StreamError::NoError; }
+
+		uint8_t readUInt8();
+		uint16_t readUInt16();
+		uint32_t readUInt32();
+		uint64_t readUInt64();
+
+		int8_t readInt8();
+		int16_t readInt16();
+		int32_t readInt32();
+		int64_t readInt64();
+
+		float readFloat();
+		void writeFloat(float);
+
+		double readDouble();
+		void writeDouble(double);
+
+		int8_t peekInt8(std::size_t);
+		uint8_t peekUInt8(std::size_t);
+
+		int16_t peekInt16(std::size_t);
+		uint16_t peekUInt16(std::size_t);
+
+		int32_t peekInt32(std::size_t);
+		int64_t peekInt64(std::size_t);
+		uint32_t peekUInt32(std::size_t);
+		uint64_t peekUInt64(std::size_t);
+
+		void writeInt8(int8_t);
+		void writeUInt8(uint8_t);
+
+		void writeInt32(int32_t);
+		void writeInt64(int64_t);
+		void writeUInt32(uint32_t);
+		void writeUInt64(uint64_t);
+
+		void writeInt16(int16_t);
+		void writeUInt16(uint16_t);
+
+		void readBytesTo(uint8_t*, std::size_t);
+		void writeBytes(uint8_t*, std::size_t);
+
+		void alignTo(std::size_t);
+
+		void writeOffsetAt16(std::size_t);
+		void writeOffsetAt32(std::size_t);
+		void writeOffsetAt64(std::size_t);
+
+		void writeString(std::string);
+		std::string peekString(std::size_t, std::size_t);
+		std::string readString(std::size_t);
+
+		Endianess getOrder();
+		void setOrder(Endianess);
+
+		CCountingStream(Endianess ord = Endianess::Big) : mPosition(0), mSize(0), mMaxAlignment(1), order(ord) {}
+};
+
+// Access log recorded by CTraceStream. Entries are stored as varint deltas when saved so long
+// sequential runs only cost a few bytes each.
+class CTraceLog {
+	private:
+		std::vector<TraceEntry> mEntries;
+
+	public:
+		void record(TraceOp, std::size_t, std::size_t);
+		void clear();
+		const std::vector<TraceEntry>& getEntries();
+
+		void save(CStream&);
+		bool load(CStream&);
+
+		// Hot ranges are reported at blockSize granularity, the topRanges most accessed blocks are kept
+		TraceStats analyze(std::size_t blockSize = 4096, std::size_t topRanges = 16);
+
+		// Re-issues every read and peek against stream, returns the time taken in nanoseconds.
+		// Buffering can be changed beforehand, e.g. through CFileStream::getStream().rdbuf()->pubsetbuf
+		uint64_t replay(CStream&);
+};
+
+// Forwards every call to another stream while recording each access in a CTraceLog
+class CTraceStream : public CStream {
+	private:
+		CStream& mTarget;
+		CTraceLog mLog;
+
+	public:
+		CTraceLog& getLog();
+
+		bool seek(std::size_t, bool = false);
+		void skip(std::size_t);
+		std::size_t tell();
+
+		std::size_t getSize();
+
+		uint8_t readUInt8();
+		uint16_t readUInt16();
+		uint32_t readUInt32();
+		uint64_t readUInt64();
+
+		int8_t readInt8();
+		int16_t readInt16();
+		int32_t readInt32();
+		int64_t readInt64();
+
+		float readFloat();
+		void writeFloat(float);
+
+		double readDouble();
+		void writeDouble(double);
+
+		int8_t peekInt8(std::size_t);
+		uint8_t peekUInt8(std::size_t);
+
+		int16_t peekInt16(std::size_t);
+		uint16_t peekUInt16(std::size_t);
+
+		int32_t peekInt32(std::size_t);
+		int64_t peekInt64(std::size_t);
+		uint32_t peekUInt32(std::size_t);
+		uint64_t peekUInt64(std::size_t);
+
+		void writeInt8(int8_t);
+		void writeUInt8(uint8_t);
+
+		void writeInt32(int32_t);
+		void writeInt64(int64_t);
+		void writeUInt32(uint32_t);
+		void writeUInt64(uint64_t);
+
+		void writeInt16(int16_t);
+		void writeUInt16(uint16_t);
+
+		void readBytesTo(uint8_t*, std::size_t);
+		void writeBytes(uint8_t*, std::size_t);
+
+		void alignTo(std::size_t);
+
+		void writeOffsetAt16(std::size_t);
+		void writeOffsetAt32(std::size_t);
+		void writeOffsetAt64(std::size_t);
+
+		void writeString(std::string);
+		std::string peekString(std::size_t, std::size_t);
+		std::string readString(std::size_t);
+
+		Endianess getOrder();
+		void setOrder(Endianess);
+
+		CTraceStream(CStream& target) : mTarget(target) {}
+};
+
+// Define BSTREAM_ASYNC (C++20) for coroutine based reads. A CAsyncContext runs coroutines on the
+// thread that calls run() while a small pool of workers performs the blocking preads, so
+// thousands of loads can be in flight without a thread each.
+#if defined(BSTREAM_ASYNC) && defined(__cpp_impl_coroutine) && defined(__unix__)
+
+class CAsyncContext;
+
+template<typename T>
+class CTask;
+
+template<typename T>
+struct CTaskPromiseBase {
+	std::coroutine_handle<> continuation;
+	std::exception_ptr error;
+
+	std::suspend_always initial_suspend() noexcept { return {}; }
+
+	struct FinalAwaiter {
+		bool await_ready() noexcept { return false; }
+		template<typename P>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+			std::coroutine_handle<> next = h.promise().continuation;
+			return next ? next : std::noop_coroutine();
+		}
+		void await_resume() noexcept {}
+	};
+
+	FinalAwaiter final_suspend() noexcept { return {}; }
+	void unhandled_exception() { error = std::current_exception(); }
+};
+
+template<typename T>
+struct CTaskPromise : CTaskPromiseBase<T> {
+	T value;
+
+	CTask<T> get_return_object();
+	void return_value(T v) { value = std::move(v); }
+	T result() {
+		if(this->error) std::rethrow_exception(this->error);
+		return std::move(value);
+	}
+};
+
+template<>
+struct CTaskPromise<void> : CTaskPromiseBase<void> {
+	CTask<void> get_return_object();
+	void return_void() {}
+	void result() {
+		if(this->error) std::rethrow_exception(this->error);
+	}
+};
+
+// Lazily started coroutine, runs when awaited or when handed to CAsyncContext::spawn
+template<typename T = void>
+class CTask {
+	public:
+		using promise_type = CTaskPromise<T>;
+		using handle_type = std::coroutine_handle<promise_type>;
+
+	private:
+		handle_type mHandle;
+
+	public:
+		bool await_ready() { return !mHandle || mHandle.done(); }
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) {
+			mHandle.promise().continuation = awaiting;
+			return mHandle;
+		}
+		T await_resume() { return mHandle.promise().result(); }
+
+		handle_type getHandle() { return mHandle; }
+		bool done() { return !mHandle || mHandle.done(); }
+
+		CTask(handle_type h) : mHandle(h) {}
+		CTask(CTask&& o) : mHandle(o.mHandle) { o.mHandle = nullptr; }
+		CTask(const CTask&) = delete;
+		CTask& operator=(const CTask&) = delete;
+		~CTask() { if(mHandle) mHandle.destroy(); }
+};
+
+template<typename T>
+CTask<T> CTaskPromise<T>::get_return_object() { return CTask<T>(std::coroutine_handle<CTaskPromise<T>>::from_promise(*this)); }
+
+inline CTask<void> CTaskPromise<void>::get_return_object() { return CTask<void>(std::coroutine_handle<CTaskPromise<void>>::from_promise(*this)); }
+
+class CAsyncContext {
+	private:
+		std::mutex mLock;
+		std::condition_variable mReadyCondition;
+		std::condition_variable mWorkCondition;
+		std::deque<std::coroutine_handle<>> mReady;
+		std::deque<std::function<void()>> mWork;
+		std::vector<CTask<void>> mTasks;
+		std::vector<std::thread> mWorkers;
+		std::size_t mPending;
+		bool mStopping;
+		std::exception_ptr mError;
+
+		void workerLoop();
+
+	public:
+		// Queues a coroutine to start on the next run()
+		void spawn(CTask<void>);
+
+		// Runs work on a worker thread, then resumes h on the run() thread
+		void submit(std::function<void()>, std::coroutine_handle<>);
+
+		// Resumes coroutines until every spawned task has finished and no I/O is in flight, then
+		// rethrows the first exception that escaped a spawned task or a piece of submitted work
+		void run();
+
+		CAsyncContext(std::size_t workers = 4);
+		~CAsyncContext();
+};
+
+class CAsyncFileStream;
+
+struct CAsyncReadOp {
+	CAsyncFileStream* stream;
+	std::size_t offset;
+	std::vector<uint8_t> buffer;
+	int error = 0;
+
+	bool await_ready() { return buffer.empty(); }
+	void await_suspend(std::coroutine_handle<>);
+	void throwIfFailed() { if(error != 0) throw std::system_error(error, std::generic_category(), "bStream: async read failed"); }
+};
+
+// Resumes with the bytes read, which is fewer than asked for at the end of the file.
+// A failed read throws std::system_error.
+struct CAsyncBytesRead : CAsyncReadOp {
+	std::vector<uint8_t> await_resume() {
+		throwIfFailed();
+		return std::move(buffer);
+	}
+};
+
+// Resumes with the value, throws std::out_of_range if the file ends first or std::system_error
+// if the read failed
+template<typename T>
+struct CAsyncValueRead : CAsyncReadOp {
+	bool swap;
+
+	T await_resume() {
+		throwIfFailed();
+		if(buffer.size() != sizeof(T)) throw std::out_of_range("bStream: async read past end of file");
+		T r;
+		if(swap) std::reverse(buffer.begin(), buffer.end());
+		memcpy(&r, buffer.data(), sizeof(T));
+		return r;
+	}
+};
+
+// Read only file stream for use inside CTask coroutines. Reads are issued as preads at the
+// current position, which advances when the read is started.
+class CAsyncFileStream {
+	private:
+		CAsyncContext& mContext;
+		std::string filePath;
+		int mFd;
+		std::size_t mPosition;
+		Endianess order;
+		Endianess systemOrder;
+
+		template<typename T>
+		CAsyncValueRead<T> readValueAsync(){
+			CAsyncValueRead<T> op;
+			op.stream = this;
+			op.offset = mPosition;
+			op.buffer.resize(sizeof(T));
+			op.swap = (sizeof(T) > 1 && order != systemOrder);
+			mPosition += sizeof(T);
+			return op;
+		}
+
+		friend struct CAsyncReadOp;
+
+	public:
+		bool isOpen();
+		std::size_t getSize();
+		std::size_t tell();
+		bool seek(std::size_t, bool = false);
+		void skip(std::size_t);
+		std::string getPath();
+
+		Endianess getOrder();
+		void setOrder(Endianess);
+
+		CAsyncBytesRead readAsync(std::size_t);
+		CAsyncBytesRead readAtAsync(std::size_t, std::size_t);
+
+		CAsyncValueRead<int8_t> readInt8Async() { return readValueAsync<int8_t>(); }
+		CAsyncValueRead<uint8_t> readUInt8Async() { return readValueAsync<uint8_t>(); }
+		CAsyncValueRead<int16_t> readInt16Async() { return readValueAsync<int16_t>(); }
+		CAsyncValueRead<uint16_t> readUInt16Async() { return readValueAsync<uint16_t>(); }
+		CAsyncValueRead<int32_t> readInt32Async() { return readValueAsync<int32_t>(); }
+		CAsyncValueRead<uint32_t> readUInt32Async() { return readValueAsync<uint32_t>(); }
+		CAsyncValueRead<int64_t> readInt64Async() { return readValueAsync<int64_t>(); }
+		CAsyncValueRead<uint64_t> readUInt64Async() { return readValueAsync<uint64_t>(); }
+		CAsyncValueRead<float> readFloatAsync() { return readValueAsync<float>(); }
+		CAsyncValueRead<double> readDoubleAsync() { return readValueAsync<double>(); }
+
+		CAsyncFileStream(CAsyncContext&, std::string, Endianess);
+		CAsyncFileStream(CAsyncContext&, std::string);
+		~CAsyncFileStream();
+};
+
+#endif
+
+// Declarative record layouts (C++17). A schema lists the fields of a struct in file order and
+// generates the endian aware reader and writer for it, e.g.
+//
+//   using HeaderSchema = bStream::Schema<Header,
+//       bStream::Field<&Header::magic>, bStream::Padding<4>, bStream::Array<&Header::scale>,
+//       bStream::OffsetTo<&Header::child, ChildSchema>, bStream::Align<16>>;
+//
+// The fixed part of every record is read or written with a single readBytesTo/writeBytes call
+// and its size is known at compile time through Schema::size and Schema::totalSize.
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+
+template<typename T>
+inline T byteSwap(T v){
+	static_assert(std::is_trivially_copyable<T>::value, "byteSwap needs a trivially copyable type");
+	if constexpr (sizeof(T) == 1){
+		return v;
+	} else {
+		using U = std::conditional_t<sizeof(T) == 2, uint16_t, std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>;
+		static_assert(sizeof(T) == sizeof(U), "byteSwap supports 1, 2, 4 and 8 byte types");
+		U u;
+		memcpy(&u, &v, sizeof(U));
+#if defined(__GNUC__) || defined(__clang__)
+		if constexpr (sizeof(U) == 2) u = __builtin_bswap16(u);
+		else if constexpr (sizeof(U) == 4) u = __builtin_bswap32(u);
+		else u = __builtin_bswap64(u);
+#else
+		U r = 0;
+		for(std::size_t i = 0; i < sizeof(U); i++) r |= ((u >> (i * 8)) & 0xFF) << ((sizeof(U) - 1 - i) * 8);
+		u = r;
+#endif
+		memcpy(&v, &u, sizeof(U));
+		return v;
+	}
+}
+
+template<typename T, bool Swap>
+inline T loadValue(const uint8_t* p){
+	T v;
+	memcpy(&v, p, sizeof(T));
+	if constexpr (Swap) v = byteSwap(v);
+	return v;
+}
+
+template<typename T, bool Swap>
+inline void storeValue(uint8_t* p, T v){
+	if constexpr (Swap) v = byteSwap(v);
+	memcpy(p, &v, sizeof(T));
+}
+
+template<typename M>
+struct MemberTraits;
+
+template<typename C, typename T>
+struct MemberTraits<T C::*> {
+	using Class = C;
+	using Type = T;
+};
+
+// Elements without children use these no-op hooks
+struct SchemaElement {
+	static constexpr std::size_t childSize = 0;
+
+	template<bool Swap, typename S>
+	static void decode(const uint8_t*, S&) {}
+	template<bool Swap, typename S>
+	static void encode(uint8_t*, const S&) {}
+	template<bool Swap, typename Stream, typename S>
+	static bool readChildren(Stream&, S&, const uint8_t*) { return true; }
+	template<typename S>
+	static void writeChildren(CStream&, const S&, std::size_t) {}
+};
+
+// A single arithmetic or enum member
+template<auto Member>
+struct Field : SchemaElement {
+	using Type = typename MemberTraits<decltype(Member)>::Type;
+	static_assert(std::is_arithmetic<Type>::value || std::is_enum<Type>::value, "Field members must be arithmetic or enum types");
+
+	static constexpr std::size_t sizeAt(std::size_t) { return sizeof(Type); }
+
+	template<bool Swap, typename S>
+	static void decode(const uint8_t* p, S& obj) { obj.*Member = loadValue<Type, Swap>(p); }
+	template<bool Swap, typename S>
+	static void encode(uint8_t* p, const S& obj) { storeValue<Type, Swap>(p, obj.*Member); }
+};
+
+// A fixed size C array member, each element is swapped individually
+template<auto Member>
+struct Array : SchemaElement {
+	using Type = typename MemberTraits<decltype(Member)>::Type;
+	using Element = std::remove_extent_t<Type>;
+	static constexpr std::size_t count = std::extent<Type>::value;
+	static_assert(std::rank<Type>::value == 1, "Array members must be one dimensional C arrays");
+	static_assert(std::is_arithmetic<Element>::value || std::is_enum<Element>::value, "Array elements must be arithmetic or enum types");
+
+	static constexpr std::size_t sizeAt(std::size_t) { return sizeof(Element) * count; }
+
+	template<bool Swap, typename S>
+	static void decode(const uint8_t* p, S& obj) {
+		for(std::size_t i = 0; i < count; i++) (obj.*Member)[i] = loadValue<Element, Swap>(p + i * sizeof(Element));
+	}
+	template<bool Swap, typename S>
+	static void encode(uint8_t* p, const S& obj) {
+		for(std::size_t i = 0; i < count; i++) storeValue<Element, Swap>(p + i * sizeof(Element), (obj.*Member)[i]);
+	}
+};
+
+// Bytes skipped on read and zero filled on write
+template<std::size_t N>
+struct Padding : SchemaElement {
+	static constexpr std::size_t sizeAt(std::size_t) { return N; }
+};
+
+// Pads up to the next multiple of N, relative to the start of the record
+template<std::size_t N>
+struct Align : SchemaElement {
+	static_assert(N > 0, "Align needs a non zero alignment");
+	static constexpr std::size_t sizeAt(std::size_t offset) { return (N - offset % N) % N; }
+};
+
+// An absolute stream offset to a child record described by ChildSchema, 32 bits wide unless
+// OffsetT is uint64_t. Children are written directly after their parent record, in declaration order.
+// An offset of 0 means there is no child and leaves the member untouched.
+template<auto Member, typename ChildSchema, typename OffsetT = uint32_t>
+struct OffsetTo : SchemaElement {
+	static_assert(std::is_same<OffsetT, uint32_t>::value || std::is_same<OffsetT, uint64_t>::value, "OffsetTo needs a uint32_t or uint64_t offset");
+	static constexpr std::size_t childSize = ChildSchema::totalSize;
+
+	static constexpr std::size_t sizeAt(std::size_t) { return sizeof(OffsetT); }
+
+	template<bool Swap, typename Stream, typename S>
+	static bool readChildren(Stream& stream, S& obj, const uint8_t* p) {
+		OffsetT offset = loadValue<OffsetT, Swap>(p);
+		if(offset == 0) return true;
+		return stream.seek(offset) && ChildSchema::read(stream, obj.*Member);
+	}
+	template<typename S>
+	static void writeChildren(CStream& stream, const S& obj, std::size_t at) {
+		if constexpr (sizeof(OffsetT) == sizeof(uint64_t)){
+			stream.writeOffsetAt64(at);
+		} else {
+			stream.writeOffsetAt32(at);
+		}
+		ChildSchema::write(stream, obj.*Member);
+	}
+};
+
+template<typename S, typename... Elements>
+class Schema {
+	private:
+		using ElementList = std::tuple<Elements...>;
+
+		static constexpr std::array<std::size_t, sizeof...(Elements) + 1> computeLayout(){
+			std::array<std::size_t, sizeof...(Elements) + 1> offsets {};
+			std::size_t at = 0;
+			std::size_t i = 0;
+			((offsets[i++] = at, at += Elements::sizeAt(at)), ...);
+			offsets[i] = at;
+			return offsets;
+		}
+
+		static constexpr std::array<std::size_t, sizeof...(Elements) + 1> layout = computeLayout();
+
+		template<bool Swap, typename Stream, std::size_t... I>
+		static bool decodeAll(Stream& stream, const uint8_t* p, S& obj, std::index_sequence<I...>){
+			(std::tuple_element_t<I, ElementList>::template decode<Swap>(p + layout[I], obj), ...);
+			return (true && ... && std::tuple_element_t<I, ElementList>::template readChildren<Swap>(stream, obj, p + layout[I]));
+		}
+
+		template<bool Swap, std::size_t... I>
+		static void encodeAll(uint8_t* p, const S& obj, std::index_sequence<I...>){
+			(std::tuple_element_t<I, ElementList>::template encode<Swap>(p + layout[I], obj), ...);
+		}
+
+		template<std::size_t... I>
+		static void writeAllChildren(CStream& stream, const S& obj, std::size_t start, std::index_sequence<I...>){
+			(std::tuple_element_t<I, ElementList>::writeChildren(stream, obj, start + layout[I]), ...);
+		}
+
+	public:
+		// Bytes in the record itself
+		static constexpr std::size_t size = layout[sizeof...(Elements)];
+		// Bytes in the record plus every child record it points to
+		static constexpr std::size_t totalSize = size + (std::size_t(0) + ... + Elements::childSize);
+
+		// Returns false if the record or one of its children is cut short. Streams known to be memory
+		// streams at compile time are bounds checked up front and consume nothing on failure, others
+		// are checked by comparing positions after the read.
+		template<typename Stream>
+		static bool read(Stream& stream, S& obj){
+			static_assert(std::is_base_of<CStream, Stream>::value, "Schema::read needs a bStream stream");
+			constexpr bool memory = std::is_base_of<CMemoryStream, Stream>::value;
+
+			std::size_t start = 0;
+			if constexpr (memory){
+				if(!stream.ensure(size)) return false;
+			} else {
+				start = stream.tell();
+			}
+
+			uint8_t buffer[size > 0 ? size : 1];
+			stream.readBytesTo(buffer, size);
+			std::size_t end = stream.tell();
+			if(!memory && end != start + size) return false;
+
+			bool ok;
+			if(stream.getOrder() != getSystemEndianess()){
+				ok = decodeAll<true>(stream, buffer, obj, std::index_sequence_for<Elements...>{});
+			} else {
+				ok = decodeAll<false>(stream, buffer, obj, std::index_sequence_for<Elements...>{});
+			}
+
+			if(totalSize != size) stream.seek(end);
+			return ok;
+		}
+
+		static void write(CStream& stream, const S& obj){
+			uint8_t buffer[size > 0 ? size : 1] = {};
+			if(stream.getOrder() != getSystemEndianess()){
+				encodeAll<true>(buffer, obj, std::index_sequence_for<Elements...>{});
+			} else {
+				encodeAll<false>(buffer, obj, std::index_sequence_for<Elements...>{});
+			}
+
+			std::size_t start = stream.tell();
+			stream.writeBytes(buffer, size);
+			writeAllChildren(stream, obj, start, std::index_sequence_for<Elements...>{});
+		}
+};
+
+#endif
+
+// One file for CFileLoader, its stream is created with the given byte order
+struct LoadRequest {
+	std::string path;
+	Endianess order;
+};
+
+// Reads many whole files concurrently into CMemoryStreams. Every file is sized up front and read
+// straight into its stream's buffer by one of a set of worker threads, keeping several reads in
+// flight so fast drives are not left waiting on one file at a time. The workers are started by
+// the first load and kept for later ones.
+class CFileLoader {
+	public:
+		// Runs on the worker that read the file as soon as it is done, stream is null if the file
+		// could not be read. Callbacks for different files may run at the same time.
+		using Callback = std::function<void(std::size_t, CMemoryStream*)>;
+
+	private:
+		std::size_t mThreads;
+		CBufferPool* mPool;
+
+		// Serializes load calls, the workers run one batch at a time
+		std::mutex mLoadLock;
+		std::mutex mLock;
+		std::condition_variable mWake;
+		std::condition_variable mIdle;
+		std::vector<std::thread> mWorkers;
+		std::function<void()> mBatch;
+		uint64_t mBatchId = 0;
+		// Workers still inside the current batch
+		std::size_t mBusy = 0;
+		bool mStopping = false;
+
+		CMemoryStream* readFile(const LoadRequest&);
+		void workerLoop();
+
+	public:
+		// Streams are returned in request order, null where a file failed. The first exception
+		// thrown by a callback is rethrown once every file has been handled.
+		std::vector<std::unique_ptr<CMemoryStream>> load(const std::vector<LoadRequest>&, Callback callback = nullptr);
+		std::vector<std::unique_ptr<CMemoryStream>> load(const std::vector<std::string>&, Endianess, Callback callback = nullptr);
+
+		// threads defaults to the hardware thread count but no fewer than 4. Buffers come from pool
+		// when one is given. Either way they are not zero filled.
+		CFileLoader(std::size_t threads = 0, CBufferPool* pool = nullptr);
+		~CFileLoader();
+};
+
+}
+
+#if defined(BSTREAM_IMPLEMENTATION)
+
+namespace bStream {
+
+uint64_t swap64(uint64_t r){
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_bswap64(r);
+#else
+	return ((uint64_t)swap32(r & 0xFFFFFFFF) << 32) | swap32(r >> 32);
+#endif
+}
+
+uint32_t swap32(uint32_t r){
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_bswap32(r);
+#else
+	return ( ((r>>24)&0xFF) | ((r<<8) & 0xFF0000) | ((r>>8)&0xFF00) | ((r<<24)&0xFF000000));
+#endif
+}
+
+uint16_t swap16(uint16_t r){
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_bswap16(r);
+#else
+	return ( ((r<<8)&0xFF00) | ((r>>8)&0x00FF) );
+#endif
+}
+
+Endianess getSystemEndianess(){
+	union {
+		uint32_t integer;
+		uint8_t bytes[sizeof(uint32_t)];
+	} check;
+	check.integer = 0x01020304U;
+	return (check.bytes[0] == 0x01 ? Endianess::Big : Endianess::Little);
+}
+
+#if defined(BSTREAM_INSTRUMENTATION)
+
+void StreamStats::reset(){
+	*this = StreamStats();
+}
+
+StreamStats& StreamStats::operator+=(const StreamStats& o){
+	bytesRead += o.bytesRead;
+	bytesWritten += o.bytesWritten;
+	reads += o.reads;
+	writes += o.writes;
+	seeks += o.seeks;
+	peeks += o.peeks;
+	reallocations += o.reallocations;
+	bytesCopiedByGrowth += o.bytesCopiedByGrowth;
+	ioNanoseconds += o.ioNanoseconds;
+	return *this;
+}
+
+CStreamStats::CStreamStats(const char* n) : name(n) {
+	CStatsRegistry::instance().add(this);
+}
+
+CStreamStats::CStreamStats(const CStreamStats& o) : StreamStats(o), name(o.name) {
+	CStatsRegistry::instance().add(this);
+}
+
+CStreamStats& CStreamStats::operator=(const CStreamStats& o){
+	StreamStats::operator=(o);
+	name = o.name;
+	return *this;
+}
+
+CStreamStats::~CStreamStats(){
+	CStatsRegistry::instance().remove(this);
+}
+
+CStatsRegistry& CStatsRegistry::instance(){
+	static CStatsRegistry registry;
+	return registry;
+}
+
+void CStatsRegistry::add(CStreamStats* s){
+	std::lock_guard<std::mutex> lock(mLock);
+	mLive.push_back(s);
+}
+
+void CStatsRegistry::remove(CStreamStats* s){
+	std::lock_guard<std::mutex> lock(mLock);
+	for(std::size_t i = 0; i < mLive.size(); i++){
+		if(mLive[i] == s){
+			mRetired += *s;
+			mLive[i] = mLive.back();
+			mLive.pop_back();
+			return;
+		}
+	}
+}
+
+StreamStats CStatsRegistry::total(){
+	std::lock_guard<std::mutex> lock(mLock);
+	StreamStats sum = mRetired;
+	for(CStreamStats* s : mLive) sum += *s;
+	return sum;
+}
+
+static void dumpStreamStats(std::ostream& out, const std::string& name, const StreamStats& s){
+	out << name << ": "
+		<< s.reads << " reads (" << s.bytesRead << " bytes), "
+		<< s.writes << " writes (" << s.bytesWritten << " bytes), "
+		<< s.seeks << " seeks, "
+		<< s.peeks << " peeks, "
+		<< s.reallocations << " reallocations (" << s.bytesCopiedByGrowth << " bytes copied), "
+		<< (s.ioNanoseconds / 1000) << "us in io" << std::endl;
+}
+
+void CStatsRegistry::dump(std::ostream& out){
+	std::lock_guard<std::mutex> lock(mLock);
+	StreamStats sum = mRetired;
+	for(CStreamStats* s : mLive){
+		dumpStreamStats(out, s->name, *s);
+		sum += *s;
+	}
+	dumpStreamStats(out, "total", sum);
+}
+
+#endif
+
+///
+///
+///  CChecksum
+///
+///
+
+// Slicing-by-8 tables for the reflected polynomial, built once on first use
+struct CrcTables {
+	uint32_t t[8][256];
+
+	CrcTables(uint32_t poly){
+		for(uint32_t i = 0; i < 256; i++){
+			uint32_t c = i;
+			for(int k = 0; k < 8; k++) c = (c & 1 ? (c >> 1) ^ poly : c >> 1);
+			t[0][i] = c;
+		}
+		for(uint32_t i = 0; i < 256; i++){
+			for(int s = 1; s < 8; s++) t[s][i] = (t[s-1][i] >> 8) ^ t[0][t[s-1][i] & 0xFF];
+		}
+	}
+};
+
+static uint32_t crcSoftware(const CrcTables& tables, uint32_t crc, const uint8_t* p, std::size_t len){
+	const uint32_t (*t)[256] = tables.t;
+	while(len >= 8){
+		uint32_t lo, hi;
+		memcpy(&lo, p, sizeof(uint32_t));
+		memcpy(&hi, p + 4, sizeof(uint32_t));
+		if(getSystemEndianess() == Endianess::Big){
+			lo = swap32(lo);
+			hi = swap32(hi);
+		}
+		lo ^= crc;
+		crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+		      t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+		p += 8;
+		len -= 8;
+	}
+	while(len--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+	return crc;
+}
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* p, std::size_t len){
+#if defined(__ARM_FEATURE_CRC32)
+	for(; len >= 8; p += 8, len -= 8){
+		uint64_t v;
+		memcpy(&v, p, sizeof(uint64_t));
+		crc = __crc32d(crc, v);
+	}
+	while(len--) crc = __crc32b(crc, *p++);
+	return crc;
+#else
+	static const CrcTables tables(0xEDB88320);
+	return crcSoftware(tables, crc, p, len);
+#endif
+}
+
+#if defined(__x86_64__) && (defined(__SSE4_2__) || defined(__GNUC__))
+#define BSTREAM_CRC32C_SSE42
+// Built for SSE4.2 regardless of the compiler flags, only called once the cpu is known to have it
+__attribute__((target("sse4.2")))
+static uint32_t crc32cHardware(uint32_t crc, const uint8_t* p, std::size_t len){
+	uint64_t c = crc;
+	for(; len >= 8; p += 8, len -= 8){
+		uint64_t v;
+		memcpy(&v, p, sizeof(uint64_t));
+		c = _mm_crc32_u64(c, v);
+	}
+	crc = (uint32_t)c;
+	while(len--) crc = _mm_crc32_u8(crc, *p++);
+	return crc;
+}
+#endif
+
+static uint32_t crc32cUpdate(uint32_t crc, const uint8_t* p, std::size_t len){
+#if defined(__SSE4_2__) && defined(__x86_64__)
+	return crc32cHardware(crc, p, len);
+#elif defined(__ARM_FEATURE_CRC32)
+	for(; len >= 8; p += 8, len -= 8){
+		uint64_t v;
+		memcpy(&v, p, sizeof(uint64_t));
+		crc = __crc32cd(crc, v);
+	}
+	while(len--) crc = __crc32cb(crc, *p++);
+	return crc;
+#else
+#if defined(BSTREAM_CRC32C_SSE42)
+	static const bool hardware = __builtin_cpu_supports("sse4.2");
+	if(hardware) return crc32cHardware(crc, p, len);
+#endif
+	static const CrcTables tables(0x82F63B78);
+	return crcSoftware(tables, crc, p, len);
+#endif
+}
+
+void CChecksum::update(const void* data, std::size_t len){
+	const uint8_t* p = (const uint8_t*)data;
+	if(mType == ChecksumType::Crc32c){
+		mCrc = crc32cUpdate(mCrc, p, len);
+	} else {
+		mCrc = crc32Update(mCrc, p, len);
+	}
+}
+
+void CChecksum::reset(){
+	mCrc = 0xFFFFFFFF;
+}
+
+uint32_t CChecksum::value(){
+	return ~mCrc;
+}
+
+ChecksumType CChecksum::getType(){
+	return mType;
+}
+
+#if defined(__unix__)
+
+static const std::size_t HugePageSize = 0x200000;
+
+// Explicit huge pages first, then a huge page aligned anonymous mapping advised for THP. Buffers
+// smaller than a huge page return nullptr and stay on the heap, rounding them up would waste most
+// of the page and use up the reserved pool.
+static uint8_t* allocateHugePages(std::size_t& capacity){
+	if(capacity < HugePageSize) return nullptr;
+	std::size_t size = (capacity + HugePageSize - 1) & ~(HugePageSize - 1);
+
+#if defined(MAP_HUGETLB)
+	void* explicitPages = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if(explicitPages != MAP_FAILED){
+		capacity = size;
+		return (uint8_t*)explicitPages;
+	}
+#endif
+
+	uint8_t* raw = (uint8_t*)mmap(nullptr, size + HugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(raw == (uint8_t*)MAP_FAILED) return nullptr;
+
+	uintptr_t aligned = ((uintptr_t)raw + HugePageSize - 1) & ~(uintptr_t)(HugePageSize - 1);
+	std::size_t head = aligned - (uintptr_t)raw;
+	if(head > 0) munmap(raw, head);
+	if(HugePageSize - head > 0) munmap((uint8_t*)aligned + size, HugePageSize - head);
+
+#if defined(MADV_HUGEPAGE)
+	madvise((void*)aligned, size, MADV_HUGEPAGE);
+#endif
+	capacity = size;
+	return (uint8_t*)aligned;
+}
+
+#endif
+
+#if defined(__unix__)
+
+///
+///
+///  CWriteBehind
+///
+///
+
+// Two buffers, the producer fills one while the flusher thread pwrites the other
+class CWriteBehind {
+	private:
+		int mFd;
+		std::size_t mBufferSize;
+		std::vector<uint8_t> mBuffers[2];
+		std::size_t mActive;
+		std::size_t mActiveBase;
+		std::size_t mHighWater;
+		bool mPreallocated;
+
+		std::thread mFlusher;
+		std::mutex mLock;
+		std::condition_variable mCondition;
+		bool mInFlight;
+		std::size_t mInFlightBase;
+		bool mStopping;
+		bool mFailed;
+
+		void flusherLoop(){
+			std::unique_lock<std::mutex> lock(mLock);
+			while(true){
+				mCondition.wait(lock, [this]{ return mInFlight || mStopping; });
+				if(!mInFlight) return;
+
+				std::vector<uint8_t>& buffer = mBuffers[mActive ^ 1];
+				std::size_t base = mInFlightBase;
+				lock.unlock();
+				bool ok = writeAll(buffer.data(), buffer.size(), base);
+				lock.lock();
+
+				buffer.clear();
+				mFailed = mFailed || !ok;
+				mInFlight = false;
+				mCondition.notify_all();
+			}
+		}
+
+		bool writeAll(const uint8_t* data, std::size_t size, std::size_t at){
+			while(size > 0){
+				ssize_t n = pwrite(mFd, data, size, at);
+				if(n <= 0) return false;
+				data += n;
+				size -= n;
+				at += n;
+			}
+			return true;
+		}
+
+		void waitIdle(std::unique_lock<std::mutex>& lock){
+			mCondition.wait(lock, [this]{ return !mInFlight; });
+		}
+
+		// Hands the active buffer to the flusher and continues in the other one at base
+		void handOff(std::size_t base){
+			std::unique_lock<std::mutex> lock(mLock);
+			waitIdle(lock);
+			if(!mBuffers[mActive].empty()){
+				mInFlightBase = mActiveBase;
+				mInFlight = true;
+				mActive ^= 1;
+				mCondition.notify_all();
+			}
+			mActiveBase = base;
+		}
+
+	public:
+		bool open(const std::string& path, std::size_t position, std::size_t bufferSize, std::size_t expectedSize){
+			mFd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+			if(mFd < 0) return false;
+
+			mBufferSize = (bufferSize ? bufferSize : 1);
+			mBuffers[0].reserve(mBufferSize);
+			mBuffers[1].reserve(mBufferSize);
+			mActive = 0;
+			mActiveBase = position;
+			mHighWater = position;
+			mPreallocated = (expectedSize > 0 && posix_fallocate(mFd, 0, expectedSize) == 0);
+			mInFlight = false;
+			mStopping = false;
+			mFailed = false;
+			mFlusher = std::thread(&CWriteBehind::flusherLoop, this);
+			return true;
+		}
+
+		std::size_t tell(){
+			return mActiveBase + mBuffers[mActive].size();
+		}
+
+		std::size_t getSize(){
+			return std::max(mHighWater, tell());
+		}
+
+		void seek(std::size_t pos){
+			mHighWater = getSize();
+			handOff(pos);
+		}
+
+		void write(const void* data, std::size_t size){
+			const uint8_t* p = (const uint8_t*)data;
+			while(size > 0){
+				std::vector<uint8_t>& buffer = mBuffers[mActive];
+				std::size_t space = mBufferSize - buffer.size();
+				if(space == 0){
+					seek(tell());
+					continue;
+				}
+				std::size_t chunk = (size < space ? size : space);
+				buffer.insert(buffer.end(), p, p + chunk);
+				p += chunk;
+				size -= chunk;
+			}
+		}
+
+		// Patches land in the active buffer when they fall inside it, anything that has already
+		// been handed off is written straight to the file once the flusher is idle
+		void patch(std::size_t at, const void* data, std::size_t size){
+			std::vector<uint8_t>& buffer = mBuffers[mActive];
+			if(at >= mActiveBase && at + size <= mActiveBase + buffer.size()){
+				memcpy(buffer.data() + (at - mActiveBase), data, size);
+				return;
+			}
+
+			std::unique_lock<std::mutex> lock(mLock);
+			waitIdle(lock);
+			mFailed = mFailed || !writeAll((const uint8_t*)data, size, at);
+
+			std::size_t start = std::max(at, mActiveBase);
+			std::size_t end = std::min(at + size, mActiveBase + buffer.size());
+			if(start < end) memcpy(buffer.data() + (start - mActiveBase), (const uint8_t*)data + (start - at), end - start);
+		}
+
+		// Flushes everything and stops the flusher, returns false if any write failed
+		bool close(){
+			std::size_t size = getSize();
+			handOff(tell());
+			{
+				std::unique_lock<std::mutex> lock(mLock);
+				waitIdle(lock);
+				mStopping = true;
+				mCondition.notify_all();
+			}
+			mFlusher.join();
+			if(mPreallocated && ftruncate(mFd, size) != 0) mFailed = true;
+			::close(mFd);
+			return !mFailed;
+		}
+};
+
+#endif
+
+///
+///
+///  Text Encodings
+///
+///
+
+// Row of SjisTable for each lead byte 0x81-0x9F, 0xE0-0xFC, 0xFF where the row has no characters
+static const uint8_t SjisLeadRow[60] = {
+	0x00, 0x01, 0x02, 0x03, 0xFF, 0xFF, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D,
+	0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D,
+	0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0xFF, 0xFF, 0x28, 0x29, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x2A, 0x2B, 0x2C,
+};
+
+// Code page 932 double byte characters, indexed by row and trail byte - 0x40. 0 marks unmapped pairs.
+// The user defined rows 0xF0-0xF9 map linearly onto U+E000 and are left out.
+static const uint16_t SjisTable[45][189] = {
+	{
+		0x3000, 0x3001, 0x3002, 0xFF0C, 0xFF0E, 0x30FB, 0xFF1A, 0xFF1B, 0xFF1F, 0xFF01, 0x309B, 0x309C, 0x00B4, 0xFF40, 0x00A8, 0xFF3E,
+		0xFFE3, 0xFF3F, 0x30FD, 0x30FE, 0x309D, 0x309E, 0x3003, 0x4EDD, 0x3005, 0x3006, 0x3007, 0x30FC, 0x2015, 0x2010, 0xFF0F, 0xFF3C,
+		0xFF5E, 0x2225, 0xFF5C, 0x2026, 0x2025, 0x2018, 0x2019, 0x201C, 0x201D, 0xFF08, 0xFF09, 0x3014, 0x3015, 0xFF3B, 0xFF3D, 0xFF5B,
+		0xFF5D, 0x3008, 0x3009, 0x300A, 0x300B, 0x300C, 0x300D, 0x300E, 0x300F, 0x3010, 0x3011, 0xFF0B, 0xFF0D, 0x00B1, 0x00D7, 0x0000,
+		0x00F7, 0xFF1D, 0x2260, 0xFF1C, 0xFF1E, 0x2266, 0x2267, 0x221E, 0x2234, 0x2642, 0x2640, 0x00B0, 0x2032, 0x2033, 0x2103, 0xFFE5,
+		0xFF04, 0xFFE0, 0xFFE1, 0xFF05, 0xFF03, 0xFF06, 0xFF0A, 0xFF20, 0x00A7, 0x2606, 0x2605, 0x25CB, 0x25CF, 0x25CE, 0x25C7, 0x25C6,
+		0x25A1, 0x25A0, 0x25B3, 0x25B2, 0x25BD, 0x25BC, 0x203B, 0x3012, 0x2192, 0x2190, 0x2191, 0x2193, 0x3013, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2208, 0x220B, 0x2286, 0x2287, 0x2282, 0x2283, 0x222A, 0x2229,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2227, 0x2228, 0xFFE2, 0x21D2, 0x21D4, 0x2200, 0x2203, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2220, 0x22A5, 0x2312, 0x2202, 0x2207, 0x2261,
+		0x2252, 0x226A, 0x226B, 0x221A, 0x223D, 0x221D, 0x2235, 0x222B, 0x222C, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x212B, 0x2030, 0x266F, 0x266D, 0x266A, 0x2020, 0x2021, 0x00B6, 0x0000, 0x0000, 0x0000, 0x0000, 0x25EF,
+	},
+	{
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFF10,
+		0xFF11, 0xFF12, 0xFF13, 0xFF14, 0xFF15, 0xFF16, 0xFF17, 0xFF18, 0xFF19, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0xFF21, 0xFF22, 0xFF23, 0xFF24, 0xFF25, 0xFF26, 0xFF27, 0xFF28, 0xFF29, 0xFF2A, 0xFF2B, 0xFF2C, 0xFF2D, 0xFF2E, 0xFF2F, 0xFF30,
+		0xFF31, 0xFF32, 0xFF33, 0xFF34, 0xFF35, 0xFF36, 0xFF37, 0xFF38, 0xFF39, 0xFF3A, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0xFF41, 0xFF42, 0xFF43, 0xFF44, 0xFF45, 0xFF46, 0xFF47, 0xFF48, 0xFF49, 0xFF4A, 0xFF4B, 0xFF4C, 0xFF4D, 0xFF4E, 0xFF4F,
+		0xFF50, 0xFF51, 0xFF52, 0xFF53, 0xFF54, 0xFF55, 0xFF56, 0xFF57, 0xFF58, 0xFF59, 0xFF5A, 0x0000, 0x0000, 0x0000, 0x0000, 0x3041,
+		0x3042, 0x3043, 0x3044, 0x3045, 0x3046, 0x3047, 0x3048, 0x3049, 0x304A, 0x304B, 0x304C, 0x304D, 0x304E, 0x304F, 0x3050, 0x3051,
+		0x3052, 0x3053, 0x3054, 0x3055, 0x3056, 0x3057, 0x3058, 0x3059, 0x305A, 0x305B, 0x305C, 0x305D, 0x305E, 0x305F, 0x3060, 0x3061,
+		0x3062, 0x3063, 0x3064, 0x3065, 0x3066, 0x3067, 0x3068, 0x3069, 0x306A, 0x306B, 0x306C, 0x306D, 0x306E, 0x306F, 0x3070, 0x3071,
+		0x3072, 0x3073, 0x3074, 0x3075, 0x3076, 0x3077, 0x3078, 0x3079, 0x307A, 0x307B, 0x307C, 0x307D, 0x307E, 0x307F, 0x3080, 0x3081,
+		0x3082, 0x3083, 0x3084, 0x3085, 0x3086, 0x3087, 0x3088, 0x3089, 0x308A, 0x308B, 0x308C, 0x308D, 0x308E, 0x308F, 0x3090, 0x3091,
+		0x3092, 0x3093, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{
+		0x30A1, 0x30A2, 0x30A3, 0x30A4, 0x30A5, 0x30A6, 0x30A7, 0x30A8, 0x30A9, 0x30AA, 0x30AB, 0x30AC, 0x30AD, 0x30AE, 0x30AF, 0x30B0,
+		0x30B1, 0x30B2, 0x30B3, 0x30B4, 0x30B5, 0x30B6, 0x30B7, 0x30B8, 0x30B9, 0x30BA, 0x30BB, 0x30BC, 0x30BD, 0x30BE, 0x30BF, 0x30C0,
+		0x30C1, 0x30C2, 0x30C3, 0x30C4, 0x30C5, 0x30C6, 0x30C7, 0x30C8, 0x30C9, 0x30CA, 0x30CB, 0x30CC, 0x30CD, 0x30CE, 0x30CF, 0x30D0,
+		0x30D1, 0x30D2, 0x30D3, 0x30D4, 0x30D5, 0x30D6, 0x30D7, 0x30D8, 0x30D9, 0x30DA, 0x30DB, 0x30DC, 0x30DD, 0x30DE, 0x30DF, 0x0000,
+		0x30E0, 0x30E1, 0x30E2, 0x30E3, 0x30E4, 0x30E5, 0x30E6, 0x30E7, 0x30E8, 0x30E9, 0x30EA, 0x30EB, 0x30EC, 0x30ED, 0x30EE, 0x30EF,
+		0x30F0, 0x30F1, 0x30F2, 0x30F3, 0x30F4, 0x30F5, 0x30F6, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0391,
+		0x0392, 0x0393, 0x0394, 0x0395, 0x0396, 0x0397, 0x0398, 0x0399, 0x039A, 0x039B, 0x039C, 0x039D, 0x039E, 0x039F, 0x03A0, 0x03A1,
+		0x03A3, 0x03A4, 0x03A5, 0x03A6, 0x03A7, 0x03A8, 0x03A9, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x03B1,
+		0x03B2, 0x03B3, 0x03B4, 0x03B5, 0x03B6, 0x03B7, 0x03B8, 0x03B9, 0x03BA, 0x03BB, 0x03BC, 0x03BD, 0x03BE, 0x03BF, 0x03C0, 0x03C1,
+		0x03C3, 0x03C4, 0x03C5, 0x03C6, 0x03C7, 0x03C8, 0x03C9, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{
+		0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0401, 0x0416, 0x0417, 0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E,
+		0x041F, 0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427, 0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E,
+		0x042F, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0451, 0x0436, 0x0437, 0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x0000,
+		0x043E, 0x043F, 0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447, 0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D,
+		0x044E, 0x044F, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2500,
+		0x2502, 0x250C, 0x2510, 0x2518, 0x2514, 0x251C, 0x252C, 0x2524, 0x2534, 0x253C, 0x2501, 0x2503, 0x250F, 0x2513, 0x251B, 0x2517,
+		0x2523, 0x2533, 0x252B, 0x253B, 0x254B, 0x2520, 0x252F, 0x2528, 0x2537, 0x253F, 0x251D, 0x2530, 0x2525, 0x2538, 0x2542, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{
+		0x2460, 0x2461, 0x2462, 0x2463, 0x2464, 0x2465, 0x2466, 0x2467, 0x2468, 0x2469, 0x246A, 0x246B, 0x246C, 0x246D, 0x246E, 0x246F,
+		0x2470, 0x2471, 0x2472, 0x2473, 0x2160, 0x2161, 0x2162, 0x2163, 0x2164, 0x2165, 0x2166, 0x2167, 0x2168, 0x2169, 0x0000, 0x3349,
+		0x3314, 0x3322, 0x334D, 0x3318, 0x3327, 0x3303, 0x3336, 0x3351, 0x3357, 0x330D, 0x3326, 0x3323, 0x332B, 0x334A, 0x333B, 0x339C,
+		0x339D, 0x339E, 0x338E, 0x338F, 0x33C4, 0x33A1, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x337B, 0x0000,
+		0x301D, 0x301F, 0x2116, 0x33CD, 0x2121, 0x32A4, 0x32A5, 0x32A6, 0x32A7, 0x32A8, 0x3231, 0x3232, 0x3239, 0x337E, 0x337D, 0x337C,
+		0x2252, 0x2261, 0x222B, 0x222E, 0x2211, 0x221A, 0x22A5, 0x2220, 0x221F, 0x22BF, 0x2235, 0x2229, 0x222A, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x4E9C,
+		0x5516, 0x5A03, 0x963F, 0x54C0, 0x611B, 0x6328, 0x59F6, 0x9022, 0x8475, 0x831C, 0x7A50, 0x60AA, 0x63E1, 0x6E25, 0x65ED, 0x8466,
+		0x82A6, 0x9BF5, 0x6893, 0x5727, 0x65A1, 0x6271, 0x5B9B, 0x59D0, 0x867B, 0x98F4, 0x7D62, 0x7DBE, 0x9B8E, 0x6216, 0x7C9F, 0x88B7,
+		0x5B89, 0x5EB5, 0x6309, 0x6697, 0x6848, 0x95C7, 0x978D, 0x674F, 0x4EE5, 0x4F0A, 0x4F4D, 0x4F9D, 0x5049, 0x56F2, 0x5937, 0x59D4,
+		0x5A01, 0x5C09, 0x60DF, 0x610F, 0x6170, 0x6613, 0x6905, 0x70BA, 0x754F, 0x7570, 0x79FB, 0x7DAD, 0x7DEF, 0x80C3, 0x840E, 0x8863,
+		0x8B02, 0x9055, 0x907A, 0x533B, 0x4E95, 0x4EA5, 0x57DF, 0x80B2, 0x90C1, 0x78EF, 0x4E00, 0x58F1, 0x6EA2, 0x9038, 0x7A32, 0x8328,
+		0x828B, 0x9C2F, 0x5141, 0x5370, 0x54BD, 0x54E1, 0x56E0, 0x59FB, 0x5F15, 0x98F2, 0x6DEB, 0x80E4, 0x852D,
+	},
+	{
+		0x9662, 0x9670, 0x96A0, 0x97FB, 0x540B, 0x53F3, 0x5B87, 0x70CF, 0x7FBD, 0x8FC2, 0x96E8, 0x536F, 0x9D5C, 0x7ABA, 0x4E11, 0x7893,
+		0x81FC, 0x6E26, 0x5618, 0x5504, 0x6B1D, 0x851A, 0x9C3B, 0x59E5, 0x53A9, 0x6D66, 0x74DC, 0x958F, 0x5642, 0x4E91, 0x904B, 0x96F2,
+		0x834F, 0x990C, 0x53E1, 0x55B6, 0x5B30, 0x5F71, 0x6620, 0x66F3, 0x6804, 0x6C38, 0x6CF3, 0x6D29, 0x745B, 0x76C8, 0x7A4E, 0x9834,
+		0x82F1, 0x885B, 0x8A60, 0x92ED, 0x6DB2, 0x75AB, 0x76CA, 0x99C5, 0x60A6, 0x8B01, 0x8D8A, 0x95B2, 0x698E, 0x53AD, 0x5186, 0x0000,
+		0x5712, 0x5830, 0x5944, 0x5BB4, 0x5EF6, 0x6028, 0x63A9, 0x63F4, 0x6CBF, 0x6F14, 0x708E, 0x7114, 0x7159, 0x71D5, 0x733F, 0x7E01,
+		0x8276, 0x82D1, 0x8597, 0x9060, 0x925B, 0x9D1B, 0x5869, 0x65BC, 0x6C5A, 0x7525, 0x51F9, 0x592E, 0x5965, 0x5F80, 0x5FDC, 0x62BC,
+		0x65FA, 0x6A2A, 0x6B27, 0x6BB4, 0x738B, 0x7FC1, 0x8956, 0x9D2C, 0x9D0E, 0x9EC4, 0x5CA1, 0x6C96, 0x837B, 0x5104, 0x5C4B, 0x61B6,
+		0x81C6, 0x6876, 0x7261, 0x4E59, 0x4FFA, 0x5378, 0x6069, 0x6E29, 0x7A4F, 0x97F3, 0x4E0B, 0x5316, 0x4EEE, 0x4F55, 0x4F3D, 0x4FA1,
+		0x4F73, 0x52A0, 0x53EF, 0x5609, 0x590F, 0x5AC1, 0x5BB6, 0x5BE1, 0x79D1, 0x6687, 0x679C, 0x67B6, 0x6B4C, 0x6CB3, 0x706B, 0x73C2,
+		0x798D, 0x79BE, 0x7A3C, 0x7B87, 0x82B1, 0x82DB, 0x8304, 0x8377, 0x83EF, 0x83D3, 0x8766, 0x8AB2, 0x5629, 0x8CA8, 0x8FE6, 0x904E,
+		0x971E, 0x868A, 0x4FC4, 0x5CE8, 0x6211, 0x7259, 0x753B, 0x81E5, 0x82BD, 0x86FE, 0x8CC0, 0x96C5, 0x9913, 0x99D5, 0x4ECB, 0x4F1A,
+		0x89E3, 0x56DE, 0x584A, 0x58CA, 0x5EFB, 0x5FEB, 0x602A, 0x6094, 0x6062, 0x61D0, 0x6212, 0x62D0, 0x6539,
+	},
+	{
+		0x9B41, 0x6666, 0x68B0, 0x6D77, 0x7070, 0x754C, 0x7686, 0x7D75, 0x82A5, 0x87F9, 0x958B, 0x968E, 0x8C9D, 0x51F1, 0x52BE, 0x5916,
+		0x54B3, 0x5BB3, 0x5D16, 0x6168, 0x6982, 0x6DAF, 0x788D, 0x84CB, 0x8857, 0x8A72, 0x93A7, 0x9AB8, 0x6D6C, 0x99A8, 0x86D9, 0x57A3,
+		0x67FF, 0x86CE, 0x920E, 0x5283, 0x5687, 0x5404, 0x5ED3, 0x62E1, 0x64B9, 0x683C, 0x6838, 0x6BBB, 0x7372, 0x78BA, 0x7A6B, 0x899A,
+		0x89D2, 0x8D6B, 0x8F03, 0x90ED, 0x95A3, 0x9694, 0x9769, 0x5B66, 0x5CB3, 0x697D, 0x984D, 0x984E, 0x639B, 0x7B20, 0x6A2B, 0x0000,
+		0x6A7F, 0x68B6, 0x9C0D, 0x6F5F, 0x5272, 0x559D, 0x6070, 0x62EC, 0x6D3B, 0x6E07, 0x6ED1, 0x845B, 0x8910, 0x8F44, 0x4E14, 0x9C39,
+		0x53F6, 0x691B, 0x6A3A, 0x9784, 0x682A, 0x515C, 0x7AC3, 0x84B2, 0x91DC, 0x938C, 0x565B, 0x9D28, 0x6822, 0x8305, 0x8431, 0x7CA5,
+		0x5208, 0x82C5, 0x74E6, 0x4E7E, 0x4F83, 0x51A0, 0x5BD2, 0x520A, 0x52D8, 0x52E7, 0x5DFB, 0x559A, 0x582A, 0x59E6, 0x5B8C, 0x5B98,
+		0x5BDB, 0x5E72, 0x5E79, 0x60A3, 0x611F, 0x6163, 0x61BE, 0x63DB, 0x6562, 0x67D1, 0x6853, 0x68FA, 0x6B3E, 0x6B53, 0x6C57, 0x6F22,
+		0x6F97, 0x6F45, 0x74B0, 0x7518, 0x76E3, 0x770B, 0x7AFF, 0x7BA1, 0x7C21, 0x7DE9, 0x7F36, 0x7FF0, 0x809D, 0x8266, 0x839E, 0x89B3,
+		0x8ACC, 0x8CAB, 0x9084, 0x9451, 0x9593, 0x9591, 0x95A2, 0x9665, 0x97D3, 0x9928, 0x8218, 0x4E38, 0x542B, 0x5CB8, 0x5DCC, 0x73A9,
+		0x764C, 0x773C, 0x5CA9, 0x7FEB, 0x8D0B, 0x96C1, 0x9811, 0x9854, 0x9858, 0x4F01, 0x4F0E, 0x5371, 0x559C, 0x5668, 0x57FA, 0x5947,
+		0x5B09, 0x5BC4, 0x5C90, 0x5E0C, 0x5E7E, 0x5FCC, 0x63EE, 0x673A, 0x65D7, 0x65E2, 0x671F, 0x68CB, 0x68C4,
+	},
+	{
+		0x6A5F, 0x5E30, 0x6BC5, 0x6C17, 0x6C7D, 0x757F, 0x7948, 0x5B63, 0x7A00, 0x7D00, 0x5FBD, 0x898F, 0x8A18, 0x8CB4, 0x8D77, 0x8ECC,
+		0x8F1D, 0x98E2, 0x9A0E, 0x9B3C, 0x4E80, 0x507D, 0x5100, 0x5993, 0x5B9C, 0x622F, 0x6280, 0x64EC, 0x6B3A, 0x72A0, 0x7591, 0x7947,
+		0x7FA9, 0x87FB, 0x8ABC, 0x8B70, 0x63AC, 0x83CA, 0x97A0, 0x5409, 0x5403, 0x55AB, 0x6854, 0x6A58, 0x8A70, 0x7827, 0x6775, 0x9ECD,
+		0x5374, 0x5BA2, 0x811A, 0x8650, 0x9006, 0x4E18, 0x4E45, 0x4EC7, 0x4F11, 0x53CA, 0x5438, 0x5BAE, 0x5F13, 0x6025, 0x6551, 0x0000,
+		0x673D, 0x6C42, 0x6C72, 0x6CE3, 0x7078, 0x7403, 0x7A76, 0x7AAE, 0x7B08, 0x7D1A, 0x7CFE, 0x7D66, 0x65E7, 0x725B, 0x53BB, 0x5C45,
+		0x5DE8, 0x62D2, 0x62E0, 0x6319, 0x6E20, 0x865A, 0x8A31, 0x8DDD, 0x92F8, 0x6F01, 0x79A6, 0x9B5A, 0x4EA8, 0x4EAB, 0x4EAC, 0x4F9B,
+		0x4FA0, 0x50D1, 0x5147, 0x7AF6, 0x5171, 0x51F6, 0x5354, 0x5321, 0x537F, 0x53EB, 0x55AC, 0x5883, 0x5CE1, 0x5F37, 0x5F4A, 0x602F,
+		0x6050, 0x606D, 0x631F, 0x6559, 0x6A4B, 0x6CC1, 0x72C2, 0x72ED, 0x77EF, 0x80F8, 0x8105, 0x8208, 0x854E, 0x90F7, 0x93E1, 0x97FF,
+		0x9957, 0x9A5A, 0x4EF0, 0x51DD, 0x5C2D, 0x6681, 0x696D, 0x5C40, 0x66F2, 0x6975, 0x7389, 0x6850, 0x7C81, 0x50C5, 0x52E4, 0x5747,
+		0x5DFE, 0x9326, 0x65A4, 0x6B23, 0x6B3D, 0x7434, 0x7981, 0x79BD, 0x7B4B, 0x7DCA, 0x82B9, 0x83CC, 0x887F, 0x895F, 0x8B39, 0x8FD1,
+		0x91D1, 0x541F, 0x9280, 0x4E5D, 0x5036, 0x53E5, 0x533A, 0x72D7, 0x7396, 0x77E9, 0x82E6, 0x8EAF, 0x99C6, 0x99C8, 0x99D2, 0x5177,
+		0x611A, 0x865E, 0x55B0, 0x7A7A, 0x5076, 0x5BD3, 0x9047, 0x9685, 0x4E32, 0x6ADB, 0x91E7, 0x5C51, 0x5C48,
+	},
+	{
+		0x6398, 0x7A9F, 0x6C93, 0x9774, 0x8F61, 0x7AAA, 0x718A, 0x9688, 0x7C82, 0x6817, 0x7E70, 0x6851, 0x936C, 0x52F2, 0x541B, 0x85AB,
+		0x8A13, 0x7FA4, 0x8ECD, 0x90E1, 0x5366, 0x8888, 0x7941, 0x4FC2, 0x50BE, 0x5211, 0x5144, 0x5553, 0x572D, 0x73EA, 0x578B, 0x5951,
+		0x5F62, 0x5F84, 0x6075, 0x6176, 0x6167, 0x61A9, 0x63B2, 0x643A, 0x656C, 0x666F, 0x6842, 0x6E13, 0x7566, 0x7A3D, 0x7CFB, 0x7D4C,
+		0x7D99, 0x7E4B, 0x7F6B, 0x830E, 0x834A, 0x86CD, 0x8A08, 0x8A63, 0x8B66, 0x8EFD, 0x981A, 0x9D8F, 0x82B8, 0x8FCE, 0x9BE8, 0x0000,
+		0x5287, 0x621F, 0x6483, 0x6FC0, 0x9699, 0x6841, 0x5091, 0x6B20, 0x6C7A, 0x6F54, 0x7A74, 0x7D50, 0x8840, 0x8A23, 0x6708, 0x4EF6,
+		0x5039, 0x5026, 0x5065, 0x517C, 0x5238, 0x5263, 0x55A7, 0x570F, 0x5805, 0x5ACC, 0x5EFA, 0x61B2, 0x61F8, 0x62F3, 0x6372, 0x691C,
+		0x6A29, 0x727D, 0x72AC, 0x732E, 0x7814, 0x786F, 0x7D79, 0x770C, 0x80A9, 0x898B, 0x8B19, 0x8CE2, 0x8ED2, 0x9063, 0x9375, 0x967A,
+		0x9855, 0x9A13, 0x9E78, 0x5143, 0x539F, 0x53B3, 0x5E7B, 0x5F26, 0x6E1B, 0x6E90, 0x7384, 0x73FE, 0x7D43, 0x8237, 0x8A00, 0x8AFA,
+		0x9650, 0x4E4E, 0x500B, 0x53E4, 0x547C, 0x56FA, 0x59D1, 0x5B64, 0x5DF1, 0x5EAB, 0x5F27, 0x6238, 0x6545, 0x67AF, 0x6E56, 0x72D0,
+		0x7CCA, 0x88B4, 0x80A1, 0x80E1, 0x83F0, 0x864E, 0x8A87, 0x8DE8, 0x9237, 0x96C7, 0x9867, 0x9F13, 0x4E94, 0x4E92, 0x4F0D, 0x5348,
+		0x5449, 0x543E, 0x5A2F, 0x5F8C, 0x5FA1, 0x609F, 0x68A7, 0x6A8E, 0x745A, 0x7881, 0x8A9E, 0x8AA4, 0x8B77, 0x9190, 0x4E5E, 0x9BC9,
+		0x4EA4, 0x4F7C, 0x4FAF, 0x5019, 0x5016, 0x5149, 0x516C, 0x529F, 0x52B9, 0x52FE, 0x539A, 0x53E3, 0x5411,
+	},
+	{
+		0x540E, 0x5589, 0x5751, 0x57A2, 0x597D, 0x5B54, 0x5B5D, 0x5B8F, 0x5DE5, 0x5DE7, 0x5DF7, 0x5E78, 0x5E83, 0x5E9A, 0x5EB7, 0x5F18,
+		0x6052, 0x614C, 0x6297, 0x62D8, 0x63A7, 0x653B, 0x6602, 0x6643, 0x66F4, 0x676D, 0x6821, 0x6897, 0x69CB, 0x6C5F, 0x6D2A, 0x6D69,
+		0x6E2F, 0x6E9D, 0x7532, 0x7687, 0x786C, 0x7A3F, 0x7CE0, 0x7D05, 0x7D18, 0x7D5E, 0x7DB1, 0x8015, 0x8003, 0x80AF, 0x80B1, 0x8154,
+		0x818F, 0x822A, 0x8352, 0x884C, 0x8861, 0x8B1B, 0x8CA2, 0x8CFC, 0x90CA, 0x9175, 0x9271, 0x783F, 0x92FC, 0x95A4, 0x964D, 0x0000,
+		0x9805, 0x9999, 0x9AD8, 0x9D3B, 0x525B, 0x52AB, 0x53F7, 0x5408, 0x58D5, 0x62F7, 0x6FE0, 0x8C6A, 0x8F5F, 0x9EB9, 0x514B, 0x523B,
+		0x544A, 0x56FD, 0x7A40, 0x9177, 0x9D60, 0x9ED2, 0x7344, 0x6F09, 0x8170, 0x7511, 0x5FFD, 0x60DA, 0x9AA8, 0x72DB, 0x8FBC, 0x6B64,
+		0x9803, 0x4ECA, 0x56F0, 0x5764, 0x58BE, 0x5A5A, 0x6068, 0x61C7, 0x660F, 0x6606, 0x6839, 0x68B1, 0x6DF7, 0x75D5, 0x7D3A, 0x826E,
+		0x9B42, 0x4E9B, 0x4F50, 0x53C9, 0x5506, 0x5D6F, 0x5DE6, 0x5DEE, 0x67FB, 0x6C99, 0x7473, 0x7802, 0x8A50, 0x9396, 0x88DF, 0x5750,
+		0x5EA7, 0x632B, 0x50B5, 0x50AC, 0x518D, 0x6700, 0x54C9, 0x585E, 0x59BB, 0x5BB0, 0x5F69, 0x624D, 0x63A1, 0x683D, 0x6B73, 0x6E08,
+		0x707D, 0x91C7, 0x7280, 0x7815, 0x7826, 0x796D, 0x658E, 0x7D30, 0x83DC, 0x88C1, 0x8F09, 0x969B, 0x5264, 0x5728, 0x6750, 0x7F6A,
+		0x8CA1, 0x51B4, 0x5742, 0x962A, 0x583A, 0x698A, 0x80B4, 0x54B2, 0x5D0E, 0x57FC, 0x7895, 0x9DFA, 0x4F5C, 0x524A, 0x548B, 0x643E,
+		0x6628, 0x6714, 0x67F5, 0x7A84, 0x7B56, 0x7D22, 0x932F, 0x685C, 0x9BAD, 0x7B39, 0x5319, 0x518A, 0x5237,
+	},
+	{
+		0x5BDF, 0x62F6, 0x64AE, 0x64E6, 0x672D, 0x6BBA, 0x85A9, 0x96D1, 0x7690, 0x9BD6, 0x634C, 0x9306, 0x9BAB, 0x76BF, 0x6652, 0x4E09,
+		0x5098, 0x53C2, 0x5C71, 0x60E8, 0x6492, 0x6563, 0x685F, 0x71E6, 0x73CA, 0x7523, 0x7B97, 0x7E82, 0x8695, 0x8B83, 0x8CDB, 0x9178,
+		0x9910, 0x65AC, 0x66AB, 0x6B8B, 0x4ED5, 0x4ED4, 0x4F3A, 0x4F7F, 0x523A, 0x53F8, 0x53F2, 0x55E3, 0x56DB, 0x58EB, 0x59CB, 0x59C9,
+		0x59FF, 0x5B50, 0x5C4D, 0x5E02, 0x5E2B, 0x5FD7, 0x601D, 0x6307, 0x652F, 0x5B5C, 0x65AF, 0x65BD, 0x65E8, 0x679D, 0x6B62, 0x0000,
+		0x6B7B, 0x6C0F, 0x7345, 0x7949, 0x79C1, 0x7CF8, 0x7D19, 0x7D2B, 0x80A2, 0x8102, 0x81F3, 0x8996, 0x8A5E, 0x8A69, 0x8A66, 0x8A8C,
+		0x8AEE, 0x8CC7, 0x8CDC, 0x96CC, 0x98FC, 0x6B6F, 0x4E8B, 0x4F3C, 0x4F8D, 0x5150, 0x5B57, 0x5BFA, 0x6148, 0x6301, 0x6642, 0x6B21,
+		0x6ECB, 0x6CBB, 0x723E, 0x74BD, 0x75D4, 0x78C1, 0x793A, 0x800C, 0x8033, 0x81EA, 0x8494, 0x8F9E, 0x6C50, 0x9E7F, 0x5F0F, 0x8B58,
+		0x9D2B, 0x7AFA, 0x8EF8, 0x5B8D, 0x96EB, 0x4E03, 0x53F1, 0x57F7, 0x5931, 0x5AC9, 0x5BA4, 0x6089, 0x6E7F, 0x6F06, 0x75BE, 0x8CEA,
+		0x5B9F, 0x8500, 0x7BE0, 0x5072, 0x67F4, 0x829D, 0x5C61, 0x854A, 0x7E1E, 0x820E, 0x5199, 0x5C04, 0x6368, 0x8D66, 0x659C, 0x716E,
+		0x793E, 0x7D17, 0x8005, 0x8B1D, 0x8ECA, 0x906E, 0x86C7, 0x90AA, 0x501F, 0x52FA, 0x5C3A, 0x6753, 0x707C, 0x7235, 0x914C, 0x91C8,
+		0x932B, 0x82E5, 0x5BC2, 0x5F31, 0x60F9, 0x4E3B, 0x53D6, 0x5B88, 0x624B, 0x6731, 0x6B8A, 0x72E9, 0x73E0, 0x7A2E, 0x816B, 0x8DA3,
+		0x9152, 0x9996, 0x5112, 0x53D7, 0x546A, 0x5BFF, 0x6388, 0x6A39, 0x7DAC, 0x9700, 0x56DA, 0x53CE, 0x5468,
+	},
+	{
+		0x5B97, 0x5C31, 0x5DDE, 0x4FEE, 0x6101, 0x62FE, 0x6D32, 0x79C0, 0x79CB, 0x7D42, 0x7E4D, 0x7FD2, 0x81ED, 0x821F, 0x8490, 0x8846,
+		0x8972, 0x8B90, 0x8E74, 0x8F2F, 0x9031, 0x914B, 0x916C, 0x96C6, 0x919C, 0x4EC0, 0x4F4F, 0x5145, 0x5341, 0x5F93, 0x620E, 0x67D4,
+		0x6C41, 0x6E0B, 0x7363, 0x7E26, 0x91CD, 0x9283, 0x53D4, 0x5919, 0x5BBF, 0x6DD1, 0x795D, 0x7E2E, 0x7C9B, 0x587E, 0x719F, 0x51FA,
+		0x8853, 0x8FF0, 0x4FCA, 0x5CFB, 0x6625, 0x77AC, 0x7AE3, 0x821C, 0x99FF, 0x51C6, 0x5FAA, 0x65EC, 0x696F, 0x6B89, 0x6DF3, 0x0000,
+		0x6E96, 0x6F64, 0x76FE, 0x7D14, 0x5DE1, 0x9075, 0x9187, 0x9806, 0x51E6, 0x521D, 0x6240, 0x6691, 0x66D9, 0x6E1A, 0x5EB6, 0x7DD2,
+		0x7F72, 0x66F8, 0x85AF, 0x85F7, 0x8AF8, 0x52A9, 0x53D9, 0x5973, 0x5E8F, 0x5F90, 0x6055, 0x92E4, 0x9664, 0x50B7, 0x511F, 0x52DD,
+		0x5320, 0x5347, 0x53EC, 0x54E8, 0x5546, 0x5531, 0x5617, 0x5968, 0x59BE, 0x5A3C, 0x5BB5, 0x5C06, 0x5C0F, 0x5C11, 0x5C1A, 0x5E84,
+		0x5E8A, 0x5EE0, 0x5F70, 0x627F, 0x6284, 0x62DB, 0x638C, 0x6377, 0x6607, 0x660C, 0x662D, 0x6676, 0x677E, 0x68A2, 0x6A1F, 0x6A35,
+		0x6CBC, 0x6D88, 0x6E09, 0x6E58, 0x713C, 0x7126, 0x7167, 0x75C7, 0x7701, 0x785D, 0x7901, 0x7965, 0x79F0, 0x7AE0, 0x7B11, 0x7CA7,
+		0x7D39, 0x8096, 0x83D6, 0x848B, 0x8549, 0x885D, 0x88F3, 0x8A1F, 0x8A3C, 0x8A54, 0x8A73, 0x8C61, 0x8CDE, 0x91A4, 0x9266, 0x937E,
+		0x9418, 0x969C, 0x9798, 0x4E0A, 0x4E08, 0x4E1E, 0x4E57, 0x5197, 0x5270, 0x57CE, 0x5834, 0x58CC, 0x5B22, 0x5E38, 0x60C5, 0x64FE,
+		0x6761, 0x6756, 0x6D44, 0x72B6, 0x7573, 0x7A63, 0x84B8, 0x8B72, 0x91B8, 0x9320, 0x5631, 0x57F4, 0x98FE,
+	},
+	{
+		0x62ED, 0x690D, 0x6B96, 0x71ED, 0x7E54, 0x8077, 0x8272, 0x89E6, 0x98DF, 0x8755, 0x8FB1, 0x5C3B, 0x4F38, 0x4FE1, 0x4FB5, 0x5507,
+		0x5A20, 0x5BDD, 0x5BE9, 0x5FC3, 0x614E, 0x632F, 0x65B0, 0x664B, 0x68EE, 0x699B, 0x6D78, 0x6DF1, 0x7533, 0x75B9, 0x771F, 0x795E,
+		0x79E6, 0x7D33, 0x81E3, 0x82AF, 0x85AA, 0x89AA, 0x8A3A, 0x8EAB, 0x8F9B, 0x9032, 0x91DD, 0x9707, 0x4EBA, 0x4EC1, 0x5203, 0x5875,
+		0x58EC, 0x5C0B, 0x751A, 0x5C3D, 0x814E, 0x8A0A, 0x8FC5, 0x9663, 0x976D, 0x7B25, 0x8ACF, 0x9808, 0x9162, 0x56F3, 0x53A8, 0x0000,
+		0x9017, 0x5439, 0x5782, 0x5E25, 0x63A8, 0x6C34, 0x708A, 0x7761, 0x7C8B, 0x7FE0, 0x8870, 0x9042, 0x9154, 0x9310, 0x9318, 0x968F,
+		0x745E, 0x9AC4, 0x5D07, 0x5D69, 0x6570, 0x67A2, 0x8DA8, 0x96DB, 0x636E, 0x6749, 0x6919, 0x83C5, 0x9817, 0x96C0, 0x88FE, 0x6F84,
+		0x647A, 0x5BF8, 0x4E16, 0x702C, 0x755D, 0x662F, 0x51C4, 0x5236, 0x52E2, 0x59D3, 0x5F81, 0x6027, 0x6210, 0x653F, 0x6574, 0x661F,
+		0x6674, 0x68F2, 0x6816, 0x6B63, 0x6E05, 0x7272, 0x751F, 0x76DB, 0x7CBE, 0x8056, 0x58F0, 0x88FD, 0x897F, 0x8AA0, 0x8A93, 0x8ACB,
+		0x901D, 0x9192, 0x9752, 0x9759, 0x6589, 0x7A0E, 0x8106, 0x96BB, 0x5E2D, 0x60DC, 0x621A, 0x65A5, 0x6614, 0x6790, 0x77F3, 0x7A4D,
+		0x7C4D, 0x7E3E, 0x810A, 0x8CAC, 0x8D64, 0x8DE1, 0x8E5F, 0x78A9, 0x5207, 0x62D9, 0x63A5, 0x6442, 0x6298, 0x8A2D, 0x7A83, 0x7BC0,
+		0x8AAC, 0x96EA, 0x7D76, 0x820C, 0x8749, 0x4ED9, 0x5148, 0x5343, 0x5360, 0x5BA3, 0x5C02, 0x5C16, 0x5DDD, 0x6226, 0x6247, 0x64B0,
+		0x6813, 0x6834, 0x6CC9, 0x6D45, 0x6D17, 0x67D3, 0x6F5C, 0x714E, 0x717D, 0x65CB, 0x7A7F, 0x7BAD, 0x7DDA,
+	},
+	{
+		0x7E4A, 0x7FA8, 0x817A, 0x821B, 0x8239, 0x85A6, 0x8A6E, 0x8CCE, 0x8DF5, 0x9078, 0x9077, 0x92AD, 0x9291, 0x9583, 0x9BAE, 0x524D,
+		0x5584, 0x6F38, 0x7136, 0x5168, 0x7985, 0x7E55, 0x81B3, 0x7CCE, 0x564C, 0x5851, 0x5CA8, 0x63AA, 0x66FE, 0x66FD, 0x695A, 0x72D9,
+		0x758F, 0x758E, 0x790E, 0x7956, 0x79DF, 0x7C97, 0x7D20, 0x7D44, 0x8607, 0x8A34, 0x963B, 0x9061, 0x9F20, 0x50E7, 0x5275, 0x53CC,
+		0x53E2, 0x5009, 0x55AA, 0x58EE, 0x594F, 0x723D, 0x5B8B, 0x5C64, 0x531D, 0x60E3, 0x60F3, 0x635C, 0x6383, 0x633F, 0x63BB, 0x0000,
+		0x64CD, 0x65E9, 0x66F9, 0x5DE3, 0x69CD, 0x69FD, 0x6F15, 0x71E5, 0x4E89, 0x75E9, 0x76F8, 0x7A93, 0x7CDF, 0x7DCF, 0x7D9C, 0x8061,
+		0x8349, 0x8358, 0x846C, 0x84BC, 0x85FB, 0x88C5, 0x8D70, 0x9001, 0x906D, 0x9397, 0x971C, 0x9A12, 0x50CF, 0x5897, 0x618E, 0x81D3,
+		0x8535, 0x8D08, 0x9020, 0x4FC3, 0x5074, 0x5247, 0x5373, 0x606F, 0x6349, 0x675F, 0x6E2C, 0x8DB3, 0x901F, 0x4FD7, 0x5C5E, 0x8CCA,
+		0x65CF, 0x7D9A, 0x5352, 0x8896, 0x5176, 0x63C3, 0x5B58, 0x5B6B, 0x5C0A, 0x640D, 0x6751, 0x905C, 0x4ED6, 0x591A, 0x592A, 0x6C70,
+		0x8A51, 0x553E, 0x5815, 0x59A5, 0x60F0, 0x6253, 0x67C1, 0x8235, 0x6955, 0x9640, 0x99C4, 0x9A28, 0x4F53, 0x5806, 0x5BFE, 0x8010,
+		0x5CB1, 0x5E2F, 0x5F85, 0x6020, 0x614B, 0x6234, 0x66FF, 0x6CF0, 0x6EDE, 0x80CE, 0x817F, 0x82D4, 0x888B, 0x8CB8, 0x9000, 0x902E,
+		0x968A, 0x9EDB, 0x9BDB, 0x4EE3, 0x53F0, 0x5927, 0x7B2C, 0x918D, 0x984C, 0x9DF9, 0x6EDD, 0x7027, 0x5353, 0x5544, 0x5B85, 0x6258,
+		0x629E, 0x62D3, 0x6CA2, 0x6FEF, 0x7422, 0x8A17, 0x9438, 0x6FC1, 0x8AFE, 0x8338, 0x51E7, 0x86F8, 0x53EA,
+	},
+	{
+		0x53E9, 0x4F46, 0x9054, 0x8FB0, 0x596A, 0x8131, 0x5DFD, 0x7AEA, 0x8FBF, 0x68DA, 0x8C37, 0x72F8, 0x9C48, 0x6A3D, 0x8AB0, 0x4E39,
+		0x5358, 0x5606, 0x5766, 0x62C5, 0x63A2, 0x65E6, 0x6B4E, 0x6DE1, 0x6E5B, 0x70AD, 0x77ED, 0x7AEF, 0x7BAA, 0x7DBB, 0x803D, 0x80C6,
+		0x86CB, 0x8A95, 0x935B, 0x56E3, 0x58C7, 0x5F3E, 0x65AD, 0x6696, 0x6A80, 0x6BB5, 0x7537, 0x8AC7, 0x5024, 0x77E5, 0x5730, 0x5F1B,
+		0x6065, 0x667A, 0x6C60, 0x75F4, 0x7A1A, 0x7F6E, 0x81F4, 0x8718, 0x9045, 0x99B3, 0x7BC9, 0x755C, 0x7AF9, 0x7B51, 0x84C4, 0x0000,
+		0x9010, 0x79E9, 0x7A92, 0x8336, 0x5AE1, 0x7740, 0x4E2D, 0x4EF2, 0x5B99, 0x5FE0, 0x62BD, 0x663C, 0x67F1, 0x6CE8, 0x866B, 0x8877,
+		0x8A3B, 0x914E, 0x92F3, 0x99D0, 0x6A17, 0x7026, 0x732A, 0x82E7, 0x8457, 0x8CAF, 0x4E01, 0x5146, 0x51CB, 0x558B, 0x5BF5, 0x5E16,
+		0x5E33, 0x5E81, 0x5F14, 0x5F35, 0x5F6B, 0x5FB4, 0x61F2, 0x6311, 0x66A2, 0x671D, 0x6F6E, 0x7252, 0x753A, 0x773A, 0x8074, 0x8139,
+		0x8178, 0x8776, 0x8ABF, 0x8ADC, 0x8D85, 0x8DF3, 0x929A, 0x9577, 0x9802, 0x9CE5, 0x52C5, 0x6357, 0x76F4, 0x6715, 0x6C88, 0x73CD,
+		0x8CC3, 0x93AE, 0x9673, 0x6D25, 0x589C, 0x690E, 0x69CC, 0x8FFD, 0x939A, 0x75DB, 0x901A, 0x585A, 0x6802, 0x63B4, 0x69FB, 0x4F43,
+		0x6F2C, 0x67D8, 0x8FBB, 0x8526, 0x7DB4, 0x9354, 0x693F, 0x6F70, 0x576A, 0x58F7, 0x5B2C, 0x7D2C, 0x722A, 0x540A, 0x91E3, 0x9DB4,
+		0x4EAD, 0x4F4E, 0x505C, 0x5075, 0x5243, 0x8C9E, 0x5448, 0x5824, 0x5B9A, 0x5E1D, 0x5E95, 0x5EAD, 0x5EF7, 0x5F1F, 0x608C, 0x62B5,
+		0x633A, 0x63D0, 0x68AF, 0x6C40, 0x7887, 0x798E, 0x7A0B, 0x7DE0, 0x8247, 0x8A02, 0x8AE6, 0x8E44, 0x9013,
+	},
+	{
+		0x90B8, 0x912D, 0x91D8, 0x9F0E, 0x6CE5, 0x6458, 0x64E2, 0x6575, 0x6EF4, 0x7684, 0x7B1B, 0x9069, 0x93D1, 0x6EBA, 0x54F2, 0x5FB9,
+		0x64A4, 0x8F4D, 0x8FED, 0x9244, 0x5178, 0x586B, 0x5929, 0x5C55, 0x5E97, 0x6DFB, 0x7E8F, 0x751C, 0x8CBC, 0x8EE2, 0x985B, 0x70B9,
+		0x4F1D, 0x6BBF, 0x6FB1, 0x7530, 0x96FB, 0x514E, 0x5410, 0x5835, 0x5857, 0x59AC, 0x5C60, 0x5F92, 0x6597, 0x675C, 0x6E21, 0x767B,
+		0x83DF, 0x8CED, 0x9014, 0x90FD, 0x934D, 0x7825, 0x783A, 0x52AA, 0x5EA6, 0x571F, 0x5974, 0x6012, 0x5012, 0x515A, 0x51AC, 0x0000,
+		0x51CD, 0x5200, 0x5510, 0x5854, 0x5858, 0x5957, 0x5B95, 0x5CF6, 0x5D8B, 0x60BC, 0x6295, 0x642D, 0x6771, 0x6843, 0x68BC, 0x68DF,
+		0x76D7, 0x6DD8, 0x6E6F, 0x6D9B, 0x706F, 0x71C8, 0x5F53, 0x75D8, 0x7977, 0x7B49, 0x7B54, 0x7B52, 0x7CD6, 0x7D71, 0x5230, 0x8463,
+		0x8569, 0x85E4, 0x8A0E, 0x8B04, 0x8C46, 0x8E0F, 0x9003, 0x900F, 0x9419, 0x9676, 0x982D, 0x9A30, 0x95D8, 0x50CD, 0x52D5, 0x540C,
+		0x5802, 0x5C0E, 0x61A7, 0x649E, 0x6D1E, 0x77B3, 0x7AE5, 0x80F4, 0x8404, 0x9053, 0x9285, 0x5CE0, 0x9D07, 0x533F, 0x5F97, 0x5FB3,
+		0x6D9C, 0x7279, 0x7763, 0x79BF, 0x7BE4, 0x6BD2, 0x72EC, 0x8AAD, 0x6803, 0x6A61, 0x51F8, 0x7A81, 0x6934, 0x5C4A, 0x9CF6, 0x82EB,
+		0x5BC5, 0x9149, 0x701E, 0x5678, 0x5C6F, 0x60C7, 0x6566, 0x6C8C, 0x8C5A, 0x9041, 0x9813, 0x5451, 0x66C7, 0x920D, 0x5948, 0x90A3,
+		0x5185, 0x4E4D, 0x51EA, 0x8599, 0x8B0E, 0x7058, 0x637A, 0x934B, 0x6962, 0x99B4, 0x7E04, 0x7577, 0x5357, 0x6960, 0x8EDF, 0x96E3,
+		0x6C5D, 0x4E8C, 0x5C3C, 0x5F10, 0x8FE9, 0x5302, 0x8CD1, 0x8089, 0x8679, 0x5EFF, 0x65E5, 0x4E73, 0x5165,
+	},
+	{
+		0x5982, 0x5C3F, 0x97EE, 0x4EFB, 0x598A, 0x5FCD, 0x8A8D, 0x6FE1, 0x79B0, 0x7962, 0x5BE7, 0x8471, 0x732B, 0x71B1, 0x5E74, 0x5FF5,
+		0x637B, 0x649A, 0x71C3, 0x7C98, 0x4E43, 0x5EFC, 0x4E4B, 0x57DC, 0x56A2, 0x60A9, 0x6FC3, 0x7D0D, 0x80FD, 0x8133, 0x81BF, 0x8FB2,
+		0x8997, 0x86A4, 0x5DF4, 0x628A, 0x64AD, 0x8987, 0x6777, 0x6CE2, 0x6D3E, 0x7436, 0x7834, 0x5A46, 0x7F75, 0x82AD, 0x99AC, 0x4FF3,
+		0x5EC3, 0x62DD, 0x6392, 0x6557, 0x676F, 0x76C3, 0x724C, 0x80CC, 0x80BA, 0x8F29, 0x914D, 0x500D, 0x57F9, 0x5A92, 0x6885, 0x0000,
+		0x6973, 0x7164, 0x72FD, 0x8CB7, 0x58F2, 0x8CE0, 0x966A, 0x9019, 0x877F, 0x79E4, 0x77E7, 0x8429, 0x4F2F, 0x5265, 0x535A, 0x62CD,
+		0x67CF, 0x6CCA, 0x767D, 0x7B94, 0x7C95, 0x8236, 0x8584, 0x8FEB, 0x66DD, 0x6F20, 0x7206, 0x7E1B, 0x83AB, 0x99C1, 0x9EA6, 0x51FD,
+		0x7BB1, 0x7872, 0x7BB8, 0x8087, 0x7B48, 0x6AE8, 0x5E61, 0x808C, 0x7551, 0x7560, 0x516B, 0x9262, 0x6E8C, 0x767A, 0x9197, 0x9AEA,
+		0x4F10, 0x7F70, 0x629C, 0x7B4F, 0x95A5, 0x9CE9, 0x567A, 0x5859, 0x86E4, 0x96BC, 0x4F34, 0x5224, 0x534A, 0x53CD, 0x53DB, 0x5E06,
+		0x642C, 0x6591, 0x677F, 0x6C3E, 0x6C4E, 0x7248, 0x72AF, 0x73ED, 0x7554, 0x7E41, 0x822C, 0x85E9, 0x8CA9, 0x7BC4, 0x91C6, 0x7169,
+		0x9812, 0x98EF, 0x633D, 0x6669, 0x756A, 0x76E4, 0x78D0, 0x8543, 0x86EE, 0x532A, 0x5351, 0x5426, 0x5983, 0x5E87, 0x5F7C, 0x60B2,
+		0x6249, 0x6279, 0x62AB, 0x6590, 0x6BD4, 0x6CCC, 0x75B2, 0x76AE, 0x7891, 0x79D8, 0x7DCB, 0x7F77, 0x80A5, 0x88AB, 0x8AB9, 0x8CBB,
+		0x907F, 0x975E, 0x98DB, 0x6A0B, 0x7C38, 0x5099, 0x5C3E, 0x5FAE, 0x6787, 0x6BD8, 0x7435, 0x7709, 0x7F8E,
+	},
+	{
+		0x9F3B, 0x67CA, 0x7A17, 0x5339, 0x758B, 0x9AED, 0x5F66, 0x819D, 0x83F1, 0x8098, 0x5F3C, 0x5FC5, 0x7562, 0x7B46, 0x903C, 0x6867,
+		0x59EB, 0x5A9B, 0x7D10, 0x767E, 0x8B2C, 0x4FF5, 0x5F6A, 0x6A19, 0x6C37, 0x6F02, 0x74E2, 0x7968, 0x8868, 0x8A55, 0x8C79, 0x5EDF,
+		0x63CF, 0x75C5, 0x79D2, 0x82D7, 0x9328, 0x92F2, 0x849C, 0x86ED, 0x9C2D, 0x54C1, 0x5F6C, 0x658C, 0x6D5C, 0x7015, 0x8CA7, 0x8CD3,
+		0x983B, 0x654F, 0x74F6, 0x4E0D, 0x4ED8, 0x57E0, 0x592B, 0x5A66, 0x5BCC, 0x51A8, 0x5E03, 0x5E9C, 0x6016, 0x6276, 0x6577, 0x0000,
+		0x65A7, 0x666E, 0x6D6E, 0x7236, 0x7B26, 0x8150, 0x819A, 0x8299, 0x8B5C, 0x8CA0, 0x8CE6, 0x8D74, 0x961C, 0x9644, 0x4FAE, 0x64AB,
+		0x6B66, 0x821E, 0x8461, 0x856A, 0x90E8, 0x5C01, 0x6953, 0x98A8, 0x847A, 0x8557, 0x4F0F, 0x526F, 0x5FA9, 0x5E45, 0x670D, 0x798F,
+		0x8179, 0x8907, 0x8986, 0x6DF5, 0x5F17, 0x6255, 0x6CB8, 0x4ECF, 0x7269, 0x9B92, 0x5206, 0x543B, 0x5674, 0x58B3, 0x61A4, 0x626E,
+		0x711A, 0x596E, 0x7C89, 0x7CDE, 0x7D1B, 0x96F0, 0x6587, 0x805E, 0x4E19, 0x4F75, 0x5175, 0x5840, 0x5E63, 0x5E73, 0x5F0A, 0x67C4,
+		0x4E26, 0x853D, 0x9589, 0x965B, 0x7C73, 0x9801, 0x50FB, 0x58C1, 0x7656, 0x78A7, 0x5225, 0x77A5, 0x8511, 0x7B86, 0x504F, 0x5909,
+		0x7247, 0x7BC7, 0x7DE8, 0x8FBA, 0x8FD4, 0x904D, 0x4FBF, 0x52C9, 0x5A29, 0x5F01, 0x97AD, 0x4FDD, 0x8217, 0x92EA, 0x5703, 0x6355,
+		0x6B69, 0x752B, 0x88DC, 0x8F14, 0x7A42, 0x52DF, 0x5893, 0x6155, 0x620A, 0x66AE, 0x6BCD, 0x7C3F, 0x83E9, 0x5023, 0x4FF8, 0x5305,
+		0x5446, 0x5831, 0x5949, 0x5B9D, 0x5CF0, 0x5CEF, 0x5D29, 0x5E96, 0x62B1, 0x6367, 0x653E, 0x65B9, 0x670B,
+	},
+	{
+		0x6CD5, 0x6CE1, 0x70F9, 0x7832, 0x7E2B, 0x80DE, 0x82B3, 0x840C, 0x84EC, 0x8702, 0x8912, 0x8A2A, 0x8C4A, 0x90A6, 0x92D2, 0x98FD,
+		0x9CF3, 0x9D6C, 0x4E4F, 0x4EA1, 0x508D, 0x5256, 0x574A, 0x59A8, 0x5E3D, 0x5FD8, 0x5FD9, 0x623F, 0x66B4, 0x671B, 0x67D0, 0x68D2,
+		0x5192, 0x7D21, 0x80AA, 0x81A8, 0x8B00, 0x8C8C, 0x8CBF, 0x927E, 0x9632, 0x5420, 0x982C, 0x5317, 0x50D5, 0x535C, 0x58A8, 0x64B2,
+		0x6734, 0x7267, 0x7766, 0x7A46, 0x91E6, 0x52C3, 0x6CA1, 0x6B86, 0x5800, 0x5E4C, 0x5954, 0x672C, 0x7FFB, 0x51E1, 0x76C6, 0x0000,
+		0x6469, 0x78E8, 0x9B54, 0x9EBB, 0x57CB, 0x59B9, 0x6627, 0x679A, 0x6BCE, 0x54E9, 0x69D9, 0x5E55, 0x819C, 0x6795, 0x9BAA, 0x67FE,
+		0x9C52, 0x685D, 0x4EA6, 0x4FE3, 0x53C8, 0x62B9, 0x672B, 0x6CAB, 0x8FC4, 0x4FAD, 0x7E6D, 0x9EBF, 0x4E07, 0x6162, 0x6E80, 0x6F2B,
+		0x8513, 0x5473, 0x672A, 0x9B45, 0x5DF3, 0x7B95, 0x5CAC, 0x5BC6, 0x871C, 0x6E4A, 0x84D1, 0x7A14, 0x8108, 0x5999, 0x7C8D, 0x6C11,
+		0x7720, 0x52D9, 0x5922, 0x7121, 0x725F, 0x77DB, 0x9727, 0x9D61, 0x690B, 0x5A7F, 0x5A18, 0x51A5, 0x540D, 0x547D, 0x660E, 0x76DF,
+		0x8FF7, 0x9298, 0x9CF4, 0x59EA, 0x725D, 0x6EC5, 0x514D, 0x68C9, 0x7DBF, 0x7DEC, 0x9762, 0x9EBA, 0x6478, 0x6A21, 0x8302, 0x5984,
+		0x5B5F, 0x6BDB, 0x731B, 0x76F2, 0x7DB2, 0x8017, 0x8499, 0x5132, 0x6728, 0x9ED9, 0x76EE, 0x6762, 0x52FF, 0x9905, 0x5C24, 0x623B,
+		0x7C7E, 0x8CB0, 0x554F, 0x60B6, 0x7D0B, 0x9580, 0x5301, 0x4E5F, 0x51B6, 0x591C, 0x723A, 0x8036, 0x91CE, 0x5F25, 0x77E2, 0x5384,
+		0x5F79, 0x7D04, 0x85AC, 0x8A33, 0x8E8D, 0x9756, 0x67F3, 0x85AE, 0x9453, 0x6109, 0x6108, 0x6CB9, 0x7652,
+	},
+	{
+		0x8AED, 0x8F38, 0x552F, 0x4F51, 0x512A, 0x52C7, 0x53CB, 0x5BA5, 0x5E7D, 0x60A0, 0x6182, 0x63D6, 0x6709, 0x67DA, 0x6E67, 0x6D8C,
+		0x7336, 0x7337, 0x7531, 0x7950, 0x88D5, 0x8A98, 0x904A, 0x9091, 0x90F5, 0x96C4, 0x878D, 0x5915, 0x4E88, 0x4F59, 0x4E0E, 0x8A89,
+		0x8F3F, 0x9810, 0x50AD, 0x5E7C, 0x5996, 0x5BB9, 0x5EB8, 0x63DA, 0x63FA, 0x64C1, 0x66DC, 0x694A, 0x69D8, 0x6D0B, 0x6EB6, 0x7194,
+		0x7528, 0x7AAF, 0x7F8A, 0x8000, 0x8449, 0x84C9, 0x8981, 0x8B21, 0x8E0A, 0x9065, 0x967D, 0x990A, 0x617E, 0x6291, 0x6B32, 0x0000,
+		0x6C83, 0x6D74, 0x7FCC, 0x7FFC, 0x6DC0, 0x7F85, 0x87BA, 0x88F8, 0x6765, 0x83B1, 0x983C, 0x96F7, 0x6D1B, 0x7D61, 0x843D, 0x916A,
+		0x4E71, 0x5375, 0x5D50, 0x6B04, 0x6FEB, 0x85CD, 0x862D, 0x89A7, 0x5229, 0x540F, 0x5C65, 0x674E, 0x68A8, 0x7406, 0x7483, 0x75E2,
+		0x88CF, 0x88E1, 0x91CC, 0x96E2, 0x9678, 0x5F8B, 0x7387, 0x7ACB, 0x844E, 0x63A0, 0x7565, 0x5289, 0x6D41, 0x6E9C, 0x7409, 0x7559,
+		0x786B, 0x7C92, 0x9686, 0x7ADC, 0x9F8D, 0x4FB6, 0x616E, 0x65C5, 0x865C, 0x4E86, 0x4EAE, 0x50DA, 0x4E21, 0x51CC, 0x5BEE, 0x6599,
+		0x6881, 0x6DBC, 0x731F, 0x7642, 0x77AD, 0x7A1C, 0x7CE7, 0x826F, 0x8AD2, 0x907C, 0x91CF, 0x9675, 0x9818, 0x529B, 0x7DD1, 0x502B,
+		0x5398, 0x6797, 0x6DCB, 0x71D0, 0x7433, 0x81E8, 0x8F2A, 0x96A3, 0x9C57, 0x9E9F, 0x7460, 0x5841, 0x6D99, 0x7D2F, 0x985E, 0x4EE4,
+		0x4F36, 0x4F8B, 0x51B7, 0x52B1, 0x5DBA, 0x601C, 0x73B2, 0x793C, 0x82D3, 0x9234, 0x96B7, 0x96F6, 0x970A, 0x9E97, 0x9F62, 0x66A6,
+		0x6B74, 0x5217, 0x52A3, 0x70C8, 0x88C2, 0x5EC9, 0x604B, 0x6190, 0x6F23, 0x7149, 0x7C3E, 0x7DF4, 0x806F,
+	},
+	{
+		0x84EE, 0x9023, 0x932C, 0x5442, 0x9B6F, 0x6AD3, 0x7089, 0x8CC2, 0x8DEF, 0x9732, 0x52B4, 0x5A41, 0x5ECA, 0x5F04, 0x6717, 0x697C,
+		0x6994, 0x6D6A, 0x6F0F, 0x7262, 0x72FC, 0x7BED, 0x8001, 0x807E, 0x874B, 0x90CE, 0x516D, 0x9E93, 0x7984, 0x808B, 0x9332, 0x8AD6,
+		0x502D, 0x548C, 0x8A71, 0x6B6A, 0x8CC4, 0x8107, 0x60D1, 0x67A0, 0x9DF2, 0x4E99, 0x4E98, 0x9C10, 0x8A6B, 0x85C1, 0x8568, 0x6900,
+		0x6E7E, 0x7897, 0x8155, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x5F0C,
+		0x4E10, 0x4E15, 0x4E2A, 0x4E31, 0x4E36, 0x4E3C, 0x4E3F, 0x4E42, 0x4E56, 0x4E58, 0x4E82, 0x4E85, 0x8C6B, 0x4E8A, 0x8212, 0x5F0D,
+		0x4E8E, 0x4E9E, 0x4E9F, 0x4EA0, 0x4EA2, 0x4EB0, 0x4EB3, 0x4EB6, 0x4ECE, 0x4ECD, 0x4EC4, 0x4EC6, 0x4EC2, 0x4ED7, 0x4EDE, 0x4EED,
+		0x4EDF, 0x4EF7, 0x4F09, 0x4F5A, 0x4F30, 0x4F5B, 0x4F5D, 0x4F57, 0x4F47, 0x4F76, 0x4F88, 0x4F8F, 0x4F98, 0x4F7B, 0x4F69, 0x4F70,
+		0x4F91, 0x4F6F, 0x4F86, 0x4F96, 0x5118, 0x4FD4, 0x4FDF, 0x4FCE, 0x4FD8, 0x4FDB, 0x4FD1, 0x4FDA, 0x4FD0, 0x4FE4, 0x4FE5, 0x501A,
+		0x5028, 0x5014, 0x502A, 0x5025, 0x5005, 0x4F1C, 0x4FF6, 0x5021, 0x5029, 0x502C, 0x4FFE, 0x4FEF, 0x5011, 0x5006, 0x5043, 0x5047,
+		0x6703, 0x5055, 0x5050, 0x5048, 0x505A, 0x5056, 0x506C, 0x5078, 0x5080, 0x509A, 0x5085, 0x50B4, 0x50B2,
+	},
+	{
+		0x50C9, 0x50CA, 0x50B3, 0x50C2, 0x50D6, 0x50DE, 0x50E5, 0x50ED, 0x50E3, 0x50EE, 0x50F9, 0x50F5, 0x5109, 0x5101, 0x5102, 0x5116,
+		0x5115, 0x5114, 0x511A, 0x5121, 0x513A, 0x5137, 0x513C, 0x513B, 0x513F, 0x5140, 0x5152, 0x514C, 0x5154, 0x5162, 0x7AF8, 0x5169,
+		0x516A, 0x516E, 0x5180, 0x5182, 0x56D8, 0x518C, 0x5189, 0x518F, 0x5191, 0x5193, 0x5195, 0x5196, 0x51A4, 0x51A6, 0x51A2, 0x51A9,
+		0x51AA, 0x51AB, 0x51B3, 0x51B1, 0x51B2, 0x51B0, 0x51B5, 0x51BD, 0x51C5, 0x51C9, 0x51DB, 0x51E0, 0x8655, 0x51E9, 0x51ED, 0x0000,
+		0x51F0, 0x51F5, 0x51FE, 0x5204, 0x520B, 0x5214, 0x520E, 0x5227, 0x522A, 0x522E, 0x5233, 0x5239, 0x524F, 0x5244, 0x524B, 0x524C,
+		0x525E, 0x5254, 0x526A, 0x5274, 0x5269, 0x5273, 0x527F, 0x527D, 0x528D, 0x5294, 0x5292, 0x5271, 0x5288, 0x5291, 0x8FA8, 0x8FA7,
+		0x52AC, 0x52AD, 0x52BC, 0x52B5, 0x52C1, 0x52CD, 0x52D7, 0x52DE, 0x52E3, 0x52E6, 0x98ED, 0x52E0, 0x52F3, 0x52F5, 0x52F8, 0x52F9,
+		0x5306, 0x5308, 0x7538, 0x530D, 0x5310, 0x530F, 0x5315, 0x531A, 0x5323, 0x532F, 0x5331, 0x5333, 0x5338, 0x5340, 0x5346, 0x5345,
+		0x4E17, 0x5349, 0x534D, 0x51D6, 0x535E, 0x5369, 0x536E, 0x5918, 0x537B, 0x5377, 0x5382, 0x5396, 0x53A0, 0x53A6, 0x53A5, 0x53AE,
+		0x53B0, 0x53B6, 0x53C3, 0x7C12, 0x96D9, 0x53DF, 0x66FC, 0x71EE, 0x53EE, 0x53E8, 0x53ED, 0x53FA, 0x5401, 0x543D, 0x5440, 0x542C,
+		0x542D, 0x543C, 0x542E, 0x5436, 0x5429, 0x541D, 0x544E, 0x548F, 0x5475, 0x548E, 0x545F, 0x5471, 0x5477, 0x5470, 0x5492, 0x547B,
+		0x5480, 0x5476, 0x5484, 0x5490, 0x5486, 0x54C7, 0x54A2, 0x54B8, 0x54A5, 0x54AC, 0x54C4, 0x54C8, 0x54A8,
+	},
+	{
+		0x54AB, 0x54C2, 0x54A4, 0x54BE, 0x54BC, 0x54D8, 0x54E5, 0x54E6, 0x550F, 0x5514, 0x54FD, 0x54EE, 0x54ED, 0x54FA, 0x54E2, 0x5539,
+		0x5540, 0x5563, 0x554C, 0x552E, 0x555C, 0x5545, 0x5556, 0x5557, 0x5538, 0x5533, 0x555D, 0x5599, 0x5580, 0x54AF, 0x558A, 0x559F,
+		0x557B, 0x557E, 0x5598, 0x559E, 0x55AE, 0x557C, 0x5583, 0x55A9, 0x5587, 0x55A8, 0x55DA, 0x55C5, 0x55DF, 0x55C4, 0x55DC, 0x55E4,
+		0x55D4, 0x5614, 0x55F7, 0x5616, 0x55FE, 0x55FD, 0x561B, 0x55F9, 0x564E, 0x5650, 0x71DF, 0x5634, 0x5636, 0x5632, 0x5638, 0x0000,
+		0x566B, 0x5664, 0x562F, 0x566C, 0x566A, 0x5686, 0x5680, 0x568A, 0x56A0, 0x5694, 0x568F, 0x56A5, 0x56AE, 0x56B6, 0x56B4, 0x56C2,
+		0x56BC, 0x56C1, 0x56C3, 0x56C0, 0x56C8, 0x56CE, 0x56D1, 0x56D3, 0x56D7, 0x56EE, 0x56F9, 0x5700, 0x56FF, 0x5704, 0x5709, 0x5708,
+		0x570B, 0x570D, 0x5713, 0x5718, 0x5716, 0x55C7, 0x571C, 0x5726, 0x5737, 0x5738, 0x574E, 0x573B, 0x5740, 0x574F, 0x5769, 0x57C0,
+		0x5788, 0x5761, 0x577F, 0x5789, 0x5793, 0x57A0, 0x57B3, 0x57A4, 0x57AA, 0x57B0, 0x57C3, 0x57C6, 0x57D4, 0x57D2, 0x57D3, 0x580A,
+		0x57D6, 0x57E3, 0x580B, 0x5819, 0x581D, 0x5872, 0x5821, 0x5862, 0x584B, 0x5870, 0x6BC0, 0x5852, 0x583D, 0x5879, 0x5885, 0x58B9,
+		0x589F, 0x58AB, 0x58BA, 0x58DE, 0x58BB, 0x58B8, 0x58AE, 0x58C5, 0x58D3, 0x58D1, 0x58D7, 0x58D9, 0x58D8, 0x58E5, 0x58DC, 0x58E4,
+		0x58DF, 0x58EF, 0x58FA, 0x58F9, 0x58FB, 0x58FC, 0x58FD, 0x5902, 0x590A, 0x5910, 0x591B, 0x68A6, 0x5925, 0x592C, 0x592D, 0x5932,
+		0x5938, 0x593E, 0x7AD2, 0x5955, 0x5950, 0x594E, 0x595A, 0x5958, 0x5962, 0x5960, 0x5967, 0x596C, 0x5969,
+	},
+	{
+		0x5978, 0x5981, 0x599D, 0x4F5E, 0x4FAB, 0x59A3, 0x59B2, 0x59C6, 0x59E8, 0x59DC, 0x598D, 0x59D9, 0x59DA, 0x5A25, 0x5A1F, 0x5A11,
+		0x5A1C, 0x5A09, 0x5A1A, 0x5A40, 0x5A6C, 0x5A49, 0x5A35, 0x5A36, 0x5A62, 0x5A6A, 0x5A9A, 0x5ABC, 0x5ABE, 0x5ACB, 0x5AC2, 0x5ABD,
+		0x5AE3, 0x5AD7, 0x5AE6, 0x5AE9, 0x5AD6, 0x5AFA, 0x5AFB, 0x5B0C, 0x5B0B, 0x5B16, 0x5B32, 0x5AD0, 0x5B2A, 0x5B36, 0x5B3E, 0x5B43,
+		0x5B45, 0x5B40, 0x5B51, 0x5B55, 0x5B5A, 0x5B5B, 0x5B65, 0x5B69, 0x5B70, 0x5B73, 0x5B75, 0x5B78, 0x6588, 0x5B7A, 0x5B80, 0x0000,
+		0x5B83, 0x5BA6, 0x5BB8, 0x5BC3, 0x5BC7, 0x5BC9, 0x5BD4, 0x5BD0, 0x5BE4, 0x5BE6, 0x5BE2, 0x5BDE, 0x5BE5, 0x5BEB, 0x5BF0, 0x5BF6,
+		0x5BF3, 0x5C05, 0x5C07, 0x5C08, 0x5C0D, 0x5C13, 0x5C20, 0x5C22, 0x5C28, 0x5C38, 0x5C39, 0x5C41, 0x5C46, 0x5C4E, 0x5C53, 0x5C50,
+		0x5C4F, 0x5B71, 0x5C6C, 0x5C6E, 0x4E62, 0x5C76, 0x5C79, 0x5C8C, 0x5C91, 0x5C94, 0x599B, 0x5CAB, 0x5CBB, 0x5CB6, 0x5CBC, 0x5CB7,
+		0x5CC5, 0x5CBE, 0x5CC7, 0x5CD9, 0x5CE9, 0x5CFD, 0x5CFA, 0x5CED, 0x5D8C, 0x5CEA, 0x5D0B, 0x5D15, 0x5D17, 0x5D5C, 0x5D1F, 0x5D1B,
+		0x5D11, 0x5D14, 0x5D22, 0x5D1A, 0x5D19, 0x5D18, 0x5D4C, 0x5D52, 0x5D4E, 0x5D4B, 0x5D6C, 0x5D73, 0x5D76, 0x5D87, 0x5D84, 0x5D82,
+		0x5DA2, 0x5D9D, 0x5DAC, 0x5DAE, 0x5DBD, 0x5D90, 0x5DB7, 0x5DBC, 0x5DC9, 0x5DCD, 0x5DD3, 0x5DD2, 0x5DD6, 0x5DDB, 0x5DEB, 0x5DF2,
+		0x5DF5, 0x5E0B, 0x5E1A, 0x5E19, 0x5E11, 0x5E1B, 0x5E36, 0x5E37, 0x5E44, 0x5E43, 0x5E40, 0x5E4E, 0x5E57, 0x5E54, 0x5E5F, 0x5E62,
+		0x5E64, 0x5E47, 0x5E75, 0x5E76, 0x5E7A, 0x9EBC, 0x5E7F, 0x5EA0, 0x5EC1, 0x5EC2, 0x5EC8, 0x5ED0, 0x5ECF,
+	},
+	{
+		0x5ED6, 0x5EE3, 0x5EDD, 0x5EDA, 0x5EDB, 0x5EE2, 0x5EE1, 0x5EE8, 0x5EE9, 0x5EEC, 0x5EF1, 0x5EF3, 0x5EF0, 0x5EF4, 0x5EF8, 0x5EFE,
+		0x5F03, 0x5F09, 0x5F5D, 0x5F5C, 0x5F0B, 0x5F11, 0x5F16, 0x5F29, 0x5F2D, 0x5F38, 0x5F41, 0x5F48, 0x5F4C, 0x5F4E, 0x5F2F, 0x5F51,
+		0x5F56, 0x5F57, 0x5F59, 0x5F61, 0x5F6D, 0x5F73, 0x5F77, 0x5F83, 0x5F82, 0x5F7F, 0x5F8A, 0x5F88, 0x5F91, 0x5F87, 0x5F9E, 0x5F99,
+		0x5F98, 0x5FA0, 0x5FA8, 0x5FAD, 0x5FBC, 0x5FD6, 0x5FFB, 0x5FE4, 0x5FF8, 0x5FF1, 0x5FDD, 0x60B3, 0x5FFF, 0x6021, 0x6060, 0x0000,
+		0x6019, 0x6010, 0x6029, 0x600E, 0x6031, 0x601B, 0x6015, 0x602B, 0x6026, 0x600F, 0x603A, 0x605A, 0x6041, 0x606A, 0x6077, 0x605F,
+		0x604A, 0x6046, 0x604D, 0x6063, 0x6043, 0x6064, 0x6042, 0x606C, 0x606B, 0x6059, 0x6081, 0x608D, 0x60E7, 0x6083, 0x609A, 0x6084,
+		0x609B, 0x6096, 0x6097, 0x6092, 0x60A7, 0x608B, 0x60E1, 0x60B8, 0x60E0, 0x60D3, 0x60B4, 0x5FF0, 0x60BD, 0x60C6, 0x60B5, 0x60D8,
+		0x614D, 0x6115, 0x6106, 0x60F6, 0x60F7, 0x6100, 0x60F4, 0x60FA, 0x6103, 0x6121, 0x60FB, 0x60F1, 0x610D, 0x610E, 0x6147, 0x613E,
+		0x6128, 0x6127, 0x614A, 0x613F, 0x613C, 0x612C, 0x6134, 0x613D, 0x6142, 0x6144, 0x6173, 0x6177, 0x6158, 0x6159, 0x615A, 0x616B,
+		0x6174, 0x616F, 0x6165, 0x6171, 0x615F, 0x615D, 0x6153, 0x6175, 0x6199, 0x6196, 0x6187, 0x61AC, 0x6194, 0x619A, 0x618A, 0x6191,
+		0x61AB, 0x61AE, 0x61CC, 0x61CA, 0x61C9, 0x61F7, 0x61C8, 0x61C3, 0x61C6, 0x61BA, 0x61CB, 0x7F79, 0x61CD, 0x61E6, 0x61E3, 0x61F6,
+		0x61FA, 0x61F4, 0x61FF, 0x61FD, 0x61FC, 0x61FE, 0x6200, 0x6208, 0x6209, 0x620D, 0x620C, 0x6214, 0x621B,
+	},
+	{
+		0x621E, 0x6221, 0x622A, 0x622E, 0x6230, 0x6232, 0x6233, 0x6241, 0x624E, 0x625E, 0x6263, 0x625B, 0x6260, 0x6268, 0x627C, 0x6282,
+		0x6289, 0x627E, 0x6292, 0x6293, 0x6296, 0x62D4, 0x6283, 0x6294, 0x62D7, 0x62D1, 0x62BB, 0x62CF, 0x62FF, 0x62C6, 0x64D4, 0x62C8,
+		0x62DC, 0x62CC, 0x62CA, 0x62C2, 0x62C7, 0x629B, 0x62C9, 0x630C, 0x62EE, 0x62F1, 0x6327, 0x6302, 0x6308, 0x62EF, 0x62F5, 0x6350,
+		0x633E, 0x634D, 0x641C, 0x634F, 0x6396, 0x638E, 0x6380, 0x63AB, 0x6376, 0x63A3, 0x638F, 0x6389, 0x639F, 0x63B5, 0x636B, 0x0000,
+		0x6369, 0x63BE, 0x63E9, 0x63C0, 0x63C6, 0x63E3, 0x63C9, 0x63D2, 0x63F6, 0x63C4, 0x6416, 0x6434, 0x6406, 0x6413, 0x6426, 0x6436,
+		0x651D, 0x6417, 0x6428, 0x640F, 0x6467, 0x646F, 0x6476, 0x644E, 0x652A, 0x6495, 0x6493, 0x64A5, 0x64A9, 0x6488, 0x64BC, 0x64DA,
+		0x64D2, 0x64C5, 0x64C7, 0x64BB, 0x64D8, 0x64C2, 0x64F1, 0x64E7, 0x8209, 0x64E0, 0x64E1, 0x62AC, 0x64E3, 0x64EF, 0x652C, 0x64F6,
+		0x64F4, 0x64F2, 0x64FA, 0x6500, 0x64FD, 0x6518, 0x651C, 0x6505, 0x6524, 0x6523, 0x652B, 0x6534, 0x6535, 0x6537, 0x6536, 0x6538,
+		0x754B, 0x6548, 0x6556, 0x6555, 0x654D, 0x6558, 0x655E, 0x655D, 0x6572, 0x6578, 0x6582, 0x6583, 0x8B8A, 0x659B, 0x659F, 0x65AB,
+		0x65B7, 0x65C3, 0x65C6, 0x65C1, 0x65C4, 0x65CC, 0x65D2, 0x65DB, 0x65D9, 0x65E0, 0x65E1, 0x65F1, 0x6772, 0x660A, 0x6603, 0x65FB,
+		0x6773, 0x6635, 0x6636, 0x6634, 0x661C, 0x664F, 0x6644, 0x6649, 0x6641, 0x665E, 0x665D, 0x6664, 0x6667, 0x6668, 0x665F, 0x6662,
+		0x6670, 0x6683, 0x6688, 0x668E, 0x6689, 0x6684, 0x6698, 0x669D, 0x66C1, 0x66B9, 0x66C9, 0x66BE, 0x66BC,
+	},
+	{
+		0x66C4, 0x66B8, 0x66D6, 0x66DA, 0x66E0, 0x663F, 0x66E6, 0x66E9, 0x66F0, 0x66F5, 0x66F7, 0x670F, 0x6716, 0x671E, 0x6726, 0x6727,
+		0x9738, 0x672E, 0x673F, 0x6736, 0x6741, 0x6738, 0x6737, 0x6746, 0x675E, 0x6760, 0x6759, 0x6763, 0x6764, 0x6789, 0x6770, 0x67A9,
+		0x677C, 0x676A, 0x678C, 0x678B, 0x67A6, 0x67A1, 0x6785, 0x67B7, 0x67EF, 0x67B4, 0x67EC, 0x67B3, 0x67E9, 0x67B8, 0x67E4, 0x67DE,
+		0x67DD, 0x67E2, 0x67EE, 0x67B9, 0x67CE, 0x67C6, 0x67E7, 0x6A9C, 0x681E, 0x6846, 0x6829, 0x6840, 0x684D, 0x6832, 0x684E, 0x0000,
+		0x68B3, 0x682B, 0x6859, 0x6863, 0x6877, 0x687F, 0x689F, 0x688F, 0x68AD, 0x6894, 0x689D, 0x689B, 0x6883, 0x6AAE, 0x68B9, 0x6874,
+		0x68B5, 0x68A0, 0x68BA, 0x690F, 0x688D, 0x687E, 0x6901, 0x68CA, 0x6908, 0x68D8, 0x6922, 0x6926, 0x68E1, 0x690C, 0x68CD, 0x68D4,
+		0x68E7, 0x68D5, 0x6936, 0x6912, 0x6904, 0x68D7, 0x68E3, 0x6925, 0x68F9, 0x68E0, 0x68EF, 0x6928, 0x692A, 0x691A, 0x6923, 0x6921,
+		0x68C6, 0x6979, 0x6977, 0x695C, 0x6978, 0x696B, 0x6954, 0x697E, 0x696E, 0x6939, 0x6974, 0x693D, 0x6959, 0x6930, 0x6961, 0x695E,
+		0x695D, 0x6981, 0x696A, 0x69B2, 0x69AE, 0x69D0, 0x69BF, 0x69C1, 0x69D3, 0x69BE, 0x69CE, 0x5BE8, 0x69CA, 0x69DD, 0x69BB, 0x69C3,
+		0x69A7, 0x6A2E, 0x6991, 0x69A0, 0x699C, 0x6995, 0x69B4, 0x69DE, 0x69E8, 0x6A02, 0x6A1B, 0x69FF, 0x6B0A, 0x69F9, 0x69F2, 0x69E7,
+		0x6A05, 0x69B1, 0x6A1E, 0x69ED, 0x6A14, 0x69EB, 0x6A0A, 0x6A12, 0x6AC1, 0x6A23, 0x6A13, 0x6A44, 0x6A0C, 0x6A72, 0x6A36, 0x6A78,
+		0x6A47, 0x6A62, 0x6A59, 0x6A66, 0x6A48, 0x6A38, 0x6A22, 0x6A90, 0x6A8D, 0x6AA0, 0x6A84, 0x6AA2, 0x6AA3,
+	},
+	{
+		0x6A97, 0x8617, 0x6ABB, 0x6AC3, 0x6AC2, 0x6AB8, 0x6AB3, 0x6AAC, 0x6ADE, 0x6AD1, 0x6ADF, 0x6AAA, 0x6ADA, 0x6AEA, 0x6AFB, 0x6B05,
+		0x8616, 0x6AFA, 0x6B12, 0x6B16, 0x9B31, 0x6B1F, 0x6B38, 0x6B37, 0x76DC, 0x6B39, 0x98EE, 0x6B47, 0x6B43, 0x6B49, 0x6B50, 0x6B59,
+		0x6B54, 0x6B5B, 0x6B5F, 0x6B61, 0x6B78, 0x6B79, 0x6B7F, 0x6B80, 0x6B84, 0x6B83, 0x6B8D, 0x6B98, 0x6B95, 0x6B9E, 0x6BA4, 0x6BAA,
+		0x6BAB, 0x6BAF, 0x6BB2, 0x6BB1, 0x6BB3, 0x6BB7, 0x6BBC, 0x6BC6, 0x6BCB, 0x6BD3, 0x6BDF, 0x6BEC, 0x6BEB, 0x6BF3, 0x6BEF, 0x0000,
+		0x9EBE, 0x6C08, 0x6C13, 0x6C14, 0x6C1B, 0x6C24, 0x6C23, 0x6C5E, 0x6C55, 0x6C62, 0x6C6A, 0x6C82, 0x6C8D, 0x6C9A, 0x6C81, 0x6C9B,
+		0x6C7E, 0x6C68, 0x6C73, 0x6C92, 0x6C90, 0x6CC4, 0x6CF1, 0x6CD3, 0x6CBD, 0x6CD7, 0x6CC5, 0x6CDD, 0x6CAE, 0x6CB1, 0x6CBE, 0x6CBA,
+		0x6CDB, 0x6CEF, 0x6CD9, 0x6CEA, 0x6D1F, 0x884D, 0x6D36, 0x6D2B, 0x6D3D, 0x6D38, 0x6D19, 0x6D35, 0x6D33, 0x6D12, 0x6D0C, 0x6D63,
+		0x6D93, 0x6D64, 0x6D5A, 0x6D79, 0x6D59, 0x6D8E, 0x6D95, 0x6FE4, 0x6D85, 0x6DF9, 0x6E15, 0x6E0A, 0x6DB5, 0x6DC7, 0x6DE6, 0x6DB8,
+		0x6DC6, 0x6DEC, 0x6DDE, 0x6DCC, 0x6DE8, 0x6DD2, 0x6DC5, 0x6DFA, 0x6DD9, 0x6DE4, 0x6DD5, 0x6DEA, 0x6DEE, 0x6E2D, 0x6E6E, 0x6E2E,
+		0x6E19, 0x6E72, 0x6E5F, 0x6E3E, 0x6E23, 0x6E6B, 0x6E2B, 0x6E76, 0x6E4D, 0x6E1F, 0x6E43, 0x6E3A, 0x6E4E, 0x6E24, 0x6EFF, 0x6E1D,
+		0x6E38, 0x6E82, 0x6EAA, 0x6E98, 0x6EC9, 0x6EB7, 0x6ED3, 0x6EBD, 0x6EAF, 0x6EC4, 0x6EB2, 0x6ED4, 0x6ED5, 0x6E8F, 0x6EA5, 0x6EC2,
+		0x6E9F, 0x6F41, 0x6F11, 0x704C, 0x6EEC, 0x6EF8, 0x6EFE, 0x6F3F, 0x6EF2, 0x6F31, 0x6EEF, 0x6F32, 0x6ECC,
+	},
+	{
+		0x6F3E, 0x6F13, 0x6EF7, 0x6F86, 0x6F7A, 0x6F78, 0x6F81, 0x6F80, 0x6F6F, 0x6F5B, 0x6FF3, 0x6F6D, 0x6F82, 0x6F7C, 0x6F58, 0x6F8E,
+		0x6F91, 0x6FC2, 0x6F66, 0x6FB3, 0x6FA3, 0x6FA1, 0x6FA4, 0x6FB9, 0x6FC6, 0x6FAA, 0x6FDF, 0x6FD5, 0x6FEC, 0x6FD4, 0x6FD8, 0x6FF1,
+		0x6FEE, 0x6FDB, 0x7009, 0x700B, 0x6FFA, 0x7011, 0x7001, 0x700F, 0x6FFE, 0x701B, 0x701A, 0x6F74, 0x701D, 0x7018, 0x701F, 0x7030,
+		0x703E, 0x7032, 0x7051, 0x7063, 0x7099, 0x7092, 0x70AF, 0x70F1, 0x70AC, 0x70B8, 0x70B3, 0x70AE, 0x70DF, 0x70CB, 0x70DD, 0x0000,
+		0x70D9, 0x7109, 0x70FD, 0x711C, 0x7119, 0x7165, 0x7155, 0x7188, 0x7166, 0x7162, 0x714C, 0x7156, 0x716C, 0x718F, 0x71FB, 0x7184,
+		0x7195, 0x71A8, 0x71AC, 0x71D7, 0x71B9, 0x71BE, 0x71D2, 0x71C9, 0x71D4, 0x71CE, 0x71E0, 0x71EC, 0x71E7, 0x71F5, 0x71FC, 0x71F9,
+		0x71FF, 0x720D, 0x7210, 0x721B, 0x7228, 0x722D, 0x722C, 0x7230, 0x7232, 0x723B, 0x723C, 0x723F, 0x7240, 0x7246, 0x724B, 0x7258,
+		0x7274, 0x727E, 0x7282, 0x7281, 0x7287, 0x7292, 0x7296, 0x72A2, 0x72A7, 0x72B9, 0x72B2, 0x72C3, 0x72C6, 0x72C4, 0x72CE, 0x72D2,
+		0x72E2, 0x72E0, 0x72E1, 0x72F9, 0x72F7, 0x500F, 0x7317, 0x730A, 0x731C, 0x7316, 0x731D, 0x7334, 0x732F, 0x7329, 0x7325, 0x733E,
+		0x734E, 0x734F, 0x9ED8, 0x7357, 0x736A, 0x7368, 0x7370, 0x7378, 0x7375, 0x737B, 0x737A, 0x73C8, 0x73B3, 0x73CE, 0x73BB, 0x73C0,
+		0x73E5, 0x73EE, 0x73DE, 0x74A2, 0x7405, 0x746F, 0x7425, 0x73F8, 0x7432, 0x743A, 0x7455, 0x743F, 0x745F, 0x7459, 0x7441, 0x745C,
+		0x7469, 0x7470, 0x7463, 0x746A, 0x7476, 0x747E, 0x748B, 0x749E, 0x74A7, 0x74CA, 0x74CF, 0x74D4, 0x73F1,
+	},
+	{
+		0x74E0, 0x74E3, 0x74E7, 0x74E9, 0x74EE, 0x74F2, 0x74F0, 0x74F1, 0x74F8, 0x74F7, 0x7504, 0x7503, 0x7505, 0x750C, 0x750E, 0x750D,
+		0x7515, 0x7513, 0x751E, 0x7526, 0x752C, 0x753C, 0x7544, 0x754D, 0x754A, 0x7549, 0x755B, 0x7546, 0x755A, 0x7569, 0x7564, 0x7567,
+		0x756B, 0x756D, 0x7578, 0x7576, 0x7586, 0x7587, 0x7574, 0x758A, 0x7589, 0x7582, 0x7594, 0x759A, 0x759D, 0x75A5, 0x75A3, 0x75C2,
+		0x75B3, 0x75C3, 0x75B5, 0x75BD, 0x75B8, 0x75BC, 0x75B1, 0x75CD, 0x75CA, 0x75D2, 0x75D9, 0x75E3, 0x75DE, 0x75FE, 0x75FF, 0x0000,
+		0x75FC, 0x7601, 0x75F0, 0x75FA, 0x75F2, 0x75F3, 0x760B, 0x760D, 0x7609, 0x761F, 0x7627, 0x7620, 0x7621, 0x7622, 0x7624, 0x7634,
+		0x7630, 0x763B, 0x7647, 0x7648, 0x7646, 0x765C, 0x7658, 0x7661, 0x7662, 0x7668, 0x7669, 0x766A, 0x7667, 0x766C, 0x7670, 0x7672,
+		0x7676, 0x7678, 0x767C, 0x7680, 0x7683, 0x7688, 0x768B, 0x768E, 0x7696, 0x7693, 0x7699, 0x769A, 0x76B0, 0x76B4, 0x76B8, 0x76B9,
+		0x76BA, 0x76C2, 0x76CD, 0x76D6, 0x76D2, 0x76DE, 0x76E1, 0x76E5, 0x76E7, 0x76EA, 0x862F, 0x76FB, 0x7708, 0x7707, 0x7704, 0x7729,
+		0x7724, 0x771E, 0x7725, 0x7726, 0x771B, 0x7737, 0x7738, 0x7747, 0x775A, 0x7768, 0x776B, 0x775B, 0x7765, 0x777F, 0x777E, 0x7779,
+		0x778E, 0x778B, 0x7791, 0x77A0, 0x779E, 0x77B0, 0x77B6, 0x77B9, 0x77BF, 0x77BC, 0x77BD, 0x77BB, 0x77C7, 0x77CD, 0x77D7, 0x77DA,
+		0x77DC, 0x77E3, 0x77EE, 0x77FC, 0x780C, 0x7812, 0x7926, 0x7820, 0x792A, 0x7845, 0x788E, 0x7874, 0x7886, 0x787C, 0x789A, 0x788C,
+		0x78A3, 0x78B5, 0x78AA, 0x78AF, 0x78D1, 0x78C6, 0x78CB, 0x78D4, 0x78BE, 0x78BC, 0x78C5, 0x78CA, 0x78EC,
+	},
+	{
+		0x78E7, 0x78DA, 0x78FD, 0x78F4, 0x7907, 0x7912, 0x7911, 0x7919, 0x792C, 0x792B, 0x7940, 0x7960, 0x7957, 0x795F, 0x795A, 0x7955,
+		0x7953, 0x797A, 0x797F, 0x798A, 0x799D, 0x79A7, 0x9F4B, 0x79AA, 0x79AE, 0x79B3, 0x79B9, 0x79BA, 0x79C9, 0x79D5, 0x79E7, 0x79EC,
+		0x79E1, 0x79E3, 0x7A08, 0x7A0D, 0x7A18, 0x7A19, 0x7A20, 0x7A1F, 0x7980, 0x7A31, 0x7A3B, 0x7A3E, 0x7A37, 0x7A43, 0x7A57, 0x7A49,
+		0x7A61, 0x7A62, 0x7A69, 0x9F9D, 0x7A70, 0x7A79, 0x7A7D, 0x7A88, 0x7A97, 0x7A95, 0x7A98, 0x7A96, 0x7AA9, 0x7AC8, 0x7AB0, 0x0000,
+		0x7AB6, 0x7AC5, 0x7AC4, 0x7ABF, 0x9083, 0x7AC7, 0x7ACA, 0x7ACD, 0x7ACF, 0x7AD5, 0x7AD3, 0x7AD9, 0x7ADA, 0x7ADD, 0x7AE1, 0x7AE2,
+		0x7AE6, 0x7AED, 0x7AF0, 0x7B02, 0x7B0F, 0x7B0A, 0x7B06, 0x7B33, 0x7B18, 0x7B19, 0x7B1E, 0x7B35, 0x7B28, 0x7B36, 0x7B50, 0x7B7A,
+		0x7B04, 0x7B4D, 0x7B0B, 0x7B4C, 0x7B45, 0x7B75, 0x7B65, 0x7B74, 0x7B67, 0x7B70, 0x7B71, 0x7B6C, 0x7B6E, 0x7B9D, 0x7B98, 0x7B9F,
+		0x7B8D, 0x7B9C, 0x7B9A, 0x7B8B, 0x7B92, 0x7B8F, 0x7B5D, 0x7B99, 0x7BCB, 0x7BC1, 0x7BCC, 0x7BCF, 0x7BB4, 0x7BC6, 0x7BDD, 0x7BE9,
+		0x7C11, 0x7C14, 0x7BE6, 0x7BE5, 0x7C60, 0x7C00, 0x7C07, 0x7C13, 0x7BF3, 0x7BF7, 0x7C17, 0x7C0D, 0x7BF6, 0x7C23, 0x7C27, 0x7C2A,
+		0x7C1F, 0x7C37, 0x7C2B, 0x7C3D, 0x7C4C, 0x7C43, 0x7C54, 0x7C4F, 0x7C40, 0x7C50, 0x7C58, 0x7C5F, 0x7C64, 0x7C56, 0x7C65, 0x7C6C,
+		0x7C75, 0x7C83, 0x7C90, 0x7CA4, 0x7CAD, 0x7CA2, 0x7CAB, 0x7CA1, 0x7CA8, 0x7CB3, 0x7CB2, 0x7CB1, 0x7CAE, 0x7CB9, 0x7CBD, 0x7CC0,
+		0x7CC5, 0x7CC2, 0x7CD8, 0x7CD2, 0x7CDC, 0x7CE2, 0x9B3B, 0x7CEF, 0x7CF2, 0x7CF4, 0x7CF6, 0x7CFA, 0x7D06,
+	},
+	{
+		0x7D02, 0x7D1C, 0x7D15, 0x7D0A, 0x7D45, 0x7D4B, 0x7D2E, 0x7D32, 0x7D3F, 0x7D35, 0x7D46, 0x7D73, 0x7D56, 0x7D4E, 0x7D72, 0x7D68,
+		0x7D6E, 0x7D4F, 0x7D63, 0x7D93, 0x7D89, 0x7D5B, 0x7D8F, 0x7D7D, 0x7D9B, 0x7DBA, 0x7DAE, 0x7DA3, 0x7DB5, 0x7DC7, 0x7DBD, 0x7DAB,
+		0x7E3D, 0x7DA2, 0x7DAF, 0x7DDC, 0x7DB8, 0x7D9F, 0x7DB0, 0x7DD8, 0x7DDD, 0x7DE4, 0x7DDE, 0x7DFB, 0x7DF2, 0x7DE1, 0x7E05, 0x7E0A,
+		0x7E23, 0x7E21, 0x7E12, 0x7E31, 0x7E1F, 0x7E09, 0x7E0B, 0x7E22, 0x7E46, 0x7E66, 0x7E3B, 0x7E35, 0x7E39, 0x7E43, 0x7E37, 0x0000,
+		0x7E32, 0x7E3A, 0x7E67, 0x7E5D, 0x7E56, 0x7E5E, 0x7E59, 0x7E5A, 0x7E79, 0x7E6A, 0x7E69, 0x7E7C, 0x7E7B, 0x7E83, 0x7DD5, 0x7E7D,
+		0x8FAE, 0x7E7F, 0x7E88, 0x7E89, 0x7E8C, 0x7E92, 0x7E90, 0x7E93, 0x7E94, 0x7E96, 0x7E8E, 0x7E9B, 0x7E9C, 0x7F38, 0x7F3A, 0x7F45,
+		0x7F4C, 0x7F4D, 0x7F4E, 0x7F50, 0x7F51, 0x7F55, 0x7F54, 0x7F58, 0x7F5F, 0x7F60, 0x7F68, 0x7F69, 0x7F67, 0x7F78, 0x7F82, 0x7F86,
+		0x7F83, 0x7F88, 0x7F87, 0x7F8C, 0x7F94, 0x7F9E, 0x7F9D, 0x7F9A, 0x7FA3, 0x7FAF, 0x7FB2, 0x7FB9, 0x7FAE, 0x7FB6, 0x7FB8, 0x8B71,
+		0x7FC5, 0x7FC6, 0x7FCA, 0x7FD5, 0x7FD4, 0x7FE1, 0x7FE6, 0x7FE9, 0x7FF3, 0x7FF9, 0x98DC, 0x8006, 0x8004, 0x800B, 0x8012, 0x8018,
+		0x8019, 0x801C, 0x8021, 0x8028, 0x803F, 0x803B, 0x804A, 0x8046, 0x8052, 0x8058, 0x805A, 0x805F, 0x8062, 0x8068, 0x8073, 0x8072,
+		0x8070, 0x8076, 0x8079, 0x807D, 0x807F, 0x8084, 0x8086, 0x8085, 0x809B, 0x8093, 0x809A, 0x80AD, 0x5190, 0x80AC, 0x80DB, 0x80E5,
+		0x80D9, 0x80DD, 0x80C4, 0x80DA, 0x80D6, 0x8109, 0x80EF, 0x80F1, 0x811B, 0x8129, 0x8123, 0x812F, 0x814B,
+	},
+	{
+		0x968B, 0x8146, 0x813E, 0x8153, 0x8151, 0x80FC, 0x8171, 0x816E, 0x8165, 0x8166, 0x8174, 0x8183, 0x8188, 0x818A, 0x8180, 0x8182,
+		0x81A0, 0x8195, 0x81A4, 0x81A3, 0x815F, 0x8193, 0x81A9, 0x81B0, 0x81B5, 0x81BE, 0x81B8, 0x81BD, 0x81C0, 0x81C2, 0x81BA, 0x81C9,
+		0x81CD, 0x81D1, 0x81D9, 0x81D8, 0x81C8, 0x81DA, 0x81DF, 0x81E0, 0x81E7, 0x81FA, 0x81FB, 0x81FE, 0x8201, 0x8202, 0x8205, 0x8207,
+		0x820A, 0x820D, 0x8210, 0x8216, 0x8229, 0x822B, 0x8238, 0x8233, 0x8240, 0x8259, 0x8258, 0x825D, 0x825A, 0x825F, 0x8264, 0x0000,
+		0x8262, 0x8268, 0x826A, 0x826B, 0x822E, 0x8271, 0x8277, 0x8278, 0x827E, 0x828D, 0x8292, 0x82AB, 0x829F, 0x82BB, 0x82AC, 0x82E1,
+		0x82E3, 0x82DF, 0x82D2, 0x82F4, 0x82F3, 0x82FA, 0x8393, 0x8303, 0x82FB, 0x82F9, 0x82DE, 0x8306, 0x82DC, 0x8309, 0x82D9, 0x8335,
+		0x8334, 0x8316, 0x8332, 0x8331, 0x8340, 0x8339, 0x8350, 0x8345, 0x832F, 0x832B, 0x8317, 0x8318, 0x8385, 0x839A, 0x83AA, 0x839F,
+		0x83A2, 0x8396, 0x8323, 0x838E, 0x8387, 0x838A, 0x837C, 0x83B5, 0x8373, 0x8375, 0x83A0, 0x8389, 0x83A8, 0x83F4, 0x8413, 0x83EB,
+		0x83CE, 0x83FD, 0x8403, 0x83D8, 0x840B, 0x83C1, 0x83F7, 0x8407, 0x83E0, 0x83F2, 0x840D, 0x8422, 0x8420, 0x83BD, 0x8438, 0x8506,
+		0x83FB, 0x846D, 0x842A, 0x843C, 0x855A, 0x8484, 0x8477, 0x846B, 0x84AD, 0x846E, 0x8482, 0x8469, 0x8446, 0x842C, 0x846F, 0x8479,
+		0x8435, 0x84CA, 0x8462, 0x84B9, 0x84BF, 0x849F, 0x84D9, 0x84CD, 0x84BB, 0x84DA, 0x84D0, 0x84C1, 0x84C6, 0x84D6, 0x84A1, 0x8521,
+		0x84FF, 0x84F4, 0x8517, 0x8518, 0x852C, 0x851F, 0x8515, 0x8514, 0x84FC, 0x8540, 0x8563, 0x8558, 0x8548,
+	},
+	{
+		0x8541, 0x8602, 0x854B, 0x8555, 0x8580, 0x85A4, 0x8588, 0x8591, 0x858A, 0x85A8, 0x856D, 0x8594, 0x859B, 0x85EA, 0x8587, 0x859C,
+		0x8577, 0x857E, 0x8590, 0x85C9, 0x85BA, 0x85CF, 0x85B9, 0x85D0, 0x85D5, 0x85DD, 0x85E5, 0x85DC, 0x85F9, 0x860A, 0x8613, 0x860B,
+		0x85FE, 0x85FA, 0x8606, 0x8622, 0x861A, 0x8630, 0x863F, 0x864D, 0x4E55, 0x8654, 0x865F, 0x8667, 0x8671, 0x8693, 0x86A3, 0x86A9,
+		0x86AA, 0x868B, 0x868C, 0x86B6, 0x86AF, 0x86C4, 0x86C6, 0x86B0, 0x86C9, 0x8823, 0x86AB, 0x86D4, 0x86DE, 0x86E9, 0x86EC, 0x0000,
+		0x86DF, 0x86DB, 0x86EF, 0x8712, 0x8706, 0x8708, 0x8700, 0x8703, 0x86FB, 0x8711, 0x8709, 0x870D, 0x86F9, 0x870A, 0x8734, 0x873F,
+		0x8737, 0x873B, 0x8725, 0x8729, 0x871A, 0x8760, 0x875F, 0x8778, 0x874C, 0x874E, 0x8774, 0x8757, 0x8768, 0x876E, 0x8759, 0x8753,
+		0x8763, 0x876A, 0x8805, 0x87A2, 0x879F, 0x8782, 0x87AF, 0x87CB, 0x87BD, 0x87C0, 0x87D0, 0x96D6, 0x87AB, 0x87C4, 0x87B3, 0x87C7,
+		0x87C6, 0x87BB, 0x87EF, 0x87F2, 0x87E0, 0x880F, 0x880D, 0x87FE, 0x87F6, 0x87F7, 0x880E, 0x87D2, 0x8811, 0x8816, 0x8815, 0x8822,
+		0x8821, 0x8831, 0x8836, 0x8839, 0x8827, 0x883B, 0x8844, 0x8842, 0x8852, 0x8859, 0x885E, 0x8862, 0x886B, 0x8881, 0x887E, 0x889E,
+		0x8875, 0x887D, 0x88B5, 0x8872, 0x8882, 0x8897, 0x8892, 0x88AE, 0x8899, 0x88A2, 0x888D, 0x88A4, 0x88B0, 0x88BF, 0x88B1, 0x88C3,
+		0x88C4, 0x88D4, 0x88D8, 0x88D9, 0x88DD, 0x88F9, 0x8902, 0x88FC, 0x88F4, 0x88E8, 0x88F2, 0x8904, 0x890C, 0x890A, 0x8913, 0x8943,
+		0x891E, 0x8925, 0x892A, 0x892B, 0x8941, 0x8944, 0x893B, 0x8936, 0x8938, 0x894C, 0x891D, 0x8960, 0x895E,
+	},
+	{
+		0x8966, 0x8964, 0x896D, 0x896A, 0x896F, 0x8974, 0x8977, 0x897E, 0x8983, 0x8988, 0x898A, 0x8993, 0x8998, 0x89A1, 0x89A9, 0x89A6,
+		0x89AC, 0x89AF, 0x89B2, 0x89BA, 0x89BD, 0x89BF, 0x89C0, 0x89DA, 0x89DC, 0x89DD, 0x89E7, 0x89F4, 0x89F8, 0x8A03, 0x8A16, 0x8A10,
+		0x8A0C, 0x8A1B, 0x8A1D, 0x8A25, 0x8A36, 0x8A41, 0x8A5B, 0x8A52, 0x8A46, 0x8A48, 0x8A7C, 0x8A6D, 0x8A6C, 0x8A62, 0x8A85, 0x8A82,
+		0x8A84, 0x8AA8, 0x8AA1, 0x8A91, 0x8AA5, 0x8AA6, 0x8A9A, 0x8AA3, 0x8AC4, 0x8ACD, 0x8AC2, 0x8ADA, 0x8AEB, 0x8AF3, 0x8AE7, 0x0000,
+		0x8AE4, 0x8AF1, 0x8B14, 0x8AE0, 0x8AE2, 0x8AF7, 0x8ADE, 0x8ADB, 0x8B0C, 0x8B07, 0x8B1A, 0x8AE1, 0x8B16, 0x8B10, 0x8B17, 0x8B20,
+		0x8B33, 0x97AB, 0x8B26, 0x8B2B, 0x8B3E, 0x8B28, 0x8B41, 0x8B4C, 0x8B4F, 0x8B4E, 0x8B49, 0x8B56, 0x8B5B, 0x8B5A, 0x8B6B, 0x8B5F,
+		0x8B6C, 0x8B6F, 0x8B74, 0x8B7D, 0x8B80, 0x8B8C, 0x8B8E, 0x8B92, 0x8B93, 0x8B96, 0x8B99, 0x8B9A, 0x8C3A, 0x8C41, 0x8C3F, 0x8C48,
+		0x8C4C, 0x8C4E, 0x8C50, 0x8C55, 0x8C62, 0x8C6C, 0x8C78, 0x8C7A, 0x8C82, 0x8C89, 0x8C85, 0x8C8A, 0x8C8D, 0x8C8E, 0x8C94, 0x8C7C,
+		0x8C98, 0x621D, 0x8CAD, 0x8CAA, 0x8CBD, 0x8CB2, 0x8CB3, 0x8CAE, 0x8CB6, 0x8CC8, 0x8CC1, 0x8CE4, 0x8CE3, 0x8CDA, 0x8CFD, 0x8CFA,
+		0x8CFB, 0x8D04, 0x8D05, 0x8D0A, 0x8D07, 0x8D0F, 0x8D0D, 0x8D10, 0x9F4E, 0x8D13, 0x8CCD, 0x8D14, 0x8D16, 0x8D67, 0x8D6D, 0x8D71,
+		0x8D73, 0x8D81, 0x8D99, 0x8DC2, 0x8DBE, 0x8DBA, 0x8DCF, 0x8DDA, 0x8DD6, 0x8DCC, 0x8DDB, 0x8DCB, 0x8DEA, 0x8DEB, 0x8DDF, 0x8DE3,
+		0x8DFC, 0x8E08, 0x8E09, 0x8DFF, 0x8E1D, 0x8E1E, 0x8E10, 0x8E1F, 0x8E42, 0x8E35, 0x8E30, 0x8E34, 0x8E4A,
+	},
+	{
+		0x8E47, 0x8E49, 0x8E4C, 0x8E50, 0x8E48, 0x8E59, 0x8E64, 0x8E60, 0x8E2A, 0x8E63, 0x8E55, 0x8E76, 0x8E72, 0x8E7C, 0x8E81, 0x8E87,
+		0x8E85, 0x8E84, 0x8E8B, 0x8E8A, 0x8E93, 0x8E91, 0x8E94, 0x8E99, 0x8EAA, 0x8EA1, 0x8EAC, 0x8EB0, 0x8EC6, 0x8EB1, 0x8EBE, 0x8EC5,
+		0x8EC8, 0x8ECB, 0x8EDB, 0x8EE3, 0x8EFC, 0x8EFB, 0x8EEB, 0x8EFE, 0x8F0A, 0x8F05, 0x8F15, 0x8F12, 0x8F19, 0x8F13, 0x8F1C, 0x8F1F,
+		0x8F1B, 0x8F0C, 0x8F26, 0x8F33, 0x8F3B, 0x8F39, 0x8F45, 0x8F42, 0x8F3E, 0x8F4C, 0x8F49, 0x8F46, 0x8F4E, 0x8F57, 0x8F5C, 0x0000,
+		0x8F62, 0x8F63, 0x8F64, 0x8F9C, 0x8F9F, 0x8FA3, 0x8FAD, 0x8FAF, 0x8FB7, 0x8FDA, 0x8FE5, 0x8FE2, 0x8FEA, 0x8FEF, 0x9087, 0x8FF4,
+		0x9005, 0x8FF9, 0x8FFA, 0x9011, 0x9015, 0x9021, 0x900D, 0x901E, 0x9016, 0x900B, 0x9027, 0x9036, 0x9035, 0x9039, 0x8FF8, 0x904F,
+		0x9050, 0x9051, 0x9052, 0x900E, 0x9049, 0x903E, 0x9056, 0x9058, 0x905E, 0x9068, 0x906F, 0x9076, 0x96A8, 0x9072, 0x9082, 0x907D,
+		0x9081, 0x9080, 0x908A, 0x9089, 0x908F, 0x90A8, 0x90AF, 0x90B1, 0x90B5, 0x90E2, 0x90E4, 0x6248, 0x90DB, 0x9102, 0x9112, 0x9119,
+		0x9132, 0x9130, 0x914A, 0x9156, 0x9158, 0x9163, 0x9165, 0x9169, 0x9173, 0x9172, 0x918B, 0x9189, 0x9182, 0x91A2, 0x91AB, 0x91AF,
+		0x91AA, 0x91B5, 0x91B4, 0x91BA, 0x91C0, 0x91C1, 0x91C9, 0x91CB, 0x91D0, 0x91D6, 0x91DF, 0x91E1, 0x91DB, 0x91FC, 0x91F5, 0x91F6,
+		0x921E, 0x91FF, 0x9214, 0x922C, 0x9215, 0x9211, 0x925E, 0x9257, 0x9245, 0x9249, 0x9264, 0x9248, 0x9295, 0x923F, 0x924B, 0x9250,
+		0x929C, 0x9296, 0x9293, 0x929B, 0x925A, 0x92CF, 0x92B9, 0x92B7, 0x92E9, 0x930F, 0x92FA, 0x9344, 0x932E,
+	},
+	{
+		0x9319, 0x9322, 0x931A, 0x9323, 0x933A, 0x9335, 0x933B, 0x935C, 0x9360, 0x937C, 0x936E, 0x9356, 0x93B0, 0x93AC, 0x93AD, 0x9394,
+		0x93B9, 0x93D6, 0x93D7, 0x93E8, 0x93E5, 0x93D8, 0x93C3, 0x93DD, 0x93D0, 0x93C8, 0x93E4, 0x941A, 0x9414, 0x9413, 0x9403, 0x9407,
+		0x9410, 0x9436, 0x942B, 0x9435, 0x9421, 0x943A, 0x9441, 0x9452, 0x9444, 0x945B, 0x9460, 0x9462, 0x945E, 0x946A, 0x9229, 0x9470,
+		0x9475, 0x9477, 0x947D, 0x945A, 0x947C, 0x947E, 0x9481, 0x947F, 0x9582, 0x9587, 0x958A, 0x9594, 0x9596, 0x9598, 0x9599, 0x0000,
+		0x95A0, 0x95A8, 0x95A7, 0x95AD, 0x95BC, 0x95BB, 0x95B9, 0x95BE, 0x95CA, 0x6FF6, 0x95C3, 0x95CD, 0x95CC, 0x95D5, 0x95D4, 0x95D6,
+		0x95DC, 0x95E1, 0x95E5, 0x95E2, 0x9621, 0x9628, 0x962E, 0x962F, 0x9642, 0x964C, 0x964F, 0x964B, 0x9677, 0x965C, 0x965E, 0x965D,
+		0x965F, 0x9666, 0x9672, 0x966C, 0x968D, 0x9698, 0x9695, 0x9697, 0x96AA, 0x96A7, 0x96B1, 0x96B2, 0x96B0, 0x96B4, 0x96B6, 0x96B8,
+		0x96B9, 0x96CE, 0x96CB, 0x96C9, 0x96CD, 0x894D, 0x96DC, 0x970D, 0x96D5, 0x96F9, 0x9704, 0x9706, 0x9708, 0x9713, 0x970E, 0x9711,
+		0x970F, 0x9716, 0x9719, 0x9724, 0x972A, 0x9730, 0x9739, 0x973D, 0x973E, 0x9744, 0x9746, 0x9748, 0x9742, 0x9749, 0x975C, 0x9760,
+		0x9764, 0x9766, 0x9768, 0x52D2, 0x976B, 0x9771, 0x9779, 0x9785, 0x977C, 0x9781, 0x977A, 0x9786, 0x978B, 0x978F, 0x9790, 0x979C,
+		0x97A8, 0x97A6, 0x97A3, 0x97B3, 0x97B4, 0x97C3, 0x97C6, 0x97C8, 0x97CB, 0x97DC, 0x97ED, 0x9F4F, 0x97F2, 0x7ADF, 0x97F6, 0x97F5,
+		0x980F, 0x980C, 0x9838, 0x9824, 0x9821, 0x9837, 0x983D, 0x9846, 0x984F, 0x984B, 0x986B, 0x986F, 0x9870,
+	},
+	{
+		0x9871, 0x9874, 0x9873, 0x98AA, 0x98AF, 0x98B1, 0x98B6, 0x98C4, 0x98C3, 0x98C6, 0x98E9, 0x98EB, 0x9903, 0x9909, 0x9912, 0x9914,
+		0x9918, 0x9921, 0x991D, 0x991E, 0x9924, 0x9920, 0x992C, 0x992E, 0x993D, 0x993E, 0x9942, 0x9949, 0x9945, 0x9950, 0x994B, 0x9951,
+		0x9952, 0x994C, 0x9955, 0x9997, 0x9998, 0x99A5, 0x99AD, 0x99AE, 0x99BC, 0x99DF, 0x99DB, 0x99DD, 0x99D8, 0x99D1, 0x99ED, 0x99EE,
+		0x99F1, 0x99F2, 0x99FB, 0x99F8, 0x9A01, 0x9A0F, 0x9A05, 0x99E2, 0x9A19, 0x9A2B, 0x9A37, 0x9A45, 0x9A42, 0x9A40, 0x9A43, 0x0000,
+		0x9A3E, 0x9A55, 0x9A4D, 0x9A5B, 0x9A57, 0x9A5F, 0x9A62, 0x9A65, 0x9A64, 0x9A69, 0x9A6B, 0x9A6A, 0x9AAD, 0x9AB0, 0x9ABC, 0x9AC0,
+		0x9ACF, 0x9AD1, 0x9AD3, 0x9AD4, 0x9ADE, 0x9ADF, 0x9AE2, 0x9AE3, 0x9AE6, 0x9AEF, 0x9AEB, 0x9AEE, 0x9AF4, 0x9AF1, 0x9AF7, 0x9AFB,
+		0x9B06, 0x9B18, 0x9B1A, 0x9B1F, 0x9B22, 0x9B23, 0x9B25, 0x9B27, 0x9B28, 0x9B29, 0x9B2A, 0x9B2E, 0x9B2F, 0x9B32, 0x9B44, 0x9B43,
+		0x9B4F, 0x9B4D, 0x9B4E, 0x9B51, 0x9B58, 0x9B74, 0x9B93, 0x9B83, 0x9B91, 0x9B96, 0x9B97, 0x9B9F, 0x9BA0, 0x9BA8, 0x9BB4, 0x9BC0,
+		0x9BCA, 0x9BB9, 0x9BC6, 0x9BCF, 0x9BD1, 0x9BD2, 0x9BE3, 0x9BE2, 0x9BE4, 0x9BD4, 0x9BE1, 0x9C3A, 0x9BF2, 0x9BF1, 0x9BF0, 0x9C15,
+		0x9C14, 0x9C09, 0x9C13, 0x9C0C, 0x9C06, 0x9C08, 0x9C12, 0x9C0A, 0x9C04, 0x9C2E, 0x9C1B, 0x9C25, 0x9C24, 0x9C21, 0x9C30, 0x9C47,
+		0x9C32, 0x9C46, 0x9C3E, 0x9C5A, 0x9C60, 0x9C67, 0x9C76, 0x9C78, 0x9CE7, 0x9CEC, 0x9CF0, 0x9D09, 0x9D08, 0x9CEB, 0x9D03, 0x9D06,
+		0x9D2A, 0x9D26, 0x9DAF, 0x9D23, 0x9D1F, 0x9D44, 0x9D15, 0x9D12, 0x9D41, 0x9D3F, 0x9D3E, 0x9D46, 0x9D48,
+	},
+	{
+		0x9D5D, 0x9D5E, 0x9D64, 0x9D51, 0x9D50, 0x9D59, 0x9D72, 0x9D89, 0x9D87, 0x9DAB, 0x9D6F, 0x9D7A, 0x9D9A, 0x9DA4, 0x9DA9, 0x9DB2,
+		0x9DC4, 0x9DC1, 0x9DBB, 0x9DB8, 0x9DBA, 0x9DC6, 0x9DCF, 0x9DC2, 0x9DD9, 0x9DD3, 0x9DF8, 0x9DE6, 0x9DED, 0x9DEF, 0x9DFD, 0x9E1A,
+		0x9E1B, 0x9E1E, 0x9E75, 0x9E79, 0x9E7D, 0x9E81, 0x9E88, 0x9E8B, 0x9E8C, 0x9E92, 0x9E95, 0x9E91, 0x9E9D, 0x9EA5, 0x9EA9, 0x9EB8,
+		0x9EAA, 0x9EAD, 0x9761, 0x9ECC, 0x9ECE, 0x9ECF, 0x9ED0, 0x9ED4, 0x9EDC, 0x9EDE, 0x9EDD, 0x9EE0, 0x9EE5, 0x9EE8, 0x9EEF, 0x0000,
+		0x9EF4, 0x9EF6, 0x9EF7, 0x9EF9, 0x9EFB, 0x9EFC, 0x9EFD, 0x9F07, 0x9F08, 0x76B7, 0x9F15, 0x9F21, 0x9F2C, 0x9F3E, 0x9F4A, 0x9F52,
+		0x9F54, 0x9F63, 0x9F5F, 0x9F60, 0x9F61, 0x9F66, 0x9F67, 0x9F6C, 0x9F6A, 0x9F77, 0x9F72, 0x9F76, 0x9F95, 0x9F9C, 0x9FA0, 0x582F,
+		0x69C7, 0x9059, 0x7464, 0x51DC, 0x7199, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{
+		0x7E8A, 0x891C, 0x9348, 0x9288, 0x84DC, 0x4FC9, 0x70BB, 0x6631, 0x68C8, 0x92F9, 0x66FB, 0x5F45, 0x4E28, 0x4EE1, 0x4EFC, 0x4F00,
+		0x4F03, 0x4F39, 0x4F56, 0x4F92, 0x4F8A, 0x4F9A, 0x4F94, 0x4FCD, 0x5040, 0x5022, 0x4FFF, 0x501E, 0x5046, 0x5070, 0x5042, 0x5094,
+		0x50F4, 0x50D8, 0x514A, 0x5164, 0x519D, 0x51BE, 0x51EC, 0x5215, 0x529C, 0x52A6, 0x52C0, 0x52DB, 0x5300, 0x5307, 0x5324, 0x5372,
+		0x5393, 0x53B2, 0x53DD, 0xFA0E, 0x549C, 0x548A, 0x54A9, 0x54FF, 0x5586, 0x5759, 0x5765, 0x57AC, 0x57C8, 0x57C7, 0xFA0F, 0x0000,
+		0xFA10, 0x589E, 0x58B2, 0x590B, 0x5953, 0x595B, 0x595D, 0x5963, 0x59A4, 0x59BA, 0x5B56, 0x5BC0, 0x752F, 0x5BD8, 0x5BEC, 0x5C1E,
+		0x5CA6, 0x5CBA, 0x5CF5, 0x5D27, 0x5D53, 0xFA11, 0x5D42, 0x5D6D, 0x5DB8, 0x5DB9, 0x5DD0, 0x5F21, 0x5F34, 0x5F67, 0x5FB7, 0x5FDE,
+		0x605D, 0x6085, 0x608A, 0x60DE, 0x60D5, 0x6120, 0x60F2, 0x6111, 0x6137, 0x6130, 0x6198, 0x6213, 0x62A6, 0x63F5, 0x6460, 0x649D,
+		0x64CE, 0x654E, 0x6600, 0x6615, 0x663B, 0x6609, 0x662E, 0x661E, 0x6624, 0x6665, 0x6657, 0x6659, 0xFA12, 0x6673, 0x6699, 0x66A0,
+		0x66B2, 0x66BF, 0x66FA, 0x670E, 0xF929, 0x6766, 0x67BB, 0x6852, 0x67C0, 0x6801, 0x6844, 0x68CF, 0xFA13, 0x6968, 0xFA14, 0x6998,
+		0x69E2, 0x6A30, 0x6A6B, 0x6A46, 0x6A73, 0x6A7E, 0x6AE2, 0x6AE4, 0x6BD6, 0x6C3F, 0x6C5C, 0x6C86, 0x6C6F, 0x6CDA, 0x6D04, 0x6D87,
+		0x6D6F, 0x6D96, 0x6DAC, 0x6DCF, 0x6DF8, 0x6DF2, 0x6DFC, 0x6E39, 0x6E5C, 0x6E27, 0x6E3C, 0x6EBF, 0x6F88, 0x6FB5, 0x6FF5, 0x7005,
+		0x7007, 0x7028, 0x7085, 0x70AB, 0x710F, 0x7104, 0x715C, 0x7146, 0x7147, 0xFA15, 0x71C1, 0x71FE, 0x72B1,
+	},
+	{
+		0x72BE, 0x7324, 0xFA16, 0x7377, 0x73BD, 0x73C9, 0x73D6, 0x73E3, 0x73D2, 0x7407, 0x73F5, 0x7426, 0x742A, 0x7429, 0x742E, 0x7462,
+		0x7489, 0x749F, 0x7501, 0x756F, 0x7682, 0x769C, 0x769E, 0x769B, 0x76A6, 0xFA17, 0x7746, 0x52AF, 0x7821, 0x784E, 0x7864, 0x787A,
+		0x7930, 0xFA18, 0xFA19, 0xFA1A, 0x7994, 0xFA1B, 0x799B, 0x7AD1, 0x7AE7, 0xFA1C, 0x7AEB, 0x7B9E, 0xFA1D, 0x7D48, 0x7D5C, 0x7DB7,
+		0x7DA0, 0x7DD6, 0x7E52, 0x7F47, 0x7FA1, 0xFA1E, 0x8301, 0x8362, 0x837F, 0x83C7, 0x83F6, 0x8448, 0x84B4, 0x8553, 0x8559, 0x0000,
+		0x856B, 0xFA1F, 0x85B0, 0xFA20, 0xFA21, 0x8807, 0x88F5, 0x8A12, 0x8A37, 0x8A79, 0x8AA7, 0x8ABE, 0x8ADF, 0xFA22, 0x8AF6, 0x8B53,
+		0x8B7F, 0x8CF0, 0x8CF4, 0x8D12, 0x8D76, 0xFA23, 0x8ECF, 0xFA24, 0xFA25, 0x9067, 0x90DE, 0xFA26, 0x9115, 0x9127, 0x91DA, 0x91D7,
+		0x91DE, 0x91ED, 0x91EE, 0x91E4, 0x91E5, 0x9206, 0x9210, 0x920A, 0x923A, 0x9240, 0x923C, 0x924E, 0x9259, 0x9251, 0x9239, 0x9267,
+		0x92A7, 0x9277, 0x9278, 0x92E7, 0x92D7, 0x92D9, 0x92D0, 0xFA27, 0x92D5, 0x92E0, 0x92D3, 0x9325, 0x9321, 0x92FB, 0xFA28, 0x931E,
+		0x92FF, 0x931D, 0x9302, 0x9370, 0x9357, 0x93A4, 0x93C6, 0x93DE, 0x93F8, 0x9431, 0x9445, 0x9448, 0x9592, 0xF9DC, 0xFA29, 0x969D,
+		0x96AF, 0x9733, 0x973B, 0x9743, 0x974D, 0x974F, 0x9751, 0x9755, 0x9857, 0x9865, 0xFA2A, 0xFA2B, 0x9927, 0xFA2C, 0x999E, 0x9A4E,
+		0x9AD9, 0x9ADC, 0x9B75, 0x9B72, 0x9B8F, 0x9BB1, 0x9BBB, 0x9C00, 0x9D70, 0x9D6B, 0xFA2D, 0x9E19, 0x9ED1, 0x0000, 0x0000, 0x2170,
+		0x2171, 0x2172, 0x2173, 0x2174, 0x2175, 0x2176, 0x2177, 0x2178, 0x2179, 0xFFE2, 0xFFE4, 0xFF07, 0xFF02,
+	},
+	{
+		0x2170, 0x2171, 0x2172, 0x2173, 0x2174, 0x2175, 0x2176, 0x2177, 0x2178, 0x2179, 0x2160, 0x2161, 0x2162, 0x2163, 0x2164, 0x2165,
+		0x2166, 0x2167, 0x2168, 0x2169, 0xFFE2, 0xFFE4, 0xFF07, 0xFF02, 0x3231, 0x2116, 0x2121, 0x2235, 0x7E8A, 0x891C, 0x9348, 0x9288,
+		0x84DC, 0x4FC9, 0x70BB, 0x6631, 0x68C8, 0x92F9, 0x66FB, 0x5F45, 0x4E28, 0x4EE1, 0x4EFC, 0x4F00, 0x4F03, 0x4F39, 0x4F56, 0x4F92,
+		0x4F8A, 0x4F9A, 0x4F94, 0x4FCD, 0x5040, 0x5022, 0x4FFF, 0x501E, 0x5046, 0x5070, 0x5042, 0x5094, 0x50F4, 0x50D8, 0x514A, 0x0000,
+		0x5164, 0x519D, 0x51BE, 0x51EC, 0x5215, 0x529C, 0x52A6, 0x52C0, 0x52DB, 0x5300, 0x5307, 0x5324, 0x5372, 0x5393, 0x53B2, 0x53DD,
+		0xFA0E, 0x549C, 0x548A, 0x54A9, 0x54FF, 0x5586, 0x5759, 0x5765, 0x57AC, 0x57C8, 0x57C7, 0xFA0F, 0xFA10, 0x589E, 0x58B2, 0x590B,
+		0x5953, 0x595B, 0x595D, 0x5963, 0x59A4, 0x59BA, 0x5B56, 0x5BC0, 0x752F, 0x5BD8, 0x5BEC, 0x5C1E, 0x5CA6, 0x5CBA, 0x5CF5, 0x5D27,
+		0x5D53, 0xFA11, 0x5D42, 0x5D6D, 0x5DB8, 0x5DB9, 0x5DD0, 0x5F21, 0x5F34, 0x5F67, 0x5FB7, 0x5FDE, 0x605D, 0x6085, 0x608A, 0x60DE,
+		0x60D5, 0x6120, 0x60F2, 0x6111, 0x6137, 0x6130, 0x6198, 0x6213, 0x62A6, 0x63F5, 0x6460, 0x649D, 0x64CE, 0x654E, 0x6600, 0x6615,
+		0x663B, 0x6609, 0x662E, 0x661E, 0x6624, 0x6665, 0x6657, 0x6659, 0xFA12, 0x6673, 0x6699, 0x66A0, 0x66B2, 0x66BF, 0x66FA, 0x670E,
+		0xF929, 0x6766, 0x67BB, 0x6852, 0x67C0, 0x6801, 0x6844, 0x68CF, 0xFA13, 0x6968, 0xFA14, 0x6998, 0x69E2, 0x6A30, 0x6A6B, 0x6A46,
+		0x6A73, 0x6A7E, 0x6AE2, 0x6AE4, 0x6BD6, 0x6C3F, 0x6C5C, 0x6C86, 0x6C6F, 0x6CDA, 0x6D04, 0x6D87, 0x6D6F,
+	},
+	{
+		0x6D96, 0x6DAC, 0x6DCF, 0x6DF8, 0x6DF2, 0x6DFC, 0x6E39, 0x6E5C, 0x6E27, 0x6E3C, 0x6EBF, 0x6F88, 0x6FB5, 0x6FF5, 0x7005, 0x7007,
+		0x7028, 0x7085, 0x70AB, 0x710F, 0x7104, 0x715C, 0x7146, 0x7147, 0xFA15, 0x71C1, 0x71FE, 0x72B1, 0x72BE, 0x7324, 0xFA16, 0x7377,
+		0x73BD, 0x73C9, 0x73D6, 0x73E3, 0x73D2, 0x7407, 0x73F5, 0x7426, 0x742A, 0x7429, 0x742E, 0x7462, 0x7489, 0x749F, 0x7501, 0x756F,
+		0x7682, 0x769C, 0x769E, 0x769B, 0x76A6, 0xFA17, 0x7746, 0x52AF, 0x7821, 0x784E, 0x7864, 0x787A, 0x7930, 0xFA18, 0xFA19, 0x0000,
+		0xFA1A, 0x7994, 0xFA1B, 0x799B, 0x7AD1, 0x7AE7, 0xFA1C, 0x7AEB, 0x7B9E, 0xFA1D, 0x7D48, 0x7D5C, 0x7DB7, 0x7DA0, 0x7DD6, 0x7E52,
+		0x7F47, 0x7FA1, 0xFA1E, 0x8301, 0x8362, 0x837F, 0x83C7, 0x83F6, 0x8448, 0x84B4, 0x8553, 0x8559, 0x856B, 0xFA1F, 0x85B0, 0xFA20,
+		0xFA21, 0x8807, 0x88F5, 0x8A12, 0x8A37, 0x8A79, 0x8AA7, 0x8ABE, 0x8ADF, 0xFA22, 0x8AF6, 0x8B53, 0x8B7F, 0x8CF0, 0x8CF4, 0x8D12,
+		0x8D76, 0xFA23, 0x8ECF, 0xFA24, 0xFA25, 0x9067, 0x90DE, 0xFA26, 0x9115, 0x9127, 0x91DA, 0x91D7, 0x91DE, 0x91ED, 0x91EE, 0x91E4,
+		0x91E5, 0x9206, 0x9210, 0x920A, 0x923A, 0x9240, 0x923C, 0x924E, 0x9259, 0x9251, 0x9239, 0x9267, 0x92A7, 0x9277, 0x9278, 0x92E7,
+		0x92D7, 0x92D9, 0x92D0, 0xFA27, 0x92D5, 0x92E0, 0x92D3, 0x9325, 0x9321, 0x92FB, 0xFA28, 0x931E, 0x92FF, 0x931D, 0x9302, 0x9370,
+		0x9357, 0x93A4, 0x93C6, 0x93DE, 0x93F8, 0x9431, 0x9445, 0x9448, 0x9592, 0xF9DC, 0xFA29, 0x969D, 0x96AF, 0x9733, 0x973B, 0x9743,
+		0x974D, 0x974F, 0x9751, 0x9755, 0x9857, 0x9865, 0xFA2A, 0xFA2B, 0x9927, 0xFA2C, 0x999E, 0x9A4E, 0x9AD9,
+	},
+	{
+		0x9ADC, 0x9B75, 0x9B72, 0x9B8F, 0x9BB1, 0x9BBB, 0x9C00, 0x9D70, 0x9D6B, 0xFA2D, 0x9E19, 0x9ED1, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+};
+
+static inline bool isSjisLead(uint8_t c){
+	return (c >= 0x81 && c <= 0x9F) || (c >= 0xE0 && c <= 0xFC);
+}
+
+static inline bool isSjisTrail(uint8_t c){
+	return c >= 0x40 && c <= 0xFC && c != 0x7F;
+}
+
+static inline uint32_t sjisToCodepoint(uint8_t lead, uint8_t trail){
+	if(lead >= 0xF0 && lead <= 0xF9){
+		return 0xE000 + (lead - 0xF0) * 188 + (trail - 0x40) - (trail > 0x7F ? 1 : 0);
+	}
+	uint8_t row = SjisLeadRow[lead <= 0x9F ? lead - 0x81 : lead - 0xE0 + 31];
+	if(row == 0xFF) return 0xFFFD;
+	uint16_t cp = SjisTable[row][trail - 0x40];
+	return cp != 0 ? cp : 0xFFFD;
+}
+
+// Unicode to code page 932, built on first use. Characters with several encodings keep the
+// lowest one, except that the NEC selected rows 0xED-0xEE lose to the IBM rows 0xFA-0xFC as on Windows.
+static const uint16_t* sjisReverseTable(){
+	static const std::vector<uint16_t> table = [](){
+		std::vector<uint16_t> t(0x10000, 0);
+		auto fill = [&t](uint8_t lead){
+			for(uint16_t trail = 0x40; trail <= 0xFC; trail++){
+				if(trail == 0x7F) continue;
+				uint32_t cp = sjisToCodepoint(lead, (uint8_t)trail);
+				if(cp != 0xFFFD && t[cp] == 0) t[cp] = (uint16_t)((lead << 8) | trail);
+			}
+		};
+		for(uint16_t lead = 0x81; lead <= 0xFC; lead++){
+			if(isSjisLead((uint8_t)lead) && lead != 0xED && lead != 0xEE) fill((uint8_t)lead);
+		}
+		fill(0xED);
+		fill(0xEE);
+		return t;
+	}();
+	return table.data();
+}
+
+static inline std::size_t encodeUtf8(uint32_t cp, char* out){
+	if(cp < 0x80){
+		out[0] = (char)cp;
+		return 1;
+	}
+	if(cp < 0x800){
+		out[0] = (char)(0xC0 | (cp >> 6));
+		out[1] = (char)(0x80 | (cp & 0x3F));
+		return 2;
+	}
+	if(cp < 0x10000){
+		out[0] = (char)(0xE0 | (cp >> 12));
+		out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+		out[2] = (char)(0x80 | (cp & 0x3F));
+		return 3;
+	}
+	out[0] = (char)(0xF0 | (cp >> 18));
+	out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+	out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+	out[3] = (char)(0x80 | (cp & 0x3F));
+	return 4;
+}
+
+// Decodes the character at in[i] and advances i past it. Malformed sequences, overlong forms and
+// surrogates decode as U+FFFD one byte at a time.
+static inline uint32_t decodeUtf8(const uint8_t* in, std::size_t len, std::size_t& i){
+	uint8_t c = in[i];
+	std::size_t n;
+	uint32_t cp;
+	uint32_t min;
+	if(c < 0x80){
+		i++;
+		return c;
+	} else if((c & 0xE0) == 0xC0){
+		n = 1; cp = c & 0x1F; min = 0x80;
+	} else if((c & 0xF0) == 0xE0){
+		n = 2; cp = c & 0x0F; min = 0x800;
+	} else if((c & 0xF8) == 0xF0){
+		n = 3; cp = c & 0x07; min = 0x10000;
+	} else {
+		i++;
+		return 0xFFFD;
+	}
+
+	if(i + n >= len){
+		i++;
+		return 0xFFFD;
+	}
+	for(std::size_t k = 1; k <= n; k++){
+		if((in[i + k] & 0xC0) != 0x80){
+			i++;
+			return 0xFFFD;
+		}
+		cp = (cp << 6) | (in[i + k] & 0x3F);
+	}
+	if(cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)){
+		i++;
+		return 0xFFFD;
+	}
+	i += n + 1;
+	return cp;
+}
+
+std::size_t sjisToUtf8(const uint8_t* in, std::size_t len, char* out){
+	char* start = out;
+	std::size_t i = 0;
+	while(i < len){
+		// ASCII runs are copied whole, a block only stops at a byte with the high bit set
+#if defined(__SSE2__)
+		while(i + 16 <= len){
+			__m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+			if(_mm_movemask_epi8(v) != 0) break;
+			_mm_storeu_si128((__m128i*)out, v);
+			i += 16;
+			out += 16;
+		}
+#endif
+		while(i + 8 <= len){
+			uint64_t w;
+			memcpy(&w, in + i, sizeof(uint64_t));
+			if(w & 0x8080808080808080ULL) break;
+			memcpy(out, &w, sizeof(uint64_t));
+			i += 8;
+			out += 8;
+		}
+		if(i >= len) break;
+
+		uint8_t c = in[i];
+		if(c < 0x80){
+			*out++ = (char)c;
+			i++;
+		} else if(c >= 0xA1 && c <= 0xDF){
+			// Half width katakana
+			out += encodeUtf8(0xFF61 + (c - 0xA1), out);
+			i++;
+		} else if(isSjisLead(c) && i + 1 < len && isSjisTrail(in[i + 1])){
+			out += encodeUtf8(sjisToCodepoint(c, in[i + 1]), out);
+			i += 2;
+		} else {
+			out += encodeUtf8(0xFFFD, out);
+			i++;
+		}
+	}
+	return out - start;
+}
+
+std::size_t utf16beToUtf8(const uint8_t* in, std::size_t len, char* out){
+	char* start = out;
+	std::size_t i = 0;
+	while(i < len){
+#if defined(__SSE2__)
+		// 8 code units at a time while every high byte is zero and every low byte is ASCII
+		const __m128i asciiMask = _mm_set1_epi16((short)0x80FF);
+		while(i + 16 <= len){
+			__m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+			if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, asciiMask), _mm_setzero_si128())) != 0xFFFF) break;
+			_mm_storel_epi64((__m128i*)out, _mm_packus_epi16(_mm_srli_epi16(v, 8), _mm_setzero_si128()));
+			i += 16;
+			out += 8;
+		}
+#endif
+		if(i >= len) break;
+		if(i + 1 >= len){
+			out += encodeUtf8(0xFFFD, out);
+			break;
+		}
+
+		uint32_t cp = (in[i] << 8) | in[i + 1];
+		i += 2;
+		if(cp >= 0xD800 && cp <= 0xDBFF && i + 1 < len){
+			uint32_t low = (in[i] << 8) | in[i + 1];
+			if(low >= 0xDC00 && low <= 0xDFFF){
+				cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+				i += 2;
+			}
+		}
+		if(cp >= 0xD800 && cp <= 0xDFFF) cp = 0xFFFD;
+		out += encodeUtf8(cp, out);
+	}
+	return out - start;
+}
+
+std::size_t utf8ToSjis(const char* text, std::size_t len, uint8_t* out){
+	const uint8_t* in = (const uint8_t*)text;
+	uint8_t* start = out;
+	std::size_t i = 0;
+	while(i < len){
+#if defined(__SSE2__)
+		while(i + 16 <= len){
+			__m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+			if(_mm_movemask_epi8(v) != 0) break;
+			_mm_storeu_si128((__m128i*)out, v);
+			i += 16;
+			out += 16;
+		}
+#endif
+		while(i + 8 <= len){
+			uint64_t w;
+			memcpy(&w, in + i, sizeof(uint64_t));
+			if(w & 0x8080808080808080ULL) break;
+			memcpy(out, &w, sizeof(uint64_t));
+			i += 8;
+			out += 8;
+		}
+		if(i >= len) break;
+
+		uint32_t cp = decodeUtf8(in, len, i);
+		if(cp < 0x80){
+			*out++ = (uint8_t)cp;
+		} else if(cp >= 0xFF61 && cp <= 0xFF9F){
+			*out++ = (uint8_t)(cp - 0xFF61 + 0xA1);
+		} else if(cp >= 0xE000 && cp < 0xE000 + 10 * 188){
+			uint32_t n = cp - 0xE000;
+			uint32_t trail = n % 188 + 0x40;
+			*out++ = (uint8_t)(0xF0 + n / 188);
+			*out++ = (uint8_t)(trail >= 0x7F ? trail + 1 : trail);
+		} else {
+			uint16_t code = cp < 0x10000 ? sjisReverseTable()[cp] : 0;
+			if(code != 0){
+				*out++ = (uint8_t)(code >> 8);
+				*out++ = (uint8_t)(code & 0xFF);
+			} else {
+				*out++ = '?';
+			}
+		}
+	}
+	return out - start;
+}
+
+std::size_t utf8ToUtf16be(const char* text, std::size_t len, uint8_t* out){
+	const uint8_t* in = (const uint8_t*)text;
+	uint8_t* start = out;
+	std::size_t i = 0;
+	while(i < len){
+#if defined(__SSE2__)
+		// Interleaving a zero before each ASCII byte gives its big endian code unit
+		while(i + 16 <= len){
+			__m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+			if(_mm_movemask_epi8(v) != 0) break;
+			_mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(_mm_setzero_si128(), v));
+			_mm_storeu_si128((__m128i*)(out + 16), _mm_unpackhi_epi8(_mm_setzero_si128(), v));
+			i += 16;
+			out += 32;
+		}
+#endif
+		if(i >= len) break;
+
+		uint32_t cp = decodeUtf8(in, len, i);
+		if(cp >= 0x10000){
+			cp -= 0x10000;
+			uint16_t high = (uint16_t)(0xD800 + (cp >> 10));
+			uint16_t low = (uint16_t)(0xDC00 + (cp & 0x3FF));
+			*out++ = (uint8_t)(high >> 8);
+			*out++ = (uint8_t)(high & 0xFF);
+			*out++ = (uint8_t)(low >> 8);
+			*out++ = (uint8_t)(low & 0xFF);
+		} else {
+			*out++ = (uint8_t)(cp >> 8);
+			*out++ = (uint8_t)(cp & 0xFF);
+		}
+	}
+	return out - start;
+}
+
+std::string CStream::readStringSJIS(std::size_t len){
+	std::string str(len * 3, '\0');
+	str.resize(readStringSJIS(len, &str[0]));
+	return str;
+}
+
+std::string CStream::readStringUTF16BE(std::size_t len){
+	std::string str(len * 3, '\0');
+	str.resize(readStringUTF16BE(len, &str[0]));
+	return str;
+}
+
+// Text reads stop at the end of the stream so only bytes that were really read get decoded
+static std::size_t clampToRemaining(CStream& stream, std::size_t len){
+	std::size_t position = stream.tell();
+	std::size_t size = stream.getSize();
+	if(position > size) return 0;
+	return (len > size - position ? size - position : len);
+}
+
+// Short names are staged on the stack, only long strings need a heap buffer
+std::size_t CStream::readStringSJIS(std::size_t len, char* out){
+	len = clampToRemaining(*this, len);
+	uint8_t local[256];
+	std::vector<uint8_t> heap;
+	uint8_t* in = local;
+	if(len > sizeof(local)){
+		heap.resize(len);
+		in = heap.data();
+	}
+	readBytesTo(in, len);
+	return sjisToUtf8(in, len, out);
+}
+
+std::size_t CStream::readStringUTF16BE(std::size_t len, char* out){
+	len = clampToRemaining(*this, len);
+	uint8_t local[256];
+	std::vector<uint8_t> heap;
+	uint8_t* in = local;
+	if(len > sizeof(local)){
+		heap.resize(len);
+		in = heap.data();
+	}
+	readBytesTo(in, len);
+	return utf16beToUtf8(in, len, out);
+}
+
+std::size_t CStream::writeStringSJIS(const char* str, std::size_t len){
+	uint8_t local[256];
+	std::vector<uint8_t> heap;
+	uint8_t* out = local;
+	if(len > sizeof(local)){
+		heap.resize(len);
+		out = heap.data();
+	}
+	std::size_t size = utf8ToSjis(str, len, out);
+	writeBytes(out, size);
+	return size;
+}
+
+std::size_t CStream::writeStringUTF16BE(const char* str, std::size_t len){
+	uint8_t local[512];
+	std::vector<uint8_t> heap;
+	uint8_t* out = local;
+	if(len * 2 > sizeof(local)){
+		heap.resize(len * 2);
+		out = heap.data();
+	}
+	std::size_t size = utf8ToUtf16be(str, len, out);
+	writeBytes(out, size);
+	return size;
+}
+
+uint64_t CStream::readUInt64(){
+	uint64_t value = 0;
+	readBytesTo((uint8_t*)&value, sizeof(uint64_t));
+	return (getOrder() != getSystemEndianess() ? swap64(value) : value);
+}
+
+int64_t CStream::readInt64(){
+	return (int64_t)readUInt64();
+}
+
+uint64_t CStream::peekUInt64(std::size_t at){
+	std::size_t pos = tell();
+	seek(at);
+	uint64_t value = readUInt64();
+	seek(pos);
+	return value;
+}
+
+int64_t CStream::peekInt64(std::size_t at){
+	return (int64_t)peekUInt64(at);
+}
+
+void CStream::writeUInt64(uint64_t v){
+	if(getOrder() != getSystemEndianess()){
+		v = swap64(v);
+	}
+	writeBytes((uint8_t*)&v, sizeof(uint64_t));
+}
+
+void CStream::writeInt64(int64_t v){
+	writeUInt64((uint64_t)v);
+}
+
+void CStream::writeOffsetAt64(std::size_t at){
+	std::size_t pos = tell();
+	seek(at);
+	writeUInt64(pos);
+	seek(pos);
+}
+
+// Non empty ranges ordered by offset, shared by every readRanges implementation
+static std::vector<const ReadRange*> sortRanges(const std::vector<ReadRange>& ranges){
+	std::vector<const ReadRange*> sorted;
+	sorted.reserve(ranges.size());
+	for(const ReadRange& range : ranges){
+		if(range.length > 0) sorted.push_back(&range);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const ReadRange* a, const ReadRange* b){ return a->offset < b->offset; });
+	return sorted;
+}
+
+// Records range as not read in full, failed lists indices into ranges
+static void rangeFailed(const std::vector<ReadRange>& ranges, const ReadRange* range, std::vector<std::size_t>* failed){
+	if(failed) failed->push_back(range - ranges.data());
+}
+
+// Streams without a batched path still gain from visiting the ranges in order
+bool CStream::readRanges(const std::vector<ReadRange>& ranges, std::size_t, std::vector<std::size_t>* failed){
+	std::size_t pos = tell();
+	std::size_t size = getSize();
+	bool ok = true;
+	for(const ReadRange* range : sortRanges(ranges)){
+		if(range->offset > size || range->length > size - range->offset || !seek(range->offset)){
+			rangeFailed(ranges, range, failed);
+			ok = false;
+			continue;
+		}
+		readBytesTo((uint8_t*)range->out, range->length);
+		if(tell() != range->offset + range->length){
+			rangeFailed(ranges, range, failed);
+			ok = false;
+		}
+	}
+	seek(pos);
+	return ok;
+}
+
+// Stops at the end of the source, returns how many bytes were copied
+std::size_t CStream::copyTo(CStream& dst, std::size_t len){
+	std::size_t position = tell();
+	std::size_t size = getSize();
+	if(position >= size) return 0;
+	if(len > size - position) len = size - position;
+
+	uint8_t buffer[0x10000];
+	std::size_t remaining = len;
+	while(remaining > 0){
+		std::size_t chunk = (remaining < sizeof(buffer) ? remaining : sizeof(buffer));
+		readBytesTo(buffer, chunk);
+		dst.writeBytes(buffer, chunk);
+		remaining -= chunk;
+	}
+	return len;
+}
+
+CFileStream::CFileStream(std::string path, Endianess ord, OpenMode mod){
+	base.open(path, (mod == OpenMode::In ? std::ios::in : std::ios::out) | std::ios::binary);
+	base.exceptions(std::ifstream::badbit);
+	filePath = path;
+#if defined(BSTREAM_INSTRUMENTATION)
+	mStats.name = path;
+#endif
+	order = ord;
+	mode = mod;
+	systemOrder = getSystemEndianess();
+}
+
+CFileStream::CFileStream(std::string path, OpenMode mod){
+	base.open(path, (mod == OpenMode::In ? std::ios::in : std::ios::out) | std::ios::binary);
+	base.exceptions(std::ifstream::badbit);
+	filePath = path;
+#if defined(BSTREAM_INSTRUMENTATION)
+	mStats.name = path;
+#endif
+	mode = mod;
+	systemOrder = getSystemEndianess();
+	order = getSystemEndianess();
+}
+
+void CFileStream::setChecksum(CChecksum* checksum){
+	mChecksum = checksum;
+}
+
+std::fstream &CFileStream::getStream(){
+	return base;
+}
+
+std::string CFileStream::getPath(){
+	return filePath;
+}
+
+bool CFileStream::seek(std::size_t pos, bool fromCurrent){
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_SEEK();
+#if defined(__unix__)
+	if(mWriteBehind != nullptr){
+		mWriteBehind->seek(fromCurrent ? mWriteBehind->tell() + pos : pos);
+		return true;
+	}
+#endif
+	try {
+		base.seekg(pos, (fromCurrent ? base.cur : base.beg));
+		return true;
+	} catch (const std::ifstream::failure& f) {
+		return false;
+	}
+}
+
+void CFileStream::skip(std::size_t amount){
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_SEEK();
+#if defined(__unix__)
+	if(mWriteBehind != nullptr){
+		mWriteBehind->seek(mWriteBehind->tell() + amount);
+		return;
+	}
+#endif
+	base.seekg(amount, base.cur);
+}
+
+std::size_t CFileStream::tell(){
+#if defined(__unix__)
+	if(mWriteBehind != nullptr) return mWriteBehind->tell();
+#endif
+	return base.tellg();
+}
+
+uint32_t CFileStream::readUInt32(){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(sizeof(uint32_t));
+	uint32_t r;
+	base.read((char*)&r, sizeof(uint32_t));
+	BSTREAM_CHECKSUM(&r, base.gcount());
+	if(order != systemOrder){
+		return swap32(r);
+	}
+	else{
+		return r;
+	}
+}
+
+uint64_t CFileStream::readUInt64(){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(sizeof(uint64_t));
+	uint64_t r;
+	base.read((char*)&r, sizeof(uint64_t));
+	BSTREAM_CHECKSUM(&r, base.gcount());
+	if(order != systemOrder){
+		return swap64(r);
+	}
+	else{
+		return r;
+	}
+}
+
+int32_t CFileStream::readInt32(){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(sizeof(int32_t));
+	int32_t r;
+	base.read((char*)&r, sizeof(int32_t));
+	BSTREAM_CHECKSUM(&r, base.gcount());
+	if(order != systemOrder){
+		return swap32(r);
+	}
+	else{
+		return r;
+	}
+}
+
+int64_t CFileStream::readInt64(){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(sizeof(int64_t));
+	int64_t r;
+	base.read((char*)&r, sizeof(int64_t));
+	BSTREAM_CHECKSUM(&r, base.gcount());
+	if(order != systemOrder){
+		return swap64(r);
+	}
+	else{
+		return r;
+	}
+}
+
+uint16_t CFileStream::readUInt16(){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(sizeof(uint16_t));
+	uint16_t r;
+	base.read((char*)&r, sizeof(uint16_t));
+	BSTREAM_CHECKSUM(&r, base.gcount());
+	if(order != systemOrder){
+		return swap16(r);
+	}
+	else{
+		return r;
+	}
+}
+
+int16_t CFileStream::readInt16(){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(sizeof(int16_t));
+	int16_t r;
+	base.read((char*)&r, sizeof(int16_t));
+	BSTREAM_CHECKSUM(&r, base.gcount());
+	if(order != systemOrder){
+		return swap16(r);
+	}
+	else{
+		return r;
+	}
+}
+
+uint8_t CFileStream::readUInt8(){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(sizeof(uint8_t));
+	uint8_t r;
+	base.read((char*)&r, sizeof(uint8_t));
+	BSTREAM_CHECKSUM(&r, base.gcount());
+	return r;
+}
+
+int8_t CFileStream::readInt8(){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(sizeof(int8_t));
+	int8_t r;
+	base.read((char*)&r, sizeof(int8_t));
+	BSTREAM_CHECKSUM(&r, base.gcount());
+	return r;
+}
+
+float CFileStream::readFloat(){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(sizeof(float));
+	char buff[sizeof(float)];
+	base.read(buff, sizeof(float));
+	BSTREAM_CHECKSUM(buff, base.gcount());
+	if(order != systemOrder){
+		char temp[sizeof(float)];
+		temp[0] = buff[3];
+		temp[1] = buff[2];
+		temp[2] = buff[1];
+		temp[3] = buff[0];
+		return *((float*)temp);
+	}
+	return *((float*)buff);
+}
+
+double CFileStream::readDouble(){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(sizeof(double));
+	char buff[sizeof(double)];
+	base.read(buff, sizeof(double));
+	BSTREAM_CHECKSUM(buff, base.gcount());
+	if(order != systemOrder){
+		char temp[sizeof(double)];
+		temp[0] = buff[7];
+		temp[1] = buff[6];
+		temp[2] = buff[5];
+		temp[3] = buff[4];
+		temp[4] = buff[3];
+		temp[5] = buff[2];
+		temp[6] = buff[1];
+		temp[7] = buff[0];
+		return *((double*)temp);
+	}
+	return *((double*)buff);
+}
+
+char* CFileStream::readBytes(std::size_t size){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(size);
+	char* buffer = new char[size];
+	base.read(buffer, size);
+	BSTREAM_CHECKSUM(buffer, base.gcount());
+	return buffer;
+}
+
+void CFileStream::readBytesTo(uint8_t* out_buffer, std::size_t len){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(len);
+	base.read((char*)out_buffer, len);
+	BSTREAM_CHECKSUM(out_buffer, base.gcount());
+}
+
+#if defined(__linux__)
+// Copies between the two files inside the kernel, returns how many bytes made it across
+static std::size_t copyFileRange(const std::string& srcPath, off_t srcOffset, const std::string& dstPath, off_t dstOffset, std::size_t len){
+	int in = open(srcPath.c_str(), O_RDONLY | O_CLOEXEC);
+	if(in < 0) return 0;
+	int out = open(dstPath.c_str(), O_WRONLY | O_CLOEXEC);
+	if(out < 0){
+		close(in);
+		return 0;
+	}
+
+	std::size_t done = 0;
+	while(done < len){
+		ssize_t n = copy_file_range(in, &srcOffset, out, &dstOffset, len - done, 0);
+		if(n <= 0){
+			// Older kernels and cross filesystem copies, sendfile writes at the output's file offset
+			if(lseek(out, dstOffset, SEEK_SET) < 0) break;
+			n = sendfile(out, in, &srcOffset, len - done);
+			if(n <= 0) break;
+			dstOffset += n;
+		}
+		done += n;
+	}
+
+	close(in);
+	close(out);
+	return done;
+}
+#endif
+
+std::size_t CFileStream::copyTo(CStream& dst, std::size_t len){
+	assert(mode == OpenMode::In);
+
+	std::size_t position = tell();
+	std::size_t size = getSize();
+	if(position >= size) return 0;
+	if(len > size - position) len = size - position;
+
+	CFileStream* file = dynamic_cast<CFileStream*>(&dst);
+	CMemoryStream* memory = dynamic_cast<CMemoryStream*>(&dst);
+
+#if defined(__linux__)
+	// Checksums need to see the bytes and write-behind output is buffered, so those copies take the buffered path
+	if(file != nullptr && file->mode == OpenMode::Out && file->mWriteBehind == nullptr && mChecksum == nullptr && file->mChecksum == nullptr){
+		std::size_t srcPos = base.tellg();
+		file->base.flush();
+		std::size_t dstPos = file->base.tellp();
+
+		std::size_t done;
+		{
+			BSTREAM_IO_TIMER();
+			done = copyFileRange(filePath, srcPos, file->filePath, dstPos, len);
+		}
+		BSTREAM_STAT_READ(done);
+		base.seekg(srcPos + done, base.beg);
+		file->base.seekp(dstPos + done, file->base.beg);
+
+		if(done == len) return len;
+		return done + copyBuffered(dst, len - done);
+	}
+#endif
+
+	if(memory != nullptr && memory->mOpenMode == OpenMode::Out){
+		if(!memory->prepareWrite(memory->mPosition, len)) return 0;
+		uint8_t* out = OffsetWritePointer<uint8_t>(memory->mBuffer, memory->mPosition);
+		readBytesTo(out, len);
+		// The file can still shrink underneath us, only keep what actually arrived
+		std::size_t done = base.gcount();
+		if(done < len) base.clear();
+		if(memory->mChecksum) memory->mChecksum->update(out, done);
+		memory->markDirty(memory->mPosition, done);
+		memory->mPosition += done;
+		if(memory->mPosition > memory->mSize) memory->mSize = memory->mPosition;
+		return done;
+	}
+
+	return copyBuffered(dst, len);
+}
+
+// Stops early if the file ends before len bytes, returns how many bytes were copied
+std::size_t CFileStream::copyBuffered(CStream& dst, std::size_t len){
+	uint8_t buffer[0x10000];
+	std::size_t done = 0;
+	while(done < len){
+		std::size_t chunk = (len - done < sizeof(buffer) ? len - done : sizeof(buffer));
+		readBytesTo(buffer, chunk);
+		std::size_t got = base.gcount();
+		dst.writeBytes(buffer, got);
+		done += got;
+		if(got < chunk){
+			base.clear();
+			break;
+		}
+	}
+	return done;
+}
+
+#if defined(__unix__)
+// Keeps calling preadv until every iovec is filled, returns false on error or end of file
+// Returns how many bytes were read, less than asked only at the end of the file or on an error
+static std::size_t preadvAll(int fd, struct iovec* iov, std::size_t count, off_t offset){
+	std::size_t total = 0;
+	while(count > 0){
+		ssize_t done = preadv(fd, iov, (int)count, offset);
+		if(done < 0 && errno == EINTR) continue;
+		if(done <= 0) break;
+		offset += done;
+		total += done;
+		while(count > 0 && (std::size_t)done >= iov->iov_len){
+			done -= iov->iov_len;
+			iov++;
+			count--;
+		}
+		if(count > 0){
+			iov->iov_base = (uint8_t*)iov->iov_base + done;
+			iov->iov_len -= done;
+		}
+	}
+	return total;
+}
+#endif
+
+bool CFileStream::readRanges(const std::vector<ReadRange>& ranges, std::size_t maxGap, std::vector<std::size_t>* failed){
+	assert(mode == OpenMode::In);
+#if defined(__unix__)
+	int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0) return CStream::readRanges(ranges, maxGap, failed);
+
+	BSTREAM_IO_TIMER();
+	long iovMax = sysconf(_SC_IOV_MAX);
+	std::size_t maxIovecs = (iovMax > 1 ? (std::size_t)iovMax : 16);
+
+	std::vector<const ReadRange*> sorted = sortRanges(ranges);
+	// Every gap is read into the same scratch buffer, its contents are never looked at
+	std::vector<uint8_t> scratch(maxGap > 0 ? maxGap : 1);
+	std::vector<struct iovec> iov;
+	bool ok = true;
+
+	// Ranges past the end are dropped up front so they can't cut short the calls they'd share
+	struct stat st;
+	if(fstat(fd, &st) == 0){
+		std::size_t size = st.st_size;
+		auto kept = std::stable_partition(sorted.begin(), sorted.end(), [size](const ReadRange* r){ return r->offset <= size && r->length <= size - r->offset; });
+		for(auto it = kept; it != sorted.end(); ++it){
+			rangeFailed(ranges, *it, failed);
+			ok = false;
+		}
+		sorted.erase(kept, sorted.end());
+	}
+
+	std::size_t i = 0;
+	while(i < sorted.size()){
+		std::size_t first = i;
+		std::size_t start = sorted[i]->offset;
+		std::size_t end = start;
+		iov.clear();
+
+		// Overlapping ranges can't share a call since each byte lands in a single iovec
+		for(; i < sorted.size() && iov.size() + 2 <= maxIovecs; i++){
+			const ReadRange* range = sorted[i];
+			if(range->offset < end || range->offset - end > maxGap) break;
+			if(range->offset > end) iov.push_back({ scratch.data(), range->offset - end });
+			iov.push_back({ range->out, range->length });
+			end = range->offset + range->length;
+		}
+
+		BSTREAM_STAT_SEEK();
+		BSTREAM_STAT_READ(end - start);
+		std::size_t read = preadvAll(fd, iov.data(), iov.size(), start);
+		if(read == end - start) continue;
+		for(std::size_t r = first; r < i; r++){
+			if(sorted[r]->offset + sorted[r]->length - start > read){
+				rangeFailed(ranges, sorted[r], failed);
+				ok = false;
+			}
+		}
+	}
+
+	close(fd);
+	return ok;
+#else
+	return CStream::readRanges(ranges, maxGap, failed);
+#endif
+}
+
+std::string CFileStream::readString(std::size_t len){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(len);
+    std::string str(len, '\0'); //creates string str at size of length and fills it with '\0'
+    base.read(&str[0], len);
+    BSTREAM_CHECKSUM(&str[0], base.gcount());
+    return str;
+}
+
+std::string CFileStream::peekString(std::size_t at, std::size_t len){
+	assert(mode == OpenMode::In);
+    std::string str(len, '\0'); //creates string str at size of length and fills it with '\0'
+	if(len > 0) peekRaw(at, &str[0], len);
+    return str;
+}
+
+std::string CFileStream::readWString(std::size_t len){
+	assert(mode == OpenMode::In);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_READ(len);
+    std::string str(len, '\0'); //creates string str at size of length and fills it with '\0'
+    base.read(&str[0], len);
+    BSTREAM_CHECKSUM(&str[0], base.gcount());
+    return str;
+}
+
+void CFileStream::writeInt8(int8_t v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(int8_t));
+	BSTREAM_CHECKSUM(&v, 1);
+	writeRaw(&v, 1);
+}
+
+void CFileStream::writeUInt8(uint8_t v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(uint8_t));
+	BSTREAM_CHECKSUM(&v, 1);
+	writeRaw(&v, 1);
+}
+
+void CFileStream::writeInt16(int16_t v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(int16_t));
+	if(order != systemOrder){
+		v = swap16(v);
+	}
+	BSTREAM_CHECKSUM(&v, sizeof(uint16_t));
+	writeRaw(&v, sizeof(uint16_t));
+}
+
+void CFileStream::writeUInt16(uint16_t v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(uint16_t));
+	if(order != systemOrder){
+		v = swap16(v);
+	}
+	BSTREAM_CHECKSUM(&v, sizeof(uint16_t));
+	writeRaw(&v, sizeof(uint16_t));
+}
+
+void CFileStream::writeInt32(int32_t v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(int32_t));
+	if(order != systemOrder){
+	   v = swap32(v);
+	}
+	BSTREAM_CHECKSUM(&v, sizeof(int32_t));
+	writeRaw(&v, sizeof(int32_t));
+}
+
+void CFileStream::writeInt64(int64_t v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(int64_t));
+	if(order != systemOrder){
+	   v = swap64(v);
+	}
+	BSTREAM_CHECKSUM(&v, sizeof(int64_t));
+	writeRaw(&v, sizeof(int64_t));
+}
+
+void CFileStream::writeUInt32(uint32_t v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(uint32_t));
+	if(order != systemOrder){
+	   v = swap32(v);
+	}
+	BSTREAM_CHECKSUM(&v, sizeof(uint32_t));
+	writeRaw(&v, sizeof(uint32_t));
+}
+
+void CFileStream::writeUInt64(uint64_t v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(uint64_t));
+	if(order != systemOrder){
+	   v = swap64(v);
+	}
+	BSTREAM_CHECKSUM(&v, sizeof(uint64_t));
+	writeRaw(&v, sizeof(uint64_t));
+}
+
+void CFileStream::writeFloat(float v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(float));
+	char* buff = (char*)&v;
+	if(order != systemOrder){
+		char temp[sizeof(float)];
+		temp[0] = buff[3];
+		temp[1] = buff[2];
+		temp[2] = buff[1];
+		temp[3] = buff[0];
+		v = *((float*)temp);
+	}
+	BSTREAM_CHECKSUM(&v, sizeof(float));
+	writeRaw(&v, sizeof(float));
+}
+
+void CFileStream::writeDouble(double v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(double));
+	char* buff = (char*)&v;
+	if(order != systemOrder){
+		char temp[sizeof(double)];
+		temp[0] = buff[7];
+		temp[1] = buff[6];
+		temp[2] = buff[5];
+		temp[3] = buff[4];
+		temp[4] = buff[3];
+		temp[5] = buff[2];
+		temp[6] = buff[1];
+		temp[7] = buff[0];
+		v = *((double*)temp);
+	}
+	BSTREAM_CHECKSUM(&v, sizeof(double));
+	writeRaw(&v, sizeof(double));
+}
+
+
+void CFileStream::writeRaw(const void* data, std::size_t size){
+#if defined(__unix__)
+	if(mWriteBehind != nullptr){
+		mWriteBehind->write(data, size);
+		return;
+	}
+#endif
+	base.write((const char*)data, size);
+}
+
+void CFileStream::writePatch(std::size_t at, const void* data, std::size_t size){
+#if defined(__unix__)
+	if(mWriteBehind != nullptr){
+		mWriteBehind->patch(at, data, size);
+		return;
+	}
+#endif
+	std::size_t pos = base.tellp();
+	base.seekp(at);
+	base.write((const char*)data, size);
+	base.seekp(pos);
+}
+
+void CFileStream::alignTo(std::size_t to){
+	assert(mode == OpenMode::Out);
+	static const uint8_t zeros[256] = {};
+	std::size_t nextAligned = (to - tell() % to) % to;
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(nextAligned);
+	while(nextAligned > 0){
+		std::size_t chunk = (nextAligned < sizeof(zeros) ? nextAligned : sizeof(zeros));
+		BSTREAM_CHECKSUM(zeros, chunk);
+		writeRaw(zeros, chunk);
+		nextAligned -= chunk;
+	}
+}
+
+void CFileStream::writeOffsetAt16(std::size_t at){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(uint16_t));
+	uint16_t writeOffset = tell() & 0xFFFF;
+	if(order != systemOrder){
+		writeOffset = swap16(writeOffset);
+	}
+	writePatch(at, &writeOffset, sizeof(uint16_t));
+}
+
+void CFileStream::writeOffsetAt32(std::size_t at){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(uint32_t));
+	// Positions past 4 GiB need writeOffsetAt64
+	std::size_t position = tell();
+	if(position > 0xFFFFFFFF){
+		mError = StreamError::OffsetOverflow;
+		return;
+	}
+	uint32_t writeOffset = position;
+	if(order != systemOrder){
+		writeOffset = swap32(writeOffset);
+	}
+	writePatch(at, &writeOffset, sizeof(uint32_t));
+}
+
+void CFileStream::writeOffsetAt64(std::size_t at){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(sizeof(uint64_t));
+	uint64_t writeOffset = tell();
+	if(order != systemOrder){
+		writeOffset = swap64(writeOffset);
+	}
+	writePatch(at, &writeOffset, sizeof(uint64_t));
+}
+
+#if defined(__unix__)
+
+bool CFileStream::enableWriteBehind(std::size_t bufferSize, std::size_t expectedSize){
+	assert(mode == OpenMode::Out);
+	if(mWriteBehind != nullptr) return true;
+
+	base.flush();
+	CWriteBehind* writeBehind = new CWriteBehind();
+	if(!writeBehind->open(filePath, base.tellp(), bufferSize, expectedSize)){
+		delete writeBehind;
+		return false;
+	}
+	mWriteBehind = writeBehind;
+	return true;
+}
+
+bool CFileStream::disableWriteBehind(){
+	if(mWriteBehind == nullptr) return true;
+
+	std::size_t pos = mWriteBehind->tell();
+	bool ok = mWriteBehind->close();
+	delete mWriteBehind;
+	mWriteBehind = nullptr;
+	base.seekp(pos);
+	return ok;
+}
+
+#else
+
+bool CFileStream::enableWriteBehind(std::size_t, std::size_t){
+	return false;
+}
+
+bool CFileStream::disableWriteBehind(){
+	return true;
+}
+
+#endif
+
+Endianess CFileStream::getOrder(){
+    return order;
+}
+
+void CFileStream::setOrder(Endianess e){
+    order = e;
+}
+
+void CFileStream::writeString(std::string v){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(v.size());
+	BSTREAM_CHECKSUM(v.data(), v.size());
+	writeRaw(v.data(), v.size());
+}
+
+void CFileStream::writeBytes(uint8_t* v, std::size_t size){
+	assert(mode == OpenMode::Out);
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_WRITE(size);
+	BSTREAM_CHECKSUM(v, size);
+	writeRaw(v, size);
+}
+
+// Peeks go straight to the file so they count once as a peek and stay out of the read stats and checksum
+void CFileStream::peekRaw(std::size_t offset, void* out, std::size_t size){
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_PEEK(size);
+	std::size_t pos = base.tellg();
+	base.seekg(offset, base.beg);
+	base.read((char*)out, size);
+	if((std::size_t)base.gcount() != size){
+		memset((uint8_t*)out + base.gcount(), 0, size - base.gcount());
+		base.clear();
+	}
+	base.seekg(pos, base.beg);
+}
+
+uint8_t CFileStream::peekUInt8(std::size_t offset){
+	assert(mode == OpenMode::In);
+	uint8_t ret;
+	peekRaw(offset, &ret, sizeof(uint8_t));
+	return ret;
+}
+
+int8_t CFileStream::peekInt8(std::size_t offset){
+	assert(mode == OpenMode::In);
+	int8_t ret;
+	peekRaw(offset, &ret, sizeof(int8_t));
+	return ret;
+}
+
+uint16_t CFileStream::peekUInt16(std::size_t offset){
+	assert(mode == OpenMode::In);
+	uint16_t ret;
+	peekRaw(offset, &ret, sizeof(uint16_t));
+	if(order != systemOrder){
+		return swap16(ret);
+	}
+	else{
+		return ret;
+	}
+}
+
+int16_t CFileStream::peekInt16(std::size_t offset){
+	assert(mode == OpenMode::In);
+	int16_t ret;
+	peekRaw(offset, &ret, sizeof(int16_t));
+	if(order != systemOrder){
+		return swap16(ret);
+	}
+	else{
+		return ret;
+	}
+}
+
+uint32_t CFileStream::peekUInt32(std::size_t offset){
+	assert(mode == OpenMode::In);
+	uint32_t ret;
+	peekRaw(offset, &ret, sizeof(uint32_t));
+	if(order != systemOrder){
+		return swap32(ret);
+	}
+	else{
+		return ret;
+	}
+}
+
+uint64_t CFileStream::peekUInt64(std::size_t offset){
+	assert(mode == OpenMode::In);
+	uint64_t ret;
+	peekRaw(offset, &ret, sizeof(uint64_t));
+	if(order != systemOrder){
+		return swap64(ret);
+	}
+	else{
+		return ret;
+	}
+}
+
+int32_t CFileStream::peekInt32(std::size_t offset){
+	assert(mode == OpenMode::In);
+	int32_t ret;
+	peekRaw(offset, &ret, sizeof(int32_t));
+	if(order != systemOrder){
+		return swap32(ret);
+	}
+	else{
+		return ret;
+	}
+}
+
+int64_t CFileStream::peekInt64(std::size_t offset){
+	assert(mode == OpenMode::In);
+	int64_t ret;
+	peekRaw(offset, &ret, sizeof(int64_t));
+	if(order != systemOrder){
+		return swap64(ret);
+	}
+	else{
+		return ret;
+	}
+}
+
+std::size_t CFileStream::getSize(){
+	BSTREAM_IO_TIMER();
+	BSTREAM_STAT_SEEK();
+#if defined(__unix__)
+	if(mWriteBehind != nullptr) return mWriteBehind->getSize();
+#endif
+	std::size_t pos = base.tellg();
+	base.seekg(0, std::ios::end);
+	std::size_t ret = base.tellg();
+	base.seekg(pos, std::ios::beg);
+	return ret;
+}
+
+///
+///
+///  CMemoryStream
+///
+///
+
+
+CMemoryStream::CMemoryStream(uint8_t* ptr, std::size_t size, Endianess ord, OpenMode mode){
+	mBuffer = ptr;
+	mPosition = 0;
+	mSize = size;
+	mCapacity = size;
+	mHasInternalBuffer = false;
+	mOpenMode = mode;
+	order = ord;
+	systemOrder = getSystemEndianess();
+}
+
+CMemoryStream::CMemoryStream(std::size_t size, Endianess ord, OpenMode mode){
+	mBuffer = new uint8_t[size]{};
+	mPosition = 0;
+	mSize = size;
+	mCapacity = size;
+	mHasInternalBuffer = true;
+	mOpenMode = mode;
+	order = ord;
+	systemOrder = getSystemEndianess();
+}
+
+CMemoryStream::CMemoryStream(std::size_t size, Endianess ord, OpenMode mode, PageBacking backing){
+	mBacking = backing;
+	mCapacity = size;
+	mBuffer = allocateBuffer(mCapacity);
+	mPosition = 0;
+	mSize = size;
+	mHasInternalBuffer = true;
+	mOpenMode = mode;
+	order = ord;
+	systemOrder = getSystemEndianess();
+}
+
+CMemoryStream::CMemoryStream(CBufferPool& pool, std::size_t size, Endianess ord, OpenMode mode){
+	mCapacity = size;
+	mBuffer = pool.acquire(mCapacity);
+	mPool = &pool;
+	mPosition = 0;
+	mSize = size;
+	mHasInternalBuffer = true;
+	mOpenMode = mode;
+	order = ord;
+	systemOrder = getSystemEndianess();
+}
+
+std::size_t CMemoryStream::getSize(){
+	return mSize;
+}
+
+std::size_t CMemoryStream::getCapacity(){
+	return mCapacity;
+}
+
+// Allow for changing from read to write mode ONLY if we have an internal buffer.
+bool CMemoryStream::changeMode(OpenMode mode){
+	if(!mHasInternalBuffer){
+		return false;
+	}
+
+	mOpenMode = mode;
+
+	return true;
+}
+
+bool CMemoryStream::seek(std::size_t pos, bool fromCurrent){
+	BSTREAM_STAT_SEEK();
+	if(fromCurrent && mPosition + pos > mCapacity || pos > mCapacity) return false;
+
+	if(fromCurrent){
+		mPosition += pos;
+	} else {
+		mPosition = pos;
+	}
+
+	if(mPosition > mSize) mSize = mPosition;
+
+	return true;
+}
+
+void CMemoryStream::skip(std::size_t amount){
+	BSTREAM_STAT_SEEK();
+	mPosition += (mPosition + amount < mSize ? amount : 0);
+}
+
+std::size_t CMemoryStream::tell(){
+	return mPosition;
+}
+
+void CMemoryStream::setChecksum(CChecksum* checksum){
+	mChecksum = checksum;
+}
+
+uint8_t* CMemoryStream::getBuffer(){
+	return mBuffer;
+}
+
+///
+/// Memstream Reading Functions
+///
+
+int8_t CMemoryStream::readInt8(){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(sizeof(int8_t))) return 0;
+	BSTREAM_STAT_READ(sizeof(int8_t));
+	int8_t r;
+	memcpy(&r, OffsetPointer<int8_t>(mBuffer, mPosition), sizeof(int8_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(uint8_t));
+	mPosition++;
+	return r;
+}
+
+uint8_t CMemoryStream::readUInt8(){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(sizeof(uint8_t))) return 0;
+	BSTREAM_STAT_READ(sizeof(uint8_t));
+	uint8_t r;
+	memcpy(&r, OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(uint8_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(uint8_t));
+	mPosition++;
+	return r;
+}
+
+int16_t CMemoryStream::readInt16(){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(sizeof(int16_t))) return 0;
+	BSTREAM_STAT_READ(sizeof(int16_t));
+	int16_t r;
+	memcpy(&r, OffsetPointer<int16_t>(mBuffer, mPosition), sizeof(int16_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int16_t));
+	mPosition += sizeof(int16_t);
+
+	if(needsSwap(mPosition - sizeof(int16_t))){
+		return swap16(r);
+	}
+	else{
+		return r;
+	}
+}
+
+uint16_t CMemoryStream::readUInt16(){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(sizeof(uint16_t))) return 0;
+	BSTREAM_STAT_READ(sizeof(uint16_t));
+	uint16_t r;
+	memcpy(&r, OffsetPointer<uint16_t>(mBuffer, mPosition), sizeof(uint16_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(uint16_t));
+	mPosition += sizeof(uint16_t);
+
+	if(needsSwap(mPosition - sizeof(uint16_t))){
+		return swap16(r);
+	}
+	else{
+		return r;
+	}
+}
+
+uint32_t CMemoryStream::readUInt32(){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(sizeof(uint32_t))) return 0;
+	BSTREAM_STAT_READ(sizeof(uint32_t));
+	uint32_t r;
+	memcpy(&r, OffsetPointer<uint32_t>(mBuffer, mPosition), sizeof(uint32_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(uint32_t));
+	mPosition += sizeof(uint32_t);
+
+	if(needsSwap(mPosition - sizeof(uint32_t))){
+		return swap32(r);
+	}
+	else{
+		return r;
+	}
+}
+
+uint64_t CMemoryStream::readUInt64(){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(sizeof(uint64_t))) return 0;
+	BSTREAM_STAT_READ(sizeof(uint64_t));
+	uint64_t r;
+	memcpy(&r, OffsetPointer<uint64_t>(mBuffer, mPosition), sizeof(uint64_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(uint64_t));
+	mPosition += sizeof(uint64_t);
+
+	if(needsSwap(mPosition - sizeof(uint64_t))){
+		return swap64(r);
+	}
+	else{
+		return r;
+	}
+}
+
+int32_t CMemoryStream::readInt32(){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(sizeof(int32_t))) return 0;
+	BSTREAM_STAT_READ(sizeof(int32_t));
+	int32_t r;
+	memcpy(&r, OffsetPointer<int32_t>(mBuffer, mPosition), sizeof(int32_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int32_t));
+	mPosition += sizeof(int32_t);
+
+	if(needsSwap(mPosition - sizeof(int32_t))){
+		return swap32(r);
+	}
+	else{
+		return r;
+	}
+}
+
+int64_t CMemoryStream::readInt64(){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(sizeof(int64_t))) return 0;
+	BSTREAM_STAT_READ(sizeof(int64_t));
+	int64_t r;
+	memcpy(&r, OffsetPointer<int64_t>(mBuffer, mPosition), sizeof(int64_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int64_t));
+	mPosition += sizeof(int64_t);
+
+	if(needsSwap(mPosition - sizeof(int64_t))){
+		return swap64(r);
+	}
+	else{
+		return r;
+	}
+}
+
+
+float CMemoryStream::readFloat(){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(sizeof(float))) return 0;
+	BSTREAM_STAT_READ(sizeof(float));
+
+	char buff[sizeof(float)];
+	memcpy(&buff, OffsetPointer<int32_t>(mBuffer, mPosition), sizeof(float));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(float));
+	mPosition += sizeof(float);
+	if(needsSwap(mPosition - sizeof(float))){
+		char temp[sizeof(float)];
+		temp[0] = buff[3];
+		temp[1] = buff[2];
+		temp[2] = buff[1];
+		temp[3] = buff[0];
+		return *((float*)temp);
+	}
+
+	else{
+		return *((float*)buff);
+	}
+}
+
+double CMemoryStream::readDouble(){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(sizeof(double))) return 0;
+	BSTREAM_STAT_READ(sizeof(double));
+
+	char buff[sizeof(double)];
+	memcpy(&buff, OffsetPointer<double>(mBuffer, mPosition), sizeof(double));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(double));
+	mPosition += sizeof(double);
+	if(needsSwap(mPosition - sizeof(double))){
+		char temp[sizeof(double)];
+		temp[0] = buff[7];
+		temp[1] = buff[6];
+		temp[2] = buff[5];
+		temp[3] = buff[4];
+		temp[4] = buff[3];
+		temp[5] = buff[2];
+		temp[6] = buff[1];
+		temp[7] = buff[0];
+		return *((double*)temp);
+	}
+
+	else{
+		return *((double*)buff);
+	}
+}
+
+///
+/// Memstream Peek Functions
+///
+
+int8_t CMemoryStream::peekInt8(std::size_t at){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensureAt(at, sizeof(int8_t))) return 0;
+	BSTREAM_STAT_PEEK(sizeof(int8_t));
+	int8_t r;
+	memcpy(&r, OffsetPointer<int8_t>(mBuffer, at), sizeof(int8_t));
+	return r;
+}
+
+uint8_t CMemoryStream::peekUInt8(std::size_t at){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensureAt(at, sizeof(uint8_t))) return 0;
+	BSTREAM_STAT_PEEK(sizeof(uint8_t));
+	uint8_t r;
+	memcpy(&r, OffsetPointer<uint8_t>(mBuffer, at), sizeof(uint8_t));
+	return r;
+}
+
+int16_t CMemoryStream::peekInt16(std::size_t at){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensureAt(at, sizeof(int16_t))) return 0;
+	BSTREAM_STAT_PEEK(sizeof(int16_t));
+	int16_t r;
+	memcpy(&r, OffsetPointer<int16_t>(mBuffer, at), sizeof(int16_t));
+
+	if(needsSwap(at)){
+		return swap16(r);
+	}
+	else{
+		return r;
+	}
+}
+
+uint16_t CMemoryStream::peekUInt16(std::size_t at){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensureAt(at, sizeof(uint16_t))) return 0;
+	BSTREAM_STAT_PEEK(sizeof(uint16_t));
+	uint16_t r;
+	memcpy(&r, OffsetPointer<uint16_t>(mBuffer, at), sizeof(uint16_t));
+
+	if(needsSwap(at)){
+		return swap16(r);
+	}
+	else{
+		return r;
+	}
+}
+
+uint32_t CMemoryStream::peekUInt32(std::size_t at){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensureAt(at, sizeof(uint32_t))) return 0;
+	BSTREAM_STAT_PEEK(sizeof(uint32_t));
+	uint32_t r;
+	memcpy(&r, OffsetPointer<uint32_t>(mBuffer, at), sizeof(uint32_t));
+
+	if(needsSwap(at)){
+		return swap32(r);
+	}
+	else{
+		return r;
+	}
+}
+
+uint64_t CMemoryStream::peekUInt64(std::size_t at){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensureAt(at, sizeof(uint64_t))) return 0;
+	BSTREAM_STAT_PEEK(sizeof(uint64_t));
+	uint64_t r;
+	memcpy(&r, OffsetPointer<uint64_t>(mBuffer, at), sizeof(uint64_t));
+
+	if(needsSwap(at)){
+		return swap64(r);
+	}
+	else{
+		return r;
+	}
+}
+
+int32_t CMemoryStream::peekInt32(std::size_t at){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensureAt(at, sizeof(int32_t))) return 0;
+	BSTREAM_STAT_PEEK(sizeof(int32_t));
+	int32_t r;
+	memcpy(&r, OffsetPointer<int32_t>(mBuffer, at), sizeof(int32_t));
+
+	if(needsSwap(at)){
+		return swap32(r);
+	}
+	else{
+		return r;
+	}
+}
+
+int64_t CMemoryStream::peekInt64(std::size_t at){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensureAt(at, sizeof(int64_t))) return 0;
+	BSTREAM_STAT_PEEK(sizeof(int64_t));
+	int64_t r;
+	memcpy(&r, OffsetPointer<int64_t>(mBuffer, at), sizeof(int64_t));
+
+	if(needsSwap(at)){
+		return swap64(r);
+	}
+	else{
+		return r;
+	}
+}
+
+std::string CMemoryStream::readString(std::size_t len){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(len)) return std::string();
+	BSTREAM_STAT_READ(len);
+	std::string str(OffsetPointer<char>(mBuffer, mPosition),OffsetPointer<char>(mBuffer, mPosition+len));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), len);
+	mPosition += len;
+	return str;
+}
+
+std::string CMemoryStream::peekString(std::size_t at, std::size_t len){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensureAt(at, len)) return std::string();
+	BSTREAM_STAT_PEEK(len);
+	std::string str(OffsetPointer<char>(mBuffer, at), OffsetPointer<char>(mBuffer, at+len));
+	return str;
+}
+
+// Overruns leave the output untouched and flag the stream with OutOfBounds
+void CMemoryStream::readBytesTo(uint8_t* out_buffer, std::size_t len){
+	assert(mOpenMode == OpenMode::In);
+	if(ensure(len)){
+		BSTREAM_STAT_READ(len);
+		memcpy(out_buffer, OffsetPointer<char>(mBuffer, mPosition), len);
+
+		BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), len);
+		mPosition += len;
+	}
+}
+
+std::size_t CMemoryStream::readStringSJIS(std::size_t len, char* out){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(len)) return 0;
+	BSTREAM_STAT_READ(len);
+
+	const uint8_t* in = OffsetPointer<uint8_t>(mBuffer, mPosition);
+	BSTREAM_CHECKSUM(in, len);
+	mPosition += len;
+	return sjisToUtf8(in, len, out);
+}
+
+std::size_t CMemoryStream::readStringUTF16BE(std::size_t len, char* out){
+	assert(mOpenMode == OpenMode::In);
+	if(!ensure(len)) return 0;
+	BSTREAM_STAT_READ(len);
+
+	const uint8_t* in = OffsetPointer<uint8_t>(mBuffer, mPosition);
+	BSTREAM_CHECKSUM(in, len);
+	mPosition += len;
+	return utf16beToUtf8(in, len, out);
+}
+
+// Every range is already in memory, only the bounds need checking
+bool CMemoryStream::readRanges(const std::vector<ReadRange>& ranges, std::size_t, std::vector<std::size_t>* failed){
+	assert(mOpenMode == OpenMode::In);
+	bool ok = true;
+	for(const ReadRange& range : ranges){
+		if(range.offset > mSize || range.length > mSize - range.offset){
+			mError = StreamError::OutOfBounds;
+			rangeFailed(ranges, &range, failed);
+			ok = false;
+			continue;
+		}
+		BSTREAM_STAT_PEEK(range.length);
+		memcpy(range.out, OffsetPointer<uint8_t>(mBuffer, range.offset), range.length);
+	}
+	return ok;
+}
+
+// Memory streams already hold the bytes, so any destination gets them in a single write
+std::size_t CMemoryStream::copyTo(CStream& dst, std::size_t len){
+	assert(mOpenMode == OpenMode::In);
+	if(mPosition > mSize) len = 0;
+	else if(len > mSize - mPosition) len = mSize - mPosition;
+
+	BSTREAM_STAT_READ(len);
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), len);
+	dst.writeBytes(OffsetWritePointer<uint8_t>(mBuffer, mPosition), len);
+	mPosition += len;
+	return len;
+}
+
+///
+/// Memstream Endian Conversion
+///
+
+#if defined(__SSSE3__)
+static void swapRunSSSE3(uint8_t* p, std::size_t width, std::size_t& count){
+	__m128i mask;
+	if(width == 2){
+		mask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+	} else if(width == 4){
+		mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+	} else {
+		mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+	}
+
+	std::size_t perVector = 16 / width;
+	for(; count >= perVector; count -= perVector, p += 16){
+		__m128i v = _mm_loadu_si128((const __m128i*)p);
+		_mm_storeu_si128((__m128i*)p, _mm_shuffle_epi8(v, mask));
+	}
+}
+#endif
+
+// Unaligned load, swap and store for each value, swap is one of the builtin backed swap16/32/64
+template<typename T>
+static inline void swapValues(uint8_t* p, std::size_t count, T (*swap)(T)){
+	for(; count > 0; count--, p += sizeof(T)){
+		T v;
+		memcpy(&v, p, sizeof(T));
+		v = swap(v);
+		memcpy(p, &v, sizeof(T));
+	}
+}
+
+// Swaps count contiguous values of width bytes each
+static void swapRun(uint8_t* p, std::size_t width, std::size_t count){
+	if(width < 2) return;
+
+#if defined(__SSSE3__)
+	std::size_t total = count;
+	swapRunSSSE3(p, width, count);
+	p += (total - count) * width;
+#endif
+
+	if(width == 2){
+		swapValues<uint16_t>(p, count, swap16);
+	} else if(width == 4){
+		swapValues<uint32_t>(p, count, swap32);
+	} else {
+		swapValues<uint64_t>(p, count, swap64);
+	}
+}
+
+///
+/// Deinterleaved Reads
+///
+
+static bool validAttributes(std::size_t stride, const std::vector<StreamAttribute>& attributes){
+	if(stride == 0) return false;
+	for(const StreamAttribute& a : attributes){
+		if(a.width != 1 && a.width != 2 && a.width != 4 && a.width != 8) return false;
+		if(a.offset > stride || a.width * a.count > stride - a.offset) return false;
+	}
+	return true;
+}
+
+template<std::size_t Size>
+static inline void gatherFixed(uint8_t* out, const uint8_t* in, std::size_t stride, std::size_t records){
+	for(std::size_t r = 0; r < records; r++, in += stride, out += Size){
+		memcpy(out, in, Size);
+	}
+}
+
+// Splits interleaved records at in into the attribute arrays, starting at output record
+// first, then swaps the newly written part of each array while it is still in cache
+static void deinterleave(const uint8_t* in, std::size_t stride, std::size_t records, std::size_t first, const std::vector<StreamAttribute>& attributes, bool swap){
+	for(const StreamAttribute& a : attributes){
+		std::size_t size = a.width * a.count;
+		uint8_t* out = (uint8_t*)a.out + first * size;
+		const uint8_t* src = in + a.offset;
+
+		// Common vertex attribute sizes get a constant size copy, which compiles to plain moves
+		switch(size){
+			case 2: gatherFixed<2>(out, src, stride, records); break;
+			case 4: gatherFixed<4>(out, src, stride, records); break;
+			case 8: gatherFixed<8>(out, src, stride, records); break;
+			case 12: gatherFixed<12>(out, src, stride, records); break;
+			case 16: gatherFixed<16>(out, src, stride, records); break;
+			default:
+				for(std::size_t r = 0; r < records; r++){
+					memcpy(out + r * size, src + r * stride, size);
+				}
+		}
+
+		if(swap) swapRun(out, a.width, records * a.count);
+	}
+}
+
+// Records are handled in blocks small enough for the source and output to stay in L1/L2
+static const std::size_t DeinterleaveBlockBytes = 0x8000;
+
+bool CStream::readAttributes(std::size_t stride, std::size_t count, const std::vector<StreamAttribute>& attributes){
+	if(!validAttributes(stride, attributes)) return false;
+	std::size_t position = tell();
+	std::size_t size = getSize();
+	if(position > size || count > (size - position) / stride) return false;
+
+	std::size_t block = DeinterleaveBlockBytes / stride;
+	if(block == 0) block = 1;
+	if(block > count) block = count;
+
+	std::vector<uint8_t> buffer(block * stride);
+	bool swap = getOrder() != getSystemEndianess();
+	for(std::size_t done = 0; done < count; done += block){
+		std::size_t records = (count - done < block ? count - done : block);
+		readBytesTo(buffer.data(), records * stride);
+		if(tell() != position + (done + records) * stride) return false;
+		deinterleave(buffer.data(), stride, records, done, attributes, swap);
+	}
+	return true;
+}
+
+bool CMemoryStream::readAttributes(std::size_t stride, std::size_t count, const std::vector<StreamAttribute>& attributes){
+	assert(mOpenMode == OpenMode::In);
+	if(!validAttributes(stride, attributes)) return false;
+	if(count > 0 && (count > mSize / stride || !ensure(stride * count))){
+		mError = StreamError::OutOfBounds;
+		return false;
+	}
+
+	std::size_t len = stride * count;
+	BSTREAM_STAT_READ(len);
+	const uint8_t* in = OffsetPointer<uint8_t>(mBuffer, mPosition);
+	BSTREAM_CHECKSUM(in, len);
+
+	std::size_t block = DeinterleaveBlockBytes / stride;
+	if(block == 0) block = 1;
+	bool swap = needsSwap(mPosition);
+	for(std::size_t done = 0; done < count; done += block){
+		std::size_t records = (count - done < block ? count - done : block);
+		deinterleave(in + done * stride, stride, records, done, attributes, swap);
+	}
+
+	mPosition += len;
+	return true;
+}
+
+// Validates the table and sets end to the byte after it, swapping only when swap is set
+bool CMemoryStream::swapRegion(std::size_t offset, const SwapLayout& layout, std::size_t& end, bool swap){
+	std::size_t recordSize = 0;
+	for(uint8_t width : layout.fields){
+		if(width != 1 && width != 2 && width != 4 && width != 8) return false;
+		recordSize += width;
+	}
+	std::size_t stride = (layout.stride ? layout.stride : recordSize);
+	if(layout.count == 0 || recordSize == 0){
+		end = offset;
+		return offset <= mSize;
+	}
+
+	end = offset + stride * (layout.count - 1) + recordSize;
+	if(stride < recordSize || end > mSize || end < offset) return false;
+	if(!swap) return true;
+	if(!prepareWrite(offset, end - offset)) return false;
+
+	// Collapse the record into runs of equally sized fields
+	std::vector<std::pair<std::size_t, std::size_t>> runs;
+	for(uint8_t width : layout.fields){
+		if(!runs.empty() && runs.back().first == width){
+			runs.back().second++;
+		} else {
+			runs.push_back({ width, 1 });
+		}
+	}
+
+	uint8_t* base = OffsetWritePointer<uint8_t>(mBuffer, offset);
+	if(runs.size() == 1 && stride == recordSize){
+		// Tightly packed table of one width, a single run covers every record
+		swapRun(base, runs[0].first, runs[0].second * layout.count);
+		return true;
+	}
+
+	for(std::size_t r = 0; r < layout.count; r++){
+		uint8_t* p = base + r * stride;
+		for(const std::pair<std::size_t, std::size_t>& run : runs){
+			swapRun(p, run.first, run.second);
+			p += run.first * run.second;
+		}
+	}
+	return true;
+}
+
+// True when at lies in the swapped fields of a record rather than in its padding
+static inline bool inNativeFields(std::size_t at, std::size_t start, std::size_t stride, std::size_t fields){
+	return stride == fields || (at - start) % stride < fields;
+}
+
+// Checks the range the last lookup hit before falling back to a binary search
+bool CMemoryStream::inNativeRange(std::size_t at){
+	if(mLastNativeRange < mNativeRanges.size()){
+		const NativeRange& last = mNativeRanges[mLastNativeRange];
+		if(at >= last.start && at < last.end) return inNativeFields(at, last.start, last.stride, last.fields);
+	}
+
+	auto next = std::upper_bound(mNativeRanges.begin(), mNativeRanges.end(), at, [](std::size_t v, const NativeRange& r){ return v < r.start; });
+	if(next == mNativeRanges.begin()) return false;
+	auto range = next - 1;
+	if(at >= range->end) return false;
+	mLastNativeRange = range - mNativeRanges.begin();
+	return inNativeFields(at, range->start, range->stride, range->fields);
+}
+
+// Sum of the field widths and the distance between records
+static void layoutSizes(const SwapLayout& layout, std::size_t& fields, std::size_t& stride){
+	fields = 0;
+	for(uint8_t width : layout.fields) fields += width;
+	stride = (layout.stride ? layout.stride : fields);
+}
+
+
+// Fails without touching anything if the region overlaps one that is already native
+bool CMemoryStream::convertToNative(std::size_t offset, const SwapLayout& layout){
+	std::size_t end;
+	if(!swapRegion(offset, layout, end, false)) return false;
+	if(order == systemOrder || end == offset) return true;
+
+	auto next = std::lower_bound(mNativeRanges.begin(), mNativeRanges.end(), offset, [](const NativeRange& r, std::size_t v){ return r.start < v; });
+	if(next != mNativeRanges.end() && next->start < end) return false;
+	if(next != mNativeRanges.begin() && (next - 1)->end > offset) return false;
+
+	if(!swapRegion(offset, layout, end, true)) return false;
+	std::size_t fields, stride;
+	layoutSizes(layout, fields, stride);
+	mNativeRanges.insert(next, { offset, end, stride, fields });
+	markDirty(offset, end - offset);
+	return true;
+}
+
+// Only a region recorded by convertToNative with the same offset and layout can be swapped back
+bool CMemoryStream::convertFromNative(std::size_t offset, const SwapLayout& layout){
+	std::size_t end;
+	if(!swapRegion(offset, layout, end, false)) return false;
+	if(order == systemOrder || end == offset) return true;
+
+	std::size_t fields, stride;
+	layoutSizes(layout, fields, stride);
+	auto range = std::lower_bound(mNativeRanges.begin(), mNativeRanges.end(), offset, [](const NativeRange& r, std::size_t v){ return r.start < v; });
+	if(range == mNativeRanges.end() || range->start != offset || range->end != end || range->stride != stride || range->fields != fields) return false;
+
+	if(!swapRegion(offset, layout, end, true)) return false;
+	mNativeRanges.erase(range);
+	markDirty(offset, end - offset);
+	return true;
+}
+
+///
+///
+///  Memstream Snapshots
+///
+///
+
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+
+// Slots of ChunkSize bytes in a memfd, reference counted by the views that map them. The lock
+// covers the counts and the free list, views of one store may live on different threads.
+class CChunkStore {
+	public:
+		static const std::size_t ChunkSize = 0x10000;
+
+		int mFd;
+		std::mutex mMutex;
+		std::vector<uint32_t> mRefs;
+		std::vector<uint32_t> mFree;
+		// Free slots whose old contents could not be punched out, cleared before reuse as a zeroed slot
+		std::vector<uint8_t> mStale;
+		std::size_t mFileSlots;
+
+		CChunkStore() : mFileSlots(0) {
+			mFd = memfd_create("bstream-snapshot", MFD_CLOEXEC);
+		}
+
+		~CChunkStore(){
+			if(mFd >= 0) close(mFd);
+		}
+
+		// Frees the slot's memory, leaving it reading as zeros
+		bool punch(uint32_t slot){
+#if defined(FALLOC_FL_PUNCH_HOLE)
+			return fallocate(mFd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, (off_t)slot * ChunkSize, ChunkSize) == 0;
+#else
+			return false;
+#endif
+		}
+
+		bool clear(uint32_t slot){
+			if(punch(slot)) return true;
+			static const uint8_t zeros[0x1000] = {};
+			for(std::size_t done = 0; done < ChunkSize; done += sizeof(zeros)){
+				if(pwrite(mFd, zeros, sizeof(zeros), (off_t)slot * ChunkSize + done) != (ssize_t)sizeof(zeros)) return false;
+			}
+			return true;
+		}
+
+		// Returns a slot holding one reference, or -1 if the store can't grow. The slot is zeroed
+		// unless the caller is about to overwrite all of it anyway. Needs the lock.
+		int64_t allocate(bool zeroed = true){
+			if(!mFree.empty()){
+				uint32_t slot = mFree.back();
+				if(zeroed && mStale[slot]){
+					if(!clear(slot)) return -1;
+					mStale[slot] = 0;
+				}
+				mFree.pop_back();
+				mRefs[slot] = 1;
+				return slot;
+			}
+
+			std::size_t slot = mRefs.size();
+			if(slot >= mFileSlots){
+				std::size_t slots = (mFileSlots * 2 > slot + 1 ? mFileSlots * 2 : slot + 1);
+				if(ftruncate(mFd, slots * ChunkSize) != 0) return -1;
+				mFileSlots = slots;
+			}
+			mRefs.push_back(1);
+			mStale.push_back(0);
+			return slot;
+		}
+
+		// Drops a reference, slots nobody maps anymore give their memory back and are reused. Needs the lock.
+		void release(uint32_t slot){
+			if(--mRefs[slot] > 0) return;
+			mStale[slot] = !punch(slot);
+			mFree.push_back(slot);
+		}
+};
+
+// Reserves address space for a view and maps every chunk into it, consecutive slots in one call
+uint8_t* CMemoryStream::mapChunks(std::size_t count){
+	const std::size_t chunk = CChunkStore::ChunkSize;
+	void* view = mmap(nullptr, count * chunk, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(view == MAP_FAILED) return nullptr;
+
+	for(std::size_t first = 0; first < count;){
+		std::size_t last = first + 1;
+		while(last < count && mChunkSlots[last] == mChunkSlots[last - 1] + 1) last++;
+
+		void* p = mmap((uint8_t*)view + first * chunk, (last - first) * chunk, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, mChunks->mFd, (off_t)mChunkSlots[first] * chunk);
+		if(p == MAP_FAILED){
+			munmap(view, count * chunk);
+			return nullptr;
+		}
+		first = last;
+	}
+	return (uint8_t*)view;
+}
+
+// Moves an ordinary internal buffer into a fresh store, this is the only full copy
+bool CMemoryStream::shareBuffer(){
+	const std::size_t chunk = CChunkStore::ChunkSize;
+	std::shared_ptr<CChunkStore> store = std::make_shared<CChunkStore>();
+	if(store->mFd < 0) return false;
+
+	std::size_t count = (mCapacity + chunk - 1) / chunk;
+	if(count == 0) count = 1;
+	{
+		std::lock_guard<std::mutex> lock(store->mMutex);
+		for(std::size_t i = 0; i < count; i++){
+			if(store->allocate() < 0) return false;
+		}
+	}
+
+	for(std::size_t done = 0; done < mSize;){
+		ssize_t n = pwrite(store->mFd, mBuffer + done, mSize - done, done);
+		if(n <= 0) return false;
+		done += n;
+	}
+
+	std::vector<uint32_t> slots(count);
+	for(std::size_t i = 0; i < count; i++) slots[i] = (uint32_t)i;
+
+	mChunks = store;
+	mChunkSlots.swap(slots);
+	uint8_t* view = mapChunks(count);
+	if(view == nullptr){
+		mChunks.reset();
+		mChunkSlots.clear();
+		return false;
+	}
+
+	releaseBuffer(mBuffer, mCapacity, mBufferMapped);
+	mBuffer = view;
+	mCapacity = count * chunk;
+	mBufferMapped = false;
+	mPool = nullptr;
+	mChunkOwned.assign(count, 1);
+	return true;
+}
+
+bool CMemoryStream::unshare(std::size_t at, std::size_t len){
+	if(len == 0) return true;
+	const std::size_t chunk = CChunkStore::ChunkSize;
+
+	std::size_t last = (at + len - 1) / chunk;
+	for(std::size_t c = at / chunk; c <= last && c < mChunkSlots.size(); c++){
+		if(mChunkOwned[c]) continue;
+
+		std::lock_guard<std::mutex> lock(mChunks->mMutex);
+		uint32_t slot = mChunkSlots[c];
+		if(mChunks->mRefs[slot] > 1){
+			// Copy the chunk into a slot of its own and map that over the shared one
+			int64_t fresh = mChunks->allocate(false);
+			if(fresh < 0) return false;
+
+			uint8_t* p = mBuffer + c * chunk;
+			bool copied = pwrite(mChunks->mFd, p, chunk, (off_t)fresh * chunk) == (ssize_t)chunk;
+			if(!copied || mmap(p, chunk, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, mChunks->mFd, (off_t)fresh * chunk) == MAP_FAILED){
+				mChunks->release((uint32_t)fresh);
+				return false;
+			}
+			mChunks->release(slot);
+			mChunkSlots[c] = (uint32_t)fresh;
+		}
+		mChunkOwned[c] = 1;
+	}
+	return true;
+}
+
+// New chunks come from fresh zeroed slots, existing ones are mapped again without copying
+bool CMemoryStream::growChunks(std::size_t capacity){
+	const std::size_t chunk = CChunkStore::ChunkSize;
+	std::size_t count = (capacity + chunk - 1) / chunk;
+	std::size_t old = mChunkSlots.size();
+	{
+		std::lock_guard<std::mutex> lock(mChunks->mMutex);
+		for(std::size_t c = old; c < count; c++){
+			int64_t slot = mChunks->allocate();
+			if(slot < 0){
+				for(std::size_t k = old; k < mChunkSlots.size(); k++) mChunks->release(mChunkSlots[k]);
+				mChunkSlots.resize(old);
+				return false;
+			}
+			mChunkSlots.push_back((uint32_t)slot);
+		}
+	}
+
+	uint8_t* view = mapChunks(count);
+	if(view == nullptr){
+		std::lock_guard<std::mutex> lock(mChunks->mMutex);
+		for(std::size_t k = old; k < mChunkSlots.size(); k++) mChunks->release(mChunkSlots[k]);
+		mChunkSlots.resize(old);
+		return false;
+	}
+
+	BSTREAM_STAT_GROW(0);
+	munmap(mBuffer, mCapacity);
+	mBuffer = view;
+	mCapacity = count * chunk;
+	mChunkOwned.resize(count, 1);
+	return true;
+}
+
+// Makes copy a second view of every chunk of this stream
+bool CMemoryStream::shareInto(CMemoryStream& copy){
+	copy.mChunks = mChunks;
+	copy.mChunkSlots = mChunkSlots;
+	{
+		std::lock_guard<std::mutex> lock(mChunks->mMutex);
+		for(uint32_t slot : mChunkSlots) mChunks->mRefs[slot]++;
+	}
+
+	copy.mBuffer = copy.mapChunks(mChunkSlots.size());
+	if(copy.mBuffer == nullptr){
+		std::lock_guard<std::mutex> lock(mChunks->mMutex);
+		for(uint32_t slot : mChunkSlots) mChunks->release(slot);
+		copy.mChunks.reset();
+		copy.mChunkSlots.clear();
+		return false;
+	}
+
+	// Every chunk is now shared, the next write on either side copies it
+	std::fill(mChunkOwned.begin(), mChunkOwned.end(), 0);
+	copy.mChunkOwned.assign(mChunkSlots.size(), 0);
+	copy.mCapacity = mCapacity;
+	copy.mHasInternalBuffer = true;
+	return true;
+}
+
+void CMemoryStream::releaseChunks(){
+	munmap(mBuffer, mCapacity);
+	{
+		std::lock_guard<std::mutex> lock(mChunks->mMutex);
+		for(uint32_t slot : mChunkSlots) mChunks->release(slot);
+	}
+	mChunks.reset();
+	mChunkSlots.clear();
+	mChunkOwned.clear();
+	mBuffer = nullptr;
+}
+
+#else
+
+class CChunkStore {};
+
+uint8_t* CMemoryStream::mapChunks(std::size_t){ return nullptr; }
+bool CMemoryStream::shareBuffer(){ return false; }
+bool CMemoryStream::shareInto(CMemoryStream&){ return false; }
+bool CMemoryStream::unshare(std::size_t, std::size_t){ return true; }
+bool CMemoryStream::growChunks(std::size_t){ return false; }
+void CMemoryStream::releaseChunks(){}
+
+#endif
+
+std::unique_ptr<CMemoryStream> CMemoryStream::snapshot(){
+	std::unique_ptr<CMemoryStream> copy;
+
+	if(!mChunks && mHasInternalBuffer) shareBuffer();
+
+	if(mChunks){
+		copy.reset(new CMemoryStream());
+		if(!shareInto(*copy)) copy.reset();
+	}
+
+	if(!copy){
+		copy.reset(new CMemoryStream(mSize, order, mOpenMode));
+		memcpy(copy->mBuffer, mBuffer, mSize);
+	}
+
+	copy->mPosition = mPosition;
+	copy->mSize = mSize;
+	copy->mOpenMode = mOpenMode;
+	copy->order = order;
+	copy->systemOrder = systemOrder;
+	copy->mNativeRanges = mNativeRanges;
+	return copy;
+}
+
+///
+/// Memstream Writing Functions
+///
+
+// Pooled buffers come back uncleared, heap and mapped ones are zeroed. capacity is updated to the real size.
+uint8_t* CMemoryStream::allocateBuffer(std::size_t& capacity){
+	mBufferMapped = false;
+	if(mPool != nullptr){
+		return mPool->acquire(capacity);
+	}
+#if defined(__unix__)
+	if(mBacking == PageBacking::HugePages){
+		uint8_t* buffer = allocateHugePages(capacity);
+		if(buffer != nullptr){
+			mBufferMapped = true;
+			return buffer;
+		}
+	}
+#endif
+	return new uint8_t[capacity]{};
+}
+
+void CMemoryStream::releaseBuffer(uint8_t* buffer, std::size_t capacity, bool mapped){
+#if defined(__unix__)
+	if(mapped){
+		munmap(buffer, capacity);
+		return;
+	}
+#endif
+	if(mPool != nullptr){
+		mPool->release(buffer, capacity);
+	} else {
+		delete[] buffer;
+	}
+}
+
+// Moves the contents into a new internal buffer of at least capacity bytes, the new space is zeroed
+void CMemoryStream::growBuffer(std::size_t capacity){
+	BSTREAM_STAT_GROW(mSize);
+	bool wasMapped = mBufferMapped;
+	uint8_t* temp = allocateBuffer(capacity);
+	memcpy(temp, mBuffer, mSize);
+	if(mPool != nullptr) memset(temp + mSize, 0, capacity - mSize);
+	releaseBuffer(mBuffer, mCapacity, wasMapped);
+	mBuffer = temp;
+	mCapacity = capacity;
+}
+
+bool CMemoryStream::setSize(std::size_t size) {
+	if(mCapacity >= size){
+		mSize = size;
+		return true;
+	}
+	if(!grow(size)){
+		return false;
+	}
+
+	mSize = size;
+
+	return true;
+}
+
+bool CMemoryStream::grow(std::size_t capacity){
+	if(mChunks){
+		return growChunks(capacity);
+	}
+	if(!mHasInternalBuffer){
+		return false;
+	}
+
+	growBuffer(capacity);
+	return true;
+}
+
+//included in writing functions because this is needed when using an internal buffer
+bool CMemoryStream::Reserve(std::size_t needed){
+	if(mCapacity >= needed){
+		return true;
+	}
+
+	// Grow geometrically for incremental writes, but a single large request gets exactly what it asked for
+	return grow(mCapacity * 2 > needed ? mCapacity * 2 : needed);
+}
+
+void CMemoryStream::writeInt8(int8_t v){
+	BSTREAM_STAT_WRITE(sizeof(int8_t));
+	if(!prepareWrite(mPosition, sizeof(v))) return;
+	memcpy(OffsetWritePointer<int8_t>(mBuffer, mPosition), &v, sizeof(int8_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int8_t));
+	mPosition += sizeof(int8_t);
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+void CMemoryStream::writeUInt8(uint8_t v){
+	BSTREAM_STAT_WRITE(sizeof(uint8_t));
+	if(!prepareWrite(mPosition, sizeof(v))) return;
+	memcpy(OffsetWritePointer<uint8_t>(mBuffer, mPosition), &v, sizeof(int8_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int8_t));
+	mPosition += sizeof(int8_t);
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+void CMemoryStream::writeInt16(int16_t v){
+	BSTREAM_STAT_WRITE(sizeof(int16_t));
+	if(!prepareWrite(mPosition, sizeof(v))) return;
+
+	if(needsSwap(mPosition))
+		v = swap16(v);
+
+	memcpy(OffsetWritePointer<int16_t>(mBuffer, mPosition), &v, sizeof(int16_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int16_t));
+	mPosition += sizeof(int16_t);
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+void CMemoryStream::writeUInt16(uint16_t v){
+	BSTREAM_STAT_WRITE(sizeof(uint16_t));
+	if(!prepareWrite(mPosition, sizeof(v))) return;
+
+	if(needsSwap(mPosition))
+		v = swap16(v);
+
+	memcpy(OffsetWritePointer<uint16_t>(mBuffer, mPosition), &v, sizeof(int16_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int16_t));
+	mPosition += sizeof(int16_t);
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+void CMemoryStream::writeInt32(int32_t v){
+	BSTREAM_STAT_WRITE(sizeof(int32_t));
+	if(!prepareWrite(mPosition, sizeof(v))) return;
+
+	if(needsSwap(mPosition))
+		v = swap32(v);
+
+	memcpy(OffsetWritePointer<int32_t>(mBuffer, mPosition), &v, sizeof(int32_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int32_t));
+	mPosition += sizeof(int32_t);
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+void CMemoryStream::writeInt64(int64_t v){
+	BSTREAM_STAT_WRITE(sizeof(int64_t));
+	if(!prepareWrite(mPosition, sizeof(v))) return;
+
+	if(needsSwap(mPosition))
+		v = swap64(v);
+
+	memcpy(OffsetWritePointer<int64_t>(mBuffer, mPosition), &v, sizeof(int64_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int64_t));
+	mPosition += sizeof(int64_t);
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+void CMemoryStream::writeUInt32(uint32_t v){
+	BSTREAM_STAT_WRITE(sizeof(uint32_t));
+	if(!prepareWrite(mPosition, sizeof(v))) return;
+
+	if(needsSwap(mPosition))
+		v = swap32(v);
+
+	memcpy(OffsetWritePointer<uint32_t>(mBuffer, mPosition), &v, sizeof(int32_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int32_t));
+	mPosition += sizeof(int32_t);
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+void CMemoryStream::writeUInt64(uint64_t v){
+	BSTREAM_STAT_WRITE(sizeof(uint64_t));
+	if(!prepareWrite(mPosition, sizeof(v))) return;
+
+	if(needsSwap(mPosition))
+		v = swap64(v);
+
+	memcpy(OffsetWritePointer<uint64_t>(mBuffer, mPosition), &v, sizeof(int64_t));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(int64_t));
+	mPosition += sizeof(int64_t);
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+void CMemoryStream::writeFloat(float v){
+	BSTREAM_STAT_WRITE(sizeof(float));
+	if(!prepareWrite(mPosition, sizeof(v))) return;
+
+	char* buff = (char*)&v;
+	if(needsSwap(mPosition)){
+		char temp[sizeof(float)];
+		temp[0] = buff[3];
+		temp[1] = buff[2];
+		temp[2] = buff[1];
+		temp[3] = buff[0];
+		v = *((float*)temp);
+	}
+
+	memcpy(OffsetWritePointer<float>(mBuffer, mPosition), &v, sizeof(float));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(float));
+	mPosition += sizeof(float);
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+
+void CMemoryStream::writeDouble(double v){
+	BSTREAM_STAT_WRITE(sizeof(double));
+	if(!prepareWrite(mPosition, sizeof(v))) return;
+
+	char* buff = (char*)&v;
+	if(needsSwap(mPosition)){
+		char temp[sizeof(double)];
+		temp[0] = buff[7];
+		temp[1] = buff[6];
+		temp[2] = buff[5];
+		temp[3] = buff[4];
 		temp[4] = buff[3];
 		temp[5] = buff[2];
 		temp[6] = buff[1];
 		temp[7] = buff[0];
-		return *((double*)temp);
+		v = *((double*)temp);
+	}
+
+	memcpy(OffsetWritePointer<double>(mBuffer, mPosition), &v, sizeof(double));
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(double));
+	mPosition += sizeof(double);
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+//TODO: Clean these up and test them more
+
+void CMemoryStream::writeBytes(uint8_t* bytes, std::size_t size){
+	BSTREAM_STAT_WRITE(size);
+	if(!prepareWrite(mPosition, size)) return;
+	memcpy(OffsetWritePointer<uint8_t>(mBuffer, mPosition), bytes, size);
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), size);
+	mPosition += size;
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+void CMemoryStream::writeString(std::string str){
+	BSTREAM_STAT_WRITE(str.size());
+	if(!prepareWrite(mPosition, str.size())) return;
+	memcpy(OffsetWritePointer<uint8_t>(mBuffer, mPosition), str.data(), str.size());
+	BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), str.size());
+	mPosition += str.size();
+	if(mPosition > mSize) mSize = mPosition;
+}
+
+// The encoded size is not known up front, so room for the worst case is reserved
+std::size_t CMemoryStream::writeStringSJIS(const char* str, std::size_t len){
+	if(!prepareWrite(mPosition, len)) return 0;
+	uint8_t* out = OffsetWritePointer<uint8_t>(mBuffer, mPosition);
+	std::size_t size = utf8ToSjis(str, len, out);
+	BSTREAM_STAT_WRITE(size);
+	BSTREAM_CHECKSUM(out, size);
+	markDirty(mPosition, size);
+	mPosition += size;
+	if(mPosition > mSize) mSize = mPosition;
+	return size;
+}
+
+std::size_t CMemoryStream::writeStringUTF16BE(const char* str, std::size_t len){
+	if(!prepareWrite(mPosition, len * 2)) return 0;
+	uint8_t* out = OffsetWritePointer<uint8_t>(mBuffer, mPosition);
+	std::size_t size = utf8ToUtf16be(str, len, out);
+	BSTREAM_STAT_WRITE(size);
+	BSTREAM_CHECKSUM(out, size);
+	markDirty(mPosition, size);
+	mPosition += size;
+	if(mPosition > mSize) mSize = mPosition;
+	return size;
+}
+
+void CMemoryStream::alignTo(std::size_t to){
+    std::size_t nextAligned = (-mPosition % to) % to;
+    BSTREAM_STAT_WRITE(nextAligned);
+    if(!prepareWrite(mPosition, nextAligned)) return;
+    memset(OffsetWritePointer<uint8_t>(mBuffer, mPosition), 0, nextAligned);
+    BSTREAM_CHECKSUM(OffsetPointer<uint8_t>(mBuffer, mPosition), nextAligned);
+    mPosition += nextAligned;
+    if(mPosition > mSize) mSize = mPosition;
+}
+
+void CMemoryStream::writeOffsetAt16(std::size_t at){
+	BSTREAM_STAT_WRITE(sizeof(uint16_t));
+	if(!prepareWrite(at, sizeof(uint16_t))) return;
+	uint16_t offset = mPosition & 0xFFFF;
+	if(needsSwap(at)){
+		offset = swap16(offset);
 	}
-	return *((double*)buff);
+	memcpy(OffsetWritePointer<uint16_t>(mBuffer, at), &offset, sizeof(uint16_t));
 }
 
-char* CFileStream::readBytes(std::size_t size){
-	assert(mode == OpenMode::In);
-	char* buffer = new char[size];
-	base.read(buffer, size);
-	return buffer;
+void CMemoryStream::writeOffsetAt32(std::size_t at){
+	BSTREAM_STAT_WRITE(sizeof(uint32_t));
+	if(!prepareWrite(at, sizeof(uint32_t))) return;
+	if(mPosition > 0xFFFFFFFF){
+		mError = StreamError::OffsetOverflow;
+		return;
+	}
+	uint32_t offset = mPosition;
+	if(needsSwap(at)){
+		offset = swap32(offset);
+	}
+	memcpy(OffsetWritePointer<uint32_t>(mBuffer, at), &offset, sizeof(uint32_t));
 }
 
-void CFileStream::readBytesTo(uint8_t* out_buffer, std::size_t len){
-	assert(mode == OpenMode::In);
-	base.read((char*)out_buffer, len);
+void CMemoryStream::writeOffsetAt64(std::size_t at){
+	BSTREAM_STAT_WRITE(sizeof(uint64_t));
+	if(!prepareWrite(at, sizeof(uint64_t))) return;
+	uint64_t offset = mPosition;
+	if(needsSwap(at)){
+		offset = swap64(offset);
+	}
+	memcpy(OffsetWritePointer<uint64_t>(mBuffer, at), &offset, sizeof(uint64_t));
 }
 
-std::string CFileStream::readString(std::size_t len){
-	assert(mode == OpenMode::In);
-    std::string str(len, '\0'); //creates string str at size of length and fills it with '\0'
-    base.read(&str[0], len);
-    return str;
+Endianess CMemoryStream::getOrder(){
+    return order;
 }
 
-std::string CFileStream::peekString(std::size_t at, std::size_t len){
-	assert(mode == OpenMode::In);
-    std::string str(len, '\0'); //creates string str at size of length and fills it with '\0'
-	std::size_t cur = base.tellg();
-	base.seekg(at, base.beg);
-    base.read(&str[0], len);
-	base.seekg(cur, base.beg);
-    return str;
+void CMemoryStream::setOrder(Endianess e){
+    order = e;
 }
 
-std::string CFileStream::readWString(std::size_t len){
-	assert(mode == OpenMode::In);
-    std::string str(len, '\0'); //creates string str at size of length and fills it with '\0'
-    base.read(&str[0], len);
-    return str;
+
+#if defined(__unix__)
+
+///
+///
+///  CMappedFileStream
+///
+///
+
+CMappedFileStream::CMappedFileStream(std::string path, Endianess ord, PageBacking backing) : CMappedFileStream(path, ord, OpenMode::In, backing) {}
+
+CMappedFileStream::CMappedFileStream(std::string path, Endianess ord, OpenMode mode, PageBacking backing){
+	filePath = path;
+	mBuffer = nullptr;
+	mPosition = 0;
+	mSize = 0;
+	mCapacity = 0;
+	mMappedSize = 0;
+	mHasInternalBuffer = false;
+	mOpenMode = mode;
+	mBacking = backing;
+	mWritable = mode == OpenMode::Out;
+	mReadOnly = !mWritable;
+	mPageSize = (std::size_t)sysconf(_SC_PAGESIZE);
+	mLastDirtyStart = 0;
+	mLastDirtyEnd = 0;
+	order = ord;
+	systemOrder = getSystemEndianess();
+
+	if(mWritable){
+		mFd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	} else {
+		mFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	}
+
+	struct stat st;
+	if(mFd >= 0 && fstat(mFd, &st) == 0){
+		map(st.st_size, mWritable ? PROT_READ | PROT_WRITE : PROT_READ, backing);
+	}
 }
 
-void CFileStream::writeInt8(int8_t v){
-	assert(mode == OpenMode::Out);
-	base.write((char*)&v, 1);
+CMappedFileStream::~CMappedFileStream(){
+	if(mWritable && mFd >= 0){
+		flush();
+		// Growth rounds the file up, cut it back to what was actually written
+		if(mMappedSize > mSize && ftruncate(mFd, mSize) != 0) {}
+	}
+	unmap();
+	if(mFd >= 0) close(mFd);
 }
 
-void CFileStream::writeUInt8(uint8_t v){
-	assert(mode == OpenMode::Out);
-	base.write((char*)&v, 1);
+bool CMappedFileStream::grow(std::size_t capacity){
+	if(!mWritable || mFd < 0) return false;
+	if(ftruncate(mFd, capacity) != 0) return false;
+
+	std::size_t size = mSize;
+	if(mBuffer == nullptr){
+		if(!map(capacity, PROT_READ | PROT_WRITE, mBacking)) return false;
+	} else {
+#if defined(__linux__)
+		void* p = mremap(mBuffer, mMappedSize, capacity, MREMAP_MAYMOVE);
+		if(p == MAP_FAILED) return false;
+		mBuffer = (uint8_t*)p;
+		mMappedSize = capacity;
+		mCapacity = capacity;
+#else
+		// Dirty pages are already in the file through the shared mapping, unmapping loses nothing
+		unmap();
+		if(!map(capacity, PROT_READ | PROT_WRITE, mBacking)) return false;
+#endif
+	}
+	mSize = size;
+
+	return true;
 }
 
-void CFileStream::writeInt16(int16_t v){
-	assert(mode == OpenMode::Out);
-	if(order != systemOrder){
-		v = swap16(v);
+bool CMappedFileStream::changeMode(OpenMode mode){
+	if(!mWritable){
+		return false;
+	}
+
+	mOpenMode = mode;
+
+	return true;
+}
+
+void CMappedFileStream::markDirty(std::size_t at, std::size_t len){
+	if(len == 0) return;
+
+	std::size_t start = at - at % mPageSize;
+	std::size_t end = at + len;
+	end += (mPageSize - end % mPageSize) % mPageSize;
+
+	// Runs of small writes land in the range the previous write already marked
+	if(start >= mLastDirtyStart && end <= mLastDirtyEnd) return;
+
+	std::map<std::size_t, std::size_t>::iterator it = mDirty.upper_bound(start);
+	if(it != mDirty.begin() && std::prev(it)->second >= start) --it;
+
+	while(it != mDirty.end() && it->first <= end){
+		if(it->first < start) start = it->first;
+		if(it->second > end) end = it->second;
+		it = mDirty.erase(it);
 	}
-	base.write((char*)&v, sizeof(uint16_t));
+
+	mDirty[start] = end;
+	mLastDirtyStart = start;
+	mLastDirtyEnd = end;
 }
 
-void CFileStream::writeUInt16(uint16_t v){
-	assert(mode == OpenMode::Out);
-	if(order != systemOrder){
-		v = swap16(v);
+bool CMappedFileStream::flush(){
+	bool ok = true;
+	for(const std::pair<const std::size_t, std::size_t>& range : mDirty){
+		if(range.first >= mMappedSize) continue;
+		std::size_t end = range.second < mMappedSize ? range.second : mMappedSize;
+		if(msync(mBuffer + range.first, end - range.first, MS_SYNC) != 0) ok = false;
+	}
+
+	mDirty.clear();
+	mLastDirtyStart = 0;
+	mLastDirtyEnd = 0;
+
+	return ok;
+}
+
+void CMappedFileStream::writeInt8(int8_t v){
+	std::size_t at = mPosition;
+	CMemoryStream::writeInt8(v);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeUInt8(uint8_t v){
+	std::size_t at = mPosition;
+	CMemoryStream::writeUInt8(v);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeInt16(int16_t v){
+	std::size_t at = mPosition;
+	CMemoryStream::writeInt16(v);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeUInt16(uint16_t v){
+	std::size_t at = mPosition;
+	CMemoryStream::writeUInt16(v);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeInt32(int32_t v){
+	std::size_t at = mPosition;
+	CMemoryStream::writeInt32(v);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeInt64(int64_t v){
+	std::size_t at = mPosition;
+	CMemoryStream::writeInt64(v);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeUInt32(uint32_t v){
+	std::size_t at = mPosition;
+	CMemoryStream::writeUInt32(v);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeUInt64(uint64_t v){
+	std::size_t at = mPosition;
+	CMemoryStream::writeUInt64(v);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeFloat(float v){
+	std::size_t at = mPosition;
+	CMemoryStream::writeFloat(v);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeDouble(double v){
+	std::size_t at = mPosition;
+	CMemoryStream::writeDouble(v);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeBytes(uint8_t* bytes, std::size_t size){
+	std::size_t at = mPosition;
+	CMemoryStream::writeBytes(bytes, size);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeString(std::string str){
+	std::size_t at = mPosition;
+	CMemoryStream::writeString(str);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::alignTo(std::size_t alignment){
+	std::size_t at = mPosition;
+	CMemoryStream::alignTo(alignment);
+	markDirty(at, mPosition - at);
+}
+
+void CMappedFileStream::writeOffsetAt16(std::size_t at){
+	CMemoryStream::writeOffsetAt16(at);
+	if(mWritable) markDirty(at, sizeof(uint16_t));
+}
+
+void CMappedFileStream::writeOffsetAt32(std::size_t at){
+	CMemoryStream::writeOffsetAt32(at);
+	if(mWritable) markDirty(at, sizeof(uint32_t));
+}
+
+void CMappedFileStream::writeOffsetAt64(std::size_t at){
+	CMemoryStream::writeOffsetAt64(at);
+	if(mWritable) markDirty(at, sizeof(uint64_t));
+}
+
+bool CMappedFileStream::map(std::size_t size, int protection, PageBacking backing){
+	if(size == 0) return true;
+
+	void* p = mmap(nullptr, size, protection, MAP_SHARED, mFd, 0);
+	if(p == MAP_FAILED) return false;
+
+#if defined(MADV_HUGEPAGE)
+	if(backing == PageBacking::HugePages) madvise(p, size, MADV_HUGEPAGE);
+#endif
+
+	mBuffer = (uint8_t*)p;
+	mMappedSize = size;
+	mSize = size;
+	mCapacity = size;
+	return true;
+}
+
+void CMappedFileStream::unmap(){
+	if(mBuffer != nullptr) munmap(mBuffer, mMappedSize);
+	mBuffer = nullptr;
+	mMappedSize = 0;
+}
+
+bool CMappedFileStream::isOpen(){
+	return mFd >= 0;
+}
+
+std::string CMappedFileStream::getPath(){
+	return filePath;
+}
+
+#endif
+
+///
+///
+///  CBufferPool
+///
+///
+
+CBufferPool::CBufferPool() : mMaxRetained(0x10000000), mAcquires(0), mHits(0), mRetained(0), mPeakRetained(0) {}
+
+// Thread caches have been handed back by now, only the shared lists are left
+CBufferPool::~CBufferPool(){
+	for(std::size_t i = 0; i < ClassCount; i++){
+		for(uint8_t* buffer : mShared[i]){
+			delete[] buffer;
+		}
+	}
+}
+
+CBufferPool& CBufferPool::instance(){
+	static CBufferPool pool;
+	return pool;
+}
+
+CBufferPool::ThreadCache& CBufferPool::threadCache(){
+	static thread_local ThreadCache cache;
+	return cache;
+}
+
+// Buffers left in an exiting thread's cache move to the shared lists
+CBufferPool::ThreadCache::~ThreadCache(){
+	CBufferPool& pool = CBufferPool::instance();
+	for(std::size_t i = 0; i < ClassCount; i++){
+		for(uint8_t* buffer : classes[i]){
+			std::size_t size = (std::size_t)1 << (i + MinClassShift);
+			pool.mRetained -= size;
+			if(!pool.releaseShared(buffer, size)) delete[] buffer;
+		}
+	}
+}
+
+std::size_t CBufferPool::classIndex(std::size_t size){
+	std::size_t shift = MinClassShift;
+	while(((std::size_t)1 << shift) < size) shift++;
+	return shift - MinClassShift;
+}
+
+void CBufferPool::retain(std::size_t bytes){
+	std::size_t now = (mRetained += bytes);
+	std::size_t peak = mPeakRetained;
+	while(now > peak && !mPeakRetained.compare_exchange_weak(peak, now)) {}
+}
+
+uint8_t* CBufferPool::acquire(std::size_t& capacity){
+	mAcquires++;
+	if(capacity > ((std::size_t)1 << MaxClassShift)){
+		return new uint8_t[capacity];
+	}
+
+	std::size_t index = classIndex(capacity);
+	capacity = (std::size_t)1 << (index + MinClassShift);
+
+	std::vector<uint8_t*>& local = threadCache().classes[index];
+	if(!local.empty()){
+		uint8_t* buffer = local.back();
+		local.pop_back();
+		mRetained -= capacity;
+		mHits++;
+		return buffer;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		if(!mShared[index].empty()){
+			uint8_t* buffer = mShared[index].back();
+			mShared[index].pop_back();
+			mRetained -= capacity;
+			mHits++;
+			return buffer;
+		}
+	}
+
+	return new uint8_t[capacity];
+}
+
+bool CBufferPool::releaseShared(uint8_t* buffer, std::size_t capacity){
+	std::lock_guard<std::mutex> lock(mLock);
+	if(mRetained + capacity > mMaxRetained) return false;
+	mShared[classIndex(capacity)].push_back(buffer);
+	retain(capacity);
+	return true;
+}
+
+void CBufferPool::release(uint8_t* buffer, std::size_t capacity){
+	if(capacity > ((std::size_t)1 << MaxClassShift) || capacity != ((std::size_t)1 << (classIndex(capacity) + MinClassShift))){
+		delete[] buffer;
+		return;
+	}
+
+	std::vector<uint8_t*>& local = threadCache().classes[classIndex(capacity)];
+	if(local.size() < ThreadCacheDepth && mRetained + capacity <= mMaxRetained){
+		local.push_back(buffer);
+		retain(capacity);
+		return;
+	}
+
+	if(!releaseShared(buffer, capacity)) delete[] buffer;
+}
+
+void CBufferPool::setMaxRetained(std::size_t bytes){
+	mMaxRetained = bytes;
+}
+
+void CBufferPool::trim(){
+	ThreadCache& cache = threadCache();
+	std::lock_guard<std::mutex> lock(mLock);
+	for(std::size_t i = 0; i < ClassCount; i++){
+		std::size_t size = (std::size_t)1 << (i + MinClassShift);
+		for(uint8_t* buffer : cache.classes[i]){
+			mRetained -= size;
+			delete[] buffer;
+		}
+		for(uint8_t* buffer : mShared[i]){
+			mRetained -= size;
+			delete[] buffer;
+		}
+		cache.classes[i].clear();
+		mShared[i].clear();
 	}
-	base.write((char*)&v, sizeof(uint16_t));
 }
 
-void CFileStream::writeInt32(int32_t v){
-	assert(mode == OpenMode::Out);
-	if(order != systemOrder){
-	   v = swap32(v);
-	}
-	base.write((char*)&v, sizeof(int32_t));
+CBufferPool::Stats CBufferPool::getStats(){
+	Stats stats;
+	stats.acquires = mAcquires;
+	stats.hits = mHits;
+	stats.hitRate = (stats.acquires ? (double)stats.hits / stats.acquires : 0.0);
+	stats.retainedBytes = mRetained;
+	stats.peakRetainedBytes = mPeakRetained;
+	return stats;
+}
+
+///
+///
+///  CCountingStream
+///
+///
+
+bool CCountingStream::seek(std::size_t pos, bool fromCurrent){
+	mPosition = (fromCurrent ? mPosition + pos : pos);
+	if(mPosition > mSize) mSize = mPosition;
+	return true;
+}
+
+void CCountingStream::skip(std::size_t amount){
+	advance(amount);
+}
+
+std::size_t CCountingStream::tell(){
+	return mPosition;
+}
+
+std::size_t CCountingStream::getSize(){
+	return mSize;
+}
+
+std::size_t CCountingStream::getMaxAlignment(){
+	return mMaxAlignment;
+}
+
+const std::vector<OffsetPatch>& CCountingStream::getPatches(){
+	return mPatches;
+}
+
+void CCountingStream::reset(){
+	mPosition = 0;
+	mSize = 0;
+	mMaxAlignment = 1;
+	mPatches.clear();
+	mError = StreamError::NoError;
+}
+
+uint8_t CCountingStream::readUInt8(){
+	advance(sizeof(uint8_t));
+	return 0;
+}
+
+uint16_t CCountingStream::readUInt16(){
+	advance(sizeof(uint16_t));
+	return 0;
+}
+
+uint32_t CCountingStream::readUInt32(){
+	advance(sizeof(uint32_t));
+	return 0;
+}
+
+uint64_t CCountingStream::readUInt64(){
+	advance(sizeof(uint64_t));
+	return 0;
+}
+
+int8_t CCountingStream::readInt8(){
+	advance(sizeof(int8_t));
+	return 0;
+}
+
+int16_t CCountingStream::readInt16(){
+	advance(sizeof(int16_t));
+	return 0;
+}
+
+int32_t CCountingStream::readInt32(){
+	advance(sizeof(int32_t));
+	return 0;
+}
+
+int64_t CCountingStream::readInt64(){
+	advance(sizeof(int64_t));
+	return 0;
+}
+
+float CCountingStream::readFloat(){
+	advance(sizeof(float));
+	return 0.0f;
+}
+
+double CCountingStream::readDouble(){
+	advance(sizeof(double));
+	return 0.0;
+}
+
+int8_t CCountingStream::peekInt8(std::size_t){
+	return 0;
+}
+
+uint8_t CCountingStream::peekUInt8(std::size_t){
+	return 0;
+}
+
+int16_t CCountingStream::peekInt16(std::size_t){
+	return 0;
+}
+
+uint16_t CCountingStream::peekUInt16(std::size_t){
+	return 0;
+}
+
+int32_t CCountingStream::peekInt32(std::size_t){
+	return 0;
+}
+
+int64_t CCountingStream::peekInt64(std::size_t){
+	return 0;
+}
+
+uint32_t CCountingStream::peekUInt32(std::size_t){
+	return 0;
+}
+
+uint64_t CCountingStream::peekUInt64(std::size_t){
+	return 0;
+}
+
+void CCountingStream::writeInt8(int8_t){
+	advance(sizeof(int8_t));
 }
 
-void CFileStream::writeUInt32(uint32_t v){
-	assert(mode == OpenMode::Out);
-	if(order != systemOrder){
-	   v = swap32(v);
-	}
-	base.write((char*)&v, sizeof(uint32_t));
+void CCountingStream::writeUInt8(uint8_t){
+	advance(sizeof(uint8_t));
 }
 
-void CFileStream::writeFloat(float v){
-	assert(mode == OpenMode::Out);
-	char* buff = (char*)&v;
-	if(order != systemOrder){
-		char temp[sizeof(float)];
-		temp[0] = buff[3];
-		temp[1] = buff[2];
-		temp[2] = buff[1];
-		temp[3] = buff[0];
-		v = *((float*)temp);
-	}
-	base.write((char*)&v, sizeof(float));
+void CCountingStream::writeInt16(int16_t){
+	advance(sizeof(int16_t));
 }
 
-void CFileStream::writeDouble(double v){
-	assert(mode == OpenMode::Out);
-	char* buff = (char*)&v;
-	if(order != systemOrder){
-		char temp[sizeof(double)];
-		temp[0] = buff[7];
-		temp[1] = buff[6];
-		temp[2] = buff[5];
-		temp[3] = buff[4];
-		temp[4] = buff[3];
-		temp[5] = buff[2];
-		temp[6] = buff[1];
-		temp[7] = buff[0];
-		v = *((double*)temp);
-	}
-	base.write((char*)&v, sizeof(double));
+void CCountingStream::writeUInt16(uint16_t){
+	advance(sizeof(uint16_t));
 }
 
+void CCountingStream::writeInt32(int32_t){
+	advance(sizeof(int32_t));
+}
 
-void CFileStream::alignTo(std::size_t to){
-    std::size_t nextAligned = (-base.tellg() % to) % to;
-    for(int i = 0; i < nextAligned; i++) writeUInt8(0);
+void CCountingStream::writeInt64(int64_t){
+	advance(sizeof(int64_t));
 }
 
-void CFileStream::writeOffsetAt16(std::size_t at){
-	assert(mode == OpenMode::Out);
-	uint32_t offset = base.tellg();
-	uint16_t writeOffset = offset & 0xFFFF;
-	if(order != systemOrder){
-		writeOffset = swap16(writeOffset);
-	}
-	base.seekg(at);
-	base.write((char*)&writeOffset, sizeof(uint32_t));
-	base.seekg(offset);
+void CCountingStream::writeUInt32(uint32_t){
+	advance(sizeof(uint32_t));
 }
 
-void CFileStream::writeOffsetAt32(std::size_t at){
-	assert(mode == OpenMode::Out);
-	uint32_t offset = base.tellg();
-	uint32_t writeOffset = offset;
-	if(order != systemOrder){
-		writeOffset = swap32(writeOffset);
-	}
-	base.seekg(at);
-	base.write((char*)&writeOffset, sizeof(uint32_t));
-	base.seekg(offset);
+void CCountingStream::writeUInt64(uint64_t){
+	advance(sizeof(uint64_t));
 }
 
-Endianess CFileStream::getOrder(){
-    return order;
+void CCountingStream::writeFloat(float){
+	advance(sizeof(float));
 }
 
-void CFileStream::setOrder(Endianess e){
-    order = e;
+void CCountingStream::writeDouble(double){
+	advance(sizeof(double));
 }
 
-void CFileStream::writeString(std::string v){
-	assert(mode == OpenMode::Out);
-	base.write(v.c_str(), v.size());
+void CCountingStream::readBytesTo(uint8_t* out_buffer, std::size_t len){
+	memset(out_buffer, 0, len);
+	advance(len);
 }
 
-void CFileStream::writeBytes(uint8_t* v, std::size_t size){
-	assert(mode == OpenMode::Out);
-	base.write((char*)v, size);
+void CCountingStream::writeBytes(uint8_t*, std::size_t size){
+	advance(size);
 }
 
-uint8_t CFileStream::peekUInt8(std::size_t offset){
-	assert(mode == OpenMode::In);
-	uint8_t ret;
-	int pos = (int)base.tellg();
-	base.seekg(offset, base.beg);
-	ret = readUInt8();
-	base.seekg(pos, base.beg);
-	return ret;
+void CCountingStream::alignTo(std::size_t to){
+	if(to > mMaxAlignment) mMaxAlignment = to;
+	advance((to - mPosition % to) % to);
 }
 
-int8_t CFileStream::peekInt8(std::size_t offset){
-	assert(mode == OpenMode::In);
-	int8_t ret;
-	int pos = (int)base.tellg();
-	base.seekg(offset, base.beg);
-	ret = readInt8();
-	base.seekg(pos, base.beg);
-	return ret;
+void CCountingStream::writeOffsetAt16(std::size_t at){
+	mPatches.push_back({ at, mPosition & 0xFFFF, sizeof(uint16_t) });
 }
 
-uint16_t CFileStream::peekUInt16(std::size_t offset){
-	assert(mode == OpenMode::In);
-	uint16_t ret;
-	int pos = (int)base.tellg();
-	base.seekg(offset, base.beg);
-	ret = readUInt16();
-	base.seekg(pos, base.beg);
-	return ret;
+void CCountingStream::writeOffsetAt32(std::size_t at){
+	if(mPosition > 0xFFFFFFFF){
+		mError = StreamError::OffsetOverflow;
+		return;
+	}
+	mPatches.push_back({ at, mPosition, sizeof(uint32_t) });
 }
 
-int16_t CFileStream::peekInt16(std::size_t offset){
-	assert(mode == OpenMode::In);
-	int16_t ret;
-	int pos = (int)base.tellg();
-	base.seekg(offset, base.beg);
-	ret = readInt16();
-	base.seekg(pos, base.beg);
-	return ret;
+void CCountingStream::writeOffsetAt64(std::size_t at){
+	mPatches.push_back({ at, mPosition, sizeof(uint64_t) });
 }
 
-uint32_t CFileStream::peekUInt32(std::size_t offset){
-	assert(mode == OpenMode::In);
-	uint32_t ret;
-	int pos = (int)base.tellg();
-	base.seekg(offset, base.beg);
-	ret = readUInt32();
-	base.seekg(pos, base.beg);
-	return ret;
+void CCountingStream::writeString(std::string v){
+	advance(v.size());
 }
 
-int32_t CFileStream::peekInt32(std::size_t offset){
-	assert(mode == OpenMode::In);
-	int32_t ret;
-	int pos = (int)base.tellg();
-	base.seekg(offset, base.beg);
-	ret = readInt32();
-	base.seekg(pos, base.beg);
-	return ret;
+std::string CCountingStream::peekString(std::size_t, std::size_t len){
+	return std::string(len, '\0');
 }
 
-std::size_t CFileStream::getSize(){
-	int pos = (int)base.tellg();
-	base.seekg(0, std::ios::end);
-	std::size_t ret = base.tellg();
-	base.seekg(pos, std::ios::beg);
-	return ret;
+std::string CCountingStream::readString(std::size_t len){
+	advance(len);
+	return std::string(len, '\0');
+}
+
+Endianess CCountingStream::getOrder(){
+	return order;
+}
+
+void CCountingStream::setOrder(Endianess e){
+	order = e;
 }
 
 ///
 ///
-///  CMemoryStream
+///  CTraceLog
 ///
 ///
 
+void CTraceLog::record(TraceOp op, std::size_t offset, std::size_t length){
+	mEntries.push_back({ offset, length, op });
+}
 
-CMemoryStream::CMemoryStream(uint8_t* ptr, std::size_t size, Endianess ord, OpenMode mode){
-	mBuffer = ptr;
-	mPosition = 0;
-	mSize = size;
-	mCapacity = size;
-	mHasInternalBuffer = false;
-	mOpenMode = mode;
-	order = ord;
-	systemOrder = getSystemEndianess();
+void CTraceLog::clear(){
+	mEntries.clear();
 }
 
-CMemoryStream::CMemoryStream(std::size_t size, Endianess ord, OpenMode mode){
-	mBuffer = new uint8_t[size]{};
-	mPosition = 0;
-	mSize = size;
-	mCapacity = size;
-	mHasInternalBuffer = true;
-	mOpenMode = mode;
-	order = ord;
-	systemOrder = getSystemEndianess();
+const std::vector<TraceEntry>& CTraceLog::getEntries(){
+	return mEntries;
 }
 
-std::size_t CMemoryStream::getSize(){
-	return mSize;
+static void writeVarint(CStream& out, uint64_t v){
+	while(v >= 0x80){
+		out.writeUInt8((v & 0x7F) | 0x80);
+		v >>= 7;
+	}
+	out.writeUInt8(v);
 }
 
-std::size_t CMemoryStream::getCapacity(){
-	return mCapacity;
+// Fails if the value runs past the bytes left in the stream or doesn't fit in 64 bits
+static bool readVarint(CStream& in, std::size_t& left, uint64_t& v){
+	v = 0;
+	for(int shift = 0; shift < 64 && left > 0; shift += 7){
+		uint8_t b = in.readUInt8();
+		left--;
+		v |= (uint64_t)(b & 0x7F) << shift;
+		if(!(b & 0x80)) return true;
+	}
+	return false;
 }
 
-// Allow for changing from read to write mode ONLY if we have an internal buffer.
-bool CMemoryStream::changeMode(OpenMode mode){
-	if(!mHasInternalBuffer){
-		return false;
+// Layout: "BSTR", varint entry count, then per entry the op, the zigzag encoded distance from
+// the end of the previous access and the length
+void CTraceLog::save(CStream& out){
+	out.writeString("BSTR");
+	writeVarint(out, mEntries.size());
+
+	std::size_t last = 0;
+	for(const TraceEntry& e : mEntries){
+		int64_t delta = (int64_t)e.offset - (int64_t)last;
+		out.writeUInt8(e.op);
+		writeVarint(out, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+		writeVarint(out, e.length);
+		last = e.offset + e.length;
 	}
+}
 
-	mOpenMode = mode;
+// The entry count is checked against the bytes left before anything is reserved, so a corrupt
+// or truncated log fails cleanly and leaves the log empty
+bool CTraceLog::load(CStream& in){
+	mEntries.clear();
+
+	std::size_t size = in.getSize();
+	std::size_t start = in.tell();
+	if(start > size || size - start < 4) return false;
+	std::size_t left = size - start - 4;
+	if(in.readString(4) != "BSTR") return false;
+
+	// Every entry takes at least three bytes, an op and two varints
+	uint64_t count;
+	if(!readVarint(in, left, count) || count > left / 3) return false;
+	mEntries.reserve(count);
+
+	std::size_t last = 0;
+	for(std::size_t i = 0; i < count; i++){
+		uint64_t zigzag, length;
+		if(left == 0) break;
+		TraceOp op = (TraceOp)in.readUInt8();
+		left--;
+		if(op > TraceSeek || !readVarint(in, left, zigzag) || !readVarint(in, left, length)) break;
+		int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+		mEntries.push_back({ (std::size_t)((int64_t)last + delta), (std::size_t)length, op });
+		last = mEntries.back().offset + length;
+	}
 
+	if(mEntries.size() != count){
+		mEntries.clear();
+		return false;
+	}
 	return true;
 }
 
-bool CMemoryStream::seek(std::size_t pos, bool fromCurrent){
-	if(fromCurrent && mPosition + pos > mCapacity || pos > mCapacity) return false;
+TraceStats CTraceLog::analyze(std::size_t blockSize, std::size_t topRanges){
+	TraceStats stats;
+	stats.seekHistogram.resize(65, 0);
+
+	// Byte ranges that have already been read, keyed by start, merged as they grow
+	std::map<std::size_t, std::size_t> covered;
+	std::map<std::size_t, std::size_t> blockHits;
+	std::size_t last = 0;
+	bool first = true;
+
+	for(const TraceEntry& e : mEntries){
+		switch(e.op){
+			case TraceRead: stats.reads++; break;
+			case TraceWrite: stats.writes++; break;
+			case TracePeek: stats.peeks++; break;
+			case TraceSeek: stats.seeks++; continue;
+		}
 
-	if(fromCurrent){
-		mPosition += pos;
-	} else {
-		mPosition = pos;
+		if(!first){
+			std::size_t distance = (e.offset > last ? e.offset - last : last - e.offset);
+			std::size_t bucket = 0;
+			while(distance){
+				bucket++;
+				distance >>= 1;
+			}
+			stats.seekHistogram[bucket]++;
+		}
+		first = false;
+		last = e.offset + e.length;
+
+		if(e.length == 0) continue;
+
+		for(std::size_t b = e.offset / blockSize; b <= (e.offset + e.length - 1) / blockSize; b++){
+			blockHits[b]++;
+		}
+
+		if(e.op == TraceWrite) continue;
+
+		std::size_t start = e.offset;
+		std::size_t end = e.offset + e.length;
+		stats.bytesRead += e.length;
+
+		auto it = covered.upper_bound(start);
+		if(it != covered.begin()) --it;
+		while(it != covered.end() && it->first <= end){
+			if(it->second < start){
+				++it;
+				continue;
+			}
+			std::size_t overlapStart = std::max(start, it->first);
+			std::size_t overlapEnd = std::min(end, it->second);
+			if(overlapEnd > overlapStart) stats.bytesReRead += overlapEnd - overlapStart;
+			start = std::min(start, it->first);
+			end = std::max(end, it->second);
+			it = covered.erase(it);
+		}
+		covered[start] = end;
 	}
 
-	if(mPosition > mSize) mSize = mPosition;
+	while(!stats.seekHistogram.empty() && stats.seekHistogram.back() == 0) stats.seekHistogram.pop_back();
+	stats.reReadRatio = (stats.bytesRead ? (double)stats.bytesReRead / stats.bytesRead : 0.0);
 
-	return true;
-}
+	for(auto& hit : blockHits){
+		stats.hotRanges.push_back({ hit.first * blockSize, blockSize, hit.second });
+	}
+	std::sort(stats.hotRanges.begin(), stats.hotRanges.end(), [](const TraceRange& a, const TraceRange& b){
+		return a.accesses > b.accesses;
+	});
+	if(stats.hotRanges.size() > topRanges) stats.hotRanges.resize(topRanges);
 
-void CMemoryStream::skip(std::size_t amount){
-	mPosition += (mPosition + amount < mSize ? amount : 0);
+	return stats;
 }
 
-std::size_t CMemoryStream::tell(){
-	return mPosition;
+uint64_t CTraceLog::replay(CStream& stream){
+	std::vector<uint8_t> scratch;
+	auto start = std::chrono::steady_clock::now();
+
+	for(const TraceEntry& e : mEntries){
+		if(e.op != TraceRead && e.op != TracePeek) continue;
+		if(scratch.size() < e.length) scratch.resize(e.length);
+		stream.seek(e.offset);
+		stream.readBytesTo(scratch.data(), e.length);
+	}
+
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
 }
 
-uint8_t* CMemoryStream::getBuffer(){
-	return mBuffer;
+void TraceStats::dump(std::ostream& out){
+	out << reads << " reads, " << writes << " writes, " << peeks << " peeks, " << seeks << " seeks" << std::endl;
+	out << bytesRead << " bytes read, " << bytesReRead << " re-read (" << (reReadRatio * 100.0) << "%)" << std::endl;
+	out << "seek distances:" << std::endl;
+	for(std::size_t i = 0; i < seekHistogram.size(); i++){
+		if(seekHistogram[i] == 0) continue;
+		if(i == 0){
+			out << "  sequential: " << seekHistogram[i] << std::endl;
+		} else {
+			out << "  < " << ((uint64_t)1 << i) << ": " << seekHistogram[i] << std::endl;
+		}
+	}
+	out << "hot ranges:" << std::endl;
+	for(const TraceRange& r : hotRanges){
+		out << "  0x" << std::hex << r.offset << "-0x" << (r.offset + r.length) << std::dec << ": " << r.accesses << std::endl;
+	}
 }
 
 ///
-/// Memstream Reading Functions
+///
+///  CTraceStream
+///
 ///
 
-int8_t CMemoryStream::readInt8(){
-	assert(mOpenMode == OpenMode::In && mPosition < mSize);
-	int8_t r;
-	memcpy(&r, OffsetPointer<int8_t>(mBuffer, mPosition), sizeof(int8_t));
-	mPosition++;
-	return r;
+CTraceLog& CTraceStream::getLog(){
+	return mLog;
 }
 
-uint8_t CMemoryStream::readUInt8(){
-	assert(mOpenMode == OpenMode::In);
-	uint8_t r;
-	memcpy(&r, OffsetPointer<uint8_t>(mBuffer, mPosition), sizeof(uint8_t));
-	mPosition++;
+bool CTraceStream::seek(std::size_t pos, bool fromCurrent){
+	bool r = mTarget.seek(pos, fromCurrent);
+	mLog.record(TraceSeek, mTarget.tell(), 0);
 	return r;
 }
 
-int16_t CMemoryStream::readInt16(){
-	assert(mOpenMode == OpenMode::In && mPosition < mSize);
-	int16_t r;
-	memcpy(&r, OffsetPointer<int16_t>(mBuffer, mPosition), sizeof(int16_t));
-	mPosition += sizeof(int16_t);
+void CTraceStream::skip(std::size_t amount){
+	mTarget.skip(amount);
+	mLog.record(TraceSeek, mTarget.tell(), 0);
+}
 
-	if(order != systemOrder){
-		return swap16(r);
-	}
-	else{
-		return r;
-	}
+std::size_t CTraceStream::tell(){
+	return mTarget.tell();
 }
 
-uint16_t CMemoryStream::readUInt16(){
-	assert(mOpenMode == OpenMode::In && mPosition < mSize);
-	uint16_t r;
-	memcpy(&r, OffsetPointer<uint16_t>(mBuffer, mPosition), sizeof(uint16_t));
-	mPosition += sizeof(uint16_t);
+std::size_t CTraceStream::getSize(){
+	return mTarget.getSize();
+}
 
-	if(order != systemOrder){
-		return swap16(r);
-	}
-	else{
-		return r;
-	}
+uint8_t CTraceStream::readUInt8(){
+	mLog.record(TraceRead, mTarget.tell(), sizeof(uint8_t));
+	return mTarget.readUInt8();
 }
 
-uint32_t CMemoryStream::readUInt32(){
-	assert(mOpenMode == OpenMode::In && mPosition < mSize);
-	uint32_t r;
-	memcpy(&r, OffsetPointer<uint32_t>(mBuffer, mPosition), sizeof(uint32_t));
-	mPosition += sizeof(uint32_t);
+uint16_t CTraceStream::readUInt16(){
+	mLog.record(TraceRead, mTarget.tell(), sizeof(uint16_t));
+	return mTarget.readUInt16();
+}
 
-	if(order != systemOrder){
-		return swap32(r);
-	}
-	else{
-		return r;
-	}
+uint32_t CTraceStream::readUInt32(){
+	mLog.record(TraceRead, mTarget.tell(), sizeof(uint32_t));
+	return mTarget.readUInt32();
 }
 
-int32_t CMemoryStream::readInt32(){
-	assert(mOpenMode == OpenMode::In && mPosition < mSize);
-	int32_t r;
-	memcpy(&r, OffsetPointer<int32_t>(mBuffer, mPosition), sizeof(int32_t));
-	mPosition += sizeof(int32_t);
+uint64_t CTraceStream::readUInt64(){
+	mLog.record(TraceRead, mTarget.tell(), sizeof(uint64_t));
+	return mTarget.readUInt64();
+}
 
-	if(order != systemOrder){
-		return swap32(r);
-	}
-	else{
-		return r;
-	}
+int8_t CTraceStream::readInt8(){
+	mLog.record(TraceRead, mTarget.tell(), sizeof(int8_t));
+	return mTarget.readInt8();
 }
 
+int16_t CTraceStream::readInt16(){
+	mLog.record(TraceRead, mTarget.tell(), sizeof(int16_t));
+	return mTarget.readInt16();
+}
 
-float CMemoryStream::readFloat(){
-	assert(mOpenMode == OpenMode::In && mPosition < mSize);
+int32_t CTraceStream::readInt32(){
+	mLog.record(TraceRead, mTarget.tell(), sizeof(int32_t));
+	return mTarget.readInt32();
+}
 
-	char buff[sizeof(float)];
-	memcpy(&buff, OffsetPointer<int32_t>(mBuffer, mPosition), sizeof(float));
-	mPosition += sizeof(float);
-	if(order != systemOrder){
-		char temp[sizeof(float)];
-		temp[0] = buff[3];
-		temp[1] = buff[2];
-		temp[2] = buff[1];
-		temp[3] = buff[0];
-		return *((float*)temp);
-	}
+int64_t CTraceStream::readInt64(){
+	mLog.record(TraceRead, mTarget.tell(), sizeof(int64_t));
+	return mTarget.readInt64();
+}
+
+float CTraceStream::readFloat(){
+	mLog.record(TraceRead, mTarget.tell(), sizeof(float));
+	return mTarget.readFloat();
+}
+
+double CTraceStream::readDouble(){
+	mLog.record(TraceRead, mTarget.tell(), sizeof(double));
+	return mTarget.readDouble();
+}
+
+int8_t CTraceStream::peekInt8(std::size_t at){
+	mLog.record(TracePeek, at, sizeof(int8_t));
+	return mTarget.peekInt8(at);
+}
+
+uint8_t CTraceStream::peekUInt8(std::size_t at){
+	mLog.record(TracePeek, at, sizeof(uint8_t));
+	return mTarget.peekUInt8(at);
+}
+
+int16_t CTraceStream::peekInt16(std::size_t at){
+	mLog.record(TracePeek, at, sizeof(int16_t));
+	return mTarget.peekInt16(at);
+}
+
+uint16_t CTraceStream::peekUInt16(std::size_t at){
+	mLog.record(TracePeek, at, sizeof(uint16_t));
+	return mTarget.peekUInt16(at);
+}
+
+int32_t CTraceStream::peekInt32(std::size_t at){
+	mLog.record(TracePeek, at, sizeof(int32_t));
+	return mTarget.peekInt32(at);
+}
 
-	else{
-		return *((float*)buff);
-	}
+int64_t CTraceStream::peekInt64(std::size_t at){
+	mLog.record(TracePeek, at, sizeof(int64_t));
+	return mTarget.peekInt64(at);
 }
 
-double CMemoryStream::readDouble(){
-	assert(mOpenMode == OpenMode::In && mPosition < mSize);
+uint32_t CTraceStream::peekUInt32(std::size_t at){
+	mLog.record(TracePeek, at, sizeof(uint32_t));
+	return mTarget.peekUInt32(at);
+}
 
-	char buff[sizeof(double)];
-	memcpy(&buff, OffsetPointer<double>(mBuffer, mPosition), sizeof(float));
-	mPosition += sizeof(double);
-	if(order != systemOrder){
-		char temp[sizeof(double)];
-		temp[0] = buff[3];
-		temp[1] = buff[2];
-		temp[2] = buff[1];
-		temp[3] = buff[0];
-		return *((double*)temp);
-	}
+uint64_t CTraceStream::peekUInt64(std::size_t at){
+	mLog.record(TracePeek, at, sizeof(uint64_t));
+	return mTarget.peekUInt64(at);
+}
 
-	else{
-		return *((double*)buff);
-	}
+void CTraceStream::writeInt8(int8_t v){
+	mLog.record(TraceWrite, mTarget.tell(), sizeof(int8_t));
+	mTarget.writeInt8(v);
 }
 
-///
-/// Memstream Peek Functions
-///
+void CTraceStream::writeUInt8(uint8_t v){
+	mLog.record(TraceWrite, mTarget.tell(), sizeof(uint8_t));
+	mTarget.writeUInt8(v);
+}
 
-int8_t CMemoryStream::peekInt8(std::size_t at){
-	assert(mOpenMode == OpenMode::In && at < mSize);
-	int8_t r;
-	memcpy(&r, OffsetPointer<int8_t>(mBuffer, at), sizeof(int8_t));
-	return r;
+void CTraceStream::writeInt16(int16_t v){
+	mLog.record(TraceWrite, mTarget.tell(), sizeof(int16_t));
+	mTarget.writeInt16(v);
 }
 
-uint8_t CMemoryStream::peekUInt8(std::size_t at){
-	assert(mOpenMode == OpenMode::In && at < mSize);
-	uint8_t r;
-	memcpy(&r, OffsetPointer<uint8_t>(mBuffer, at), sizeof(uint8_t));
-	return r;
+void CTraceStream::writeUInt16(uint16_t v){
+	mLog.record(TraceWrite, mTarget.tell(), sizeof(uint16_t));
+	mTarget.writeUInt16(v);
 }
 
-int16_t CMemoryStream::peekInt16(std::size_t at){
-	assert(mOpenMode == OpenMode::In && at < mSize);
-	int16_t r;
-	memcpy(&r, OffsetPointer<int16_t>(mBuffer, at), sizeof(int16_t));
+void CTraceStream::writeInt32(int32_t v){
+	mLog.record(TraceWrite, mTarget.tell(), sizeof(int32_t));
+	mTarget.writeInt32(v);
+}
 
-	if(order != systemOrder){
-		return swap16(r);
-	}
-	else{
-		return r;
-	}
+void CTraceStream::writeInt64(int64_t v){
+	mLog.record(TraceWrite, mTarget.tell(), sizeof(int64_t));
+	mTarget.writeInt64(v);
 }
 
-uint16_t CMemoryStream::peekUInt16(std::size_t at){
-	assert(mOpenMode == OpenMode::In && at < mSize);
-	uint16_t r;
-	memcpy(&r, OffsetPointer<uint16_t>(mBuffer, at), sizeof(uint16_t));
+void CTraceStream::writeUInt32(uint32_t v){
+	mLog.record(TraceWrite, mTarget.tell(), sizeof(uint32_t));
+	mTarget.writeUInt32(v);
+}
 
-	if(order != systemOrder){
-		return swap16(r);
-	}
-	else{
-		return r;
-	}
+void CTraceStream::writeUInt64(uint64_t v){
+	mLog.record(TraceWrite, mTarget.tell(), sizeof(uint64_t));
+	mTarget.writeUInt64(v);
 }
 
-uint32_t CMemoryStream::peekUInt32(std::size_t at){
-	assert(mOpenMode == OpenMode::In && at < mSize);
-	uint32_t r;
-	memcpy(&r, OffsetPointer<uint32_t>(mBuffer, at), sizeof(uint32_t));
+void CTraceStream::writeFloat(float v){
+	mLog.record(TraceWrite, mTarget.tell(), sizeof(float));
+	mTarget.writeFloat(v);
+}
 
-	if(order != systemOrder){
-		return swap32(r);
-	}
-	else{
-		return r;
-	}
+void CTraceStream::writeDouble(double v){
+	mLog.record(TraceWrite, mTarget.tell(), sizeof(double));
+	mTarget.writeDouble(v);
 }
 
-int32_t CMemoryStream::peekInt32(std::size_t at){
-	assert(mOpenMode == OpenMode::In && at < mSize);
-	int32_t r;
-	memcpy(&r, OffsetPointer<int32_t>(mBuffer, at), sizeof(int32_t));
+void CTraceStream::readBytesTo(uint8_t* out_buffer, std::size_t len){
+	mLog.record(TraceRead, mTarget.tell(), len);
+	mTarget.readBytesTo(out_buffer, len);
+}
 
-	if(order != systemOrder){
-		return swap32(r);
-	}
-	else{
-		return r;
-	}
+void CTraceStream::writeBytes(uint8_t* v, std::size_t size){
+	mLog.record(TraceWrite, mTarget.tell(), size);
+	mTarget.writeBytes(v, size);
 }
 
-std::string CMemoryStream::readString(std::size_t len){
-	assert(mOpenMode == OpenMode::In && mPosition < mSize);
-	std::string str(OffsetPointer<char>(mBuffer, mPosition),OffsetPointer<char>(mBuffer, mPosition+len));
-	mPosition += len;
-	return str;
+void CTraceStream::alignTo(std::size_t to){
+	std::size_t pos = mTarget.tell();
+	mTarget.alignTo(to);
+	mLog.record(TraceWrite, pos, mTarget.tell() - pos);
 }
 
-std::string CMemoryStream::peekString(std::size_t at, std::size_t len){
-	assert(mOpenMode == OpenMode::In && mPosition < mSize);
-	std::string str(OffsetPointer<char>(mBuffer, at), OffsetPointer<char>(mBuffer, at+len));
-	return str;
+void CTraceStream::writeOffsetAt16(std::size_t at){
+	mLog.record(TraceWrite, at, sizeof(uint16_t));
+	mTarget.writeOffsetAt16(at);
 }
 
-//I don't like this set up, but for now it works
-void CMemoryStream::readBytesTo(uint8_t* out_buffer, std::size_t len){
-	assert(mOpenMode == OpenMode::In && mPosition < mSize);
-	if(mPosition + len <= mSize){
-		memcpy(out_buffer, OffsetPointer<char>(mBuffer, mPosition), len);
+void CTraceStream::writeOffsetAt32(std::size_t at){
+	mLog.record(TraceWrite, at, sizeof(uint32_t));
+	mTarget.writeOffsetAt32(at);
+}
 
-		mPosition += len;
-	}
+void CTraceStream::writeOffsetAt64(std::size_t at){
+	mLog.record(TraceWrite, at, sizeof(uint64_t));
+	mTarget.writeOffsetAt64(at);
 }
 
-///
-/// Memstream Writing Functions
-///
+void CTraceStream::writeString(std::string v){
+	mLog.record(TraceWrite, mTarget.tell(), v.size());
+	mTarget.writeString(v);
+}
 
-bool CMemoryStream::setSize(std::size_t size) {
-	if(mCapacity >= size){
-		mSize = size;
-		return true;
-	}
-	if(!mHasInternalBuffer){
-		return false;
-	}
+std::string CTraceStream::peekString(std::size_t at, std::size_t len){
+	mLog.record(TracePeek, at, len);
+	return mTarget.peekString(at, len);
+}
 
-	mCapacity = size;
-	uint8_t* temp = new uint8_t[mCapacity]{};
-	memcpy(temp, mBuffer, mSize);
-	delete[] mBuffer;
-	mBuffer = temp;
-	mSize = size;
+std::string CTraceStream::readString(std::size_t len){
+	mLog.record(TraceRead, mTarget.tell(), len);
+	return mTarget.readString(len);
+}
 
-	return true;
+Endianess CTraceStream::getOrder(){
+	return mTarget.getOrder();
 }
 
-//included in writing functions because this is needed when using an internal buffer
-bool CMemoryStream::Reserve(std::size_t needed){
-	if(mCapacity >= needed){
-		return true;
-	}
-	if(!mHasInternalBuffer){
-		return false;
+void CTraceStream::setOrder(Endianess e){
+	mTarget.setOrder(e);
+}
+
+
+#if defined(BSTREAM_ASYNC) && defined(__cpp_impl_coroutine) && defined(__unix__)
+
+///
+///
+///  CAsyncContext
+///
+///
+
+CAsyncContext::CAsyncContext(std::size_t workers){
+	mPending = 0;
+	mStopping = false;
+	for(std::size_t i = 0; i < (workers ? workers : 1); i++){
+		mWorkers.emplace_back(&CAsyncContext::workerLoop, this);
 	}
+}
 
-	if(mCapacity * 2 > needed){
-		mCapacity *= 2;
-	} else {
-		mCapacity += needed;
+CAsyncContext::~CAsyncContext(){
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		mStopping = true;
 	}
+	mWorkCondition.notify_all();
+	for(std::thread& t : mWorkers) t.join();
+}
 
-	uint8_t* temp = new uint8_t[mCapacity]{};
-	memcpy(temp, mBuffer, mSize);
-	delete[] mBuffer;
-	mBuffer = temp;
+void CAsyncContext::workerLoop(){
+	while(true){
+		std::function<void()> work;
+		{
+			std::unique_lock<std::mutex> lock(mLock);
+			mWorkCondition.wait(lock, [this]{ return mStopping || !mWork.empty(); });
+			if(mWork.empty()) return;
+			work = std::move(mWork.front());
+			mWork.pop_front();
+		}
+		work();
+	}
+}
 
-	mSize += needed;
-	return true;
+void CAsyncContext::spawn(CTask<void> task){
+	std::lock_guard<std::mutex> lock(mLock);
+	mReady.push_back(task.getHandle());
+	mTasks.push_back(std::move(task));
 }
 
-void CMemoryStream::writeInt8(int8_t v){
-	Reserve(mPosition + sizeof(v));
-	memcpy(OffsetWritePointer<int8_t>(mBuffer, mPosition), &v, sizeof(int8_t));
-	mPosition += sizeof(int8_t);
+void CAsyncContext::submit(std::function<void()> work, std::coroutine_handle<> h){
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		mPending++;
+		mWork.push_back([this, work = std::move(work), h]{
+			std::exception_ptr error;
+			try {
+				work();
+			} catch(...) {
+				error = std::current_exception();
+			}
+			{
+				std::lock_guard<std::mutex> lock(mLock);
+				if(error && !mError) mError = error;
+				mReady.push_back(h);
+				mPending--;
+			}
+			mReadyCondition.notify_one();
+		});
+	}
+	mWorkCondition.notify_one();
 }
 
-void CMemoryStream::writeUInt8(uint8_t v){
-	Reserve(mPosition + sizeof(v));
-	memcpy(OffsetWritePointer<uint8_t>(mBuffer, mPosition), &v, sizeof(int8_t));
-	mPosition += sizeof(int8_t);
+void CAsyncContext::run(){
+	while(true){
+		std::coroutine_handle<> h;
+		{
+			std::unique_lock<std::mutex> lock(mLock);
+			mReadyCondition.wait(lock, [this]{ return !mReady.empty() || mPending == 0; });
+			if(mReady.empty()) break;
+			h = mReady.front();
+			mReady.pop_front();
+		}
+		h.resume();
+	}
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		error = mError;
+		mError = nullptr;
+		for(CTask<void>& task : mTasks){
+			if(!error && task.getHandle() && task.getHandle().promise().error) error = task.getHandle().promise().error;
+		}
+		mTasks.clear();
+	}
+	if(error) std::rethrow_exception(error);
 }
 
-void CMemoryStream::writeInt16(int16_t v){
-	Reserve(mPosition + sizeof(v));
+///
+///
+///  CAsyncFileStream
+///
+///
 
-	if (order != systemOrder)
-		v = swap16(v);
+void CAsyncReadOp::await_suspend(std::coroutine_handle<> h){
+	stream->mContext.submit([this]{
+		std::size_t done = 0;
+		while(done < buffer.size()){
+			ssize_t n = pread(stream->mFd, buffer.data() + done, buffer.size() - done, offset + done);
+			if(n < 0 && errno == EINTR) continue;
+			if(n < 0) error = errno;
+			if(n <= 0) break;
+			done += n;
+		}
+		buffer.resize(done);
+	}, h);
+}
 
-	memcpy(OffsetWritePointer<int16_t>(mBuffer, mPosition), &v, sizeof(int16_t));
-	mPosition += sizeof(int16_t);
+CAsyncFileStream::CAsyncFileStream(CAsyncContext& context, std::string path, Endianess ord) : mContext(context){
+	filePath = path;
+	mFd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	mPosition = 0;
+	order = ord;
+	systemOrder = getSystemEndianess();
 }
 
-void CMemoryStream::writeUInt16(uint16_t v){
-	Reserve(mPosition + sizeof(v));
+CAsyncFileStream::CAsyncFileStream(CAsyncContext& context, std::string path) : CAsyncFileStream(context, path, getSystemEndianess()) {}
 
-	if (order != systemOrder)
-		v = swap16(v);
+CAsyncFileStream::~CAsyncFileStream(){
+	if(mFd >= 0) close(mFd);
+}
 
-	memcpy(OffsetWritePointer<uint16_t>(mBuffer, mPosition), &v, sizeof(int16_t));
-	mPosition += sizeof(int16_t);
+bool CAsyncFileStream::isOpen(){
+	return mFd >= 0;
 }
 
-void CMemoryStream::writeInt32(int32_t v){
-	Reserve(mPosition + sizeof(v));
+std::size_t CAsyncFileStream::getSize(){
+	struct stat st;
+	if(fstat(mFd, &st) != 0) return 0;
+	return st.st_size;
+}
 
-	if (order != systemOrder)
-		v = swap32(v);
+std::size_t CAsyncFileStream::tell(){
+	return mPosition;
+}
 
-	memcpy(OffsetWritePointer<int32_t>(mBuffer, mPosition), &v, sizeof(int32_t));
-	mPosition += sizeof(int32_t);
+bool CAsyncFileStream::seek(std::size_t pos, bool fromCurrent){
+	mPosition = (fromCurrent ? mPosition + pos : pos);
+	return true;
 }
 
-void CMemoryStream::writeUInt32(uint32_t v){
-	Reserve(mPosition + sizeof(v));
+void CAsyncFileStream::skip(std::size_t amount){
+	mPosition += amount;
+}
 
-	if (order != systemOrder)
-		v = swap32(v);
+std::string CAsyncFileStream::getPath(){
+	return filePath;
+}
 
-	memcpy(OffsetWritePointer<uint32_t>(mBuffer, mPosition), &v, sizeof(int32_t));
-	mPosition += sizeof(int32_t);
+Endianess CAsyncFileStream::getOrder(){
+	return order;
 }
 
-void CMemoryStream::writeFloat(float v){
-	Reserve(mPosition + sizeof(v));
+void CAsyncFileStream::setOrder(Endianess e){
+	order = e;
+}
 
-	char* buff = (char*)&v;
-	if(order != systemOrder){
-		char temp[sizeof(float)];
-		temp[0] = buff[3];
-		temp[1] = buff[2];
-		temp[2] = buff[1];
-		temp[3] = buff[0];
-		v = *((float*)temp);
-	}
+CAsyncBytesRead CAsyncFileStream::readAsync(std::size_t len){
+	CAsyncBytesRead op = readAtAsync(mPosition, len);
+	mPosition += len;
+	return op;
+}
 
-	memcpy(OffsetWritePointer<float>(mBuffer, mPosition), &v, sizeof(float));
-	mPosition += sizeof(float);
+CAsyncBytesRead CAsyncFileStream::readAtAsync(std::size_t at, std::size_t len){
+	CAsyncBytesRead op;
+	op.stream = this;
+	op.offset = at;
+	op.buffer.resize(len);
+	return op;
 }
 
+#endif
 
-void CMemoryStream::writeDouble(double v){
-	Reserve(mPosition + sizeof(v));
+///
+///
+///  CFileLoader
+///
+///
 
-	char* buff = (char*)&v;
-	if(order != systemOrder){
-		char temp[sizeof(float)];
-		temp[0] = buff[7];
-		temp[1] = buff[6];
-		temp[2] = buff[5];
-		temp[3] = buff[4];
-		temp[4] = buff[3];
-		temp[5] = buff[2];
-		temp[6] = buff[1];
-		temp[7] = buff[0];
-		v = *((double*)temp);
+CFileLoader::CFileLoader(std::size_t threads, CBufferPool* pool) : mThreads(threads), mPool(pool) {
+	if(mThreads == 0){
+		mThreads = std::thread::hardware_concurrency();
+		if(mThreads < 4) mThreads = 4;
 	}
-
-	memcpy(OffsetWritePointer<double>(mBuffer, mPosition), &v, sizeof(double));
-	mPosition += sizeof(double);
 }
 
-//TODO: Clean these up and test them more
-
-void CMemoryStream::writeBytes(uint8_t* bytes, std::size_t size){
-	Reserve(mPosition + size);
-	memcpy(OffsetWritePointer<uint8_t>(mBuffer, mPosition), bytes, size);
-	mPosition += size;
+CFileLoader::~CFileLoader(){
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		mStopping = true;
+	}
+	mWake.notify_all();
+	for(std::thread& worker : mWorkers){
+		worker.join();
+	}
 }
 
-void CMemoryStream::writeString(std::string str){
-	Reserve(mPosition + str.size());
-	memcpy(OffsetWritePointer<uint8_t>(mBuffer, mPosition), str.data(), str.size());
-	mPosition += str.size();
+void CFileLoader::workerLoop(){
+	uint64_t seen = 0;
+	std::unique_lock<std::mutex> lock(mLock);
+	while(true){
+		mWake.wait(lock, [&](){ return mStopping || mBatchId != seen; });
+		if(mStopping) return;
+		seen = mBatchId;
+		std::function<void()> batch = mBatch;
+		lock.unlock();
+		batch();
+		lock.lock();
+		if(--mBusy == 0) mIdle.notify_all();
+	}
 }
 
-void CMemoryStream::alignTo(std::size_t to){
-    std::size_t nextAligned = (-mPosition % to) % to;
-    Reserve(mPosition+nextAligned);
-    memset(OffsetWritePointer<uint8_t>(mBuffer, mPosition), 0, nextAligned);
-    mPosition += nextAligned;
-}
+CMemoryStream* CFileLoader::readFile(const LoadRequest& request){
+	// Every byte of the buffer is read over, so it skips the zero fill of the sized constructor
+	auto createStream = [&](std::size_t size){
+		if(mPool != nullptr) return new CMemoryStream(*mPool, size, request.order, OpenMode::In);
+		std::unique_ptr<uint8_t[]> buffer(new uint8_t[size]);
+		CMemoryStream* stream = new CMemoryStream(buffer.get(), size, request.order, OpenMode::In);
+		stream->mBuffer = buffer.release();
+		stream->mHasInternalBuffer = true;
+		return stream;
+	};
+
+#if defined(__unix__)
+	int fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0) return nullptr;
+
+	struct stat st;
+	if(fstat(fd, &st) != 0){
+		close(fd);
+		return nullptr;
+	}
+#if defined(POSIX_FADV_SEQUENTIAL)
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 
-void CMemoryStream::writeOffsetAt16(std::size_t at){
-	Reserve(mPosition + sizeof(uint16_t));
-	uint16_t offset = mPosition & 0xFFFF;
-	if(order != systemOrder){
-		offset = swap16(offset);
+	std::size_t size = st.st_size;
+	CMemoryStream* stream;
+	try {
+		stream = createStream(size);
+	} catch(...) {
+		close(fd);
+		throw;
 	}
-	memcpy(OffsetWritePointer<uint16_t>(mBuffer, at), &offset, sizeof(uint16_t));
-}
+	uint8_t* buffer = stream->getBuffer();
+
+	std::size_t done = 0;
+	while(done < size){
+		ssize_t n = pread(fd, buffer + done, size - done, done);
+		if(n < 0 && errno == EINTR) continue;
+		if(n <= 0) break;
+		done += n;
+	}
+	close(fd);
+#else
+	std::ifstream file(request.path, std::ios::in | std::ios::binary | std::ios::ate);
+	if(!file.is_open()) return nullptr;
+
+	std::size_t size = file.tellg();
+	file.seekg(0, std::ios::beg);
+	CMemoryStream* stream = createStream(size);
+	file.read((char*)stream->getBuffer(), size);
+	std::size_t done = file.gcount();
+#endif
 
-void CMemoryStream::writeOffsetAt32(std::size_t at){
-	Reserve(mPosition + sizeof(uint32_t));
-	uint32_t offset = mPosition;
-	if(order != systemOrder){
-		offset = swap32(offset);
+	if(done != size){
+		delete stream;
+		return nullptr;
 	}
-	memcpy(OffsetWritePointer<uint32_t>(mBuffer, at), &offset, sizeof(uint32_t));
+	return stream;
 }
 
-Endianess CMemoryStream::getOrder(){
-    return order;
+std::vector<std::unique_ptr<CMemoryStream>> CFileLoader::load(const std::vector<LoadRequest>& requests, Callback callback){
+	std::lock_guard<std::mutex> loadLock(mLoadLock);
+	std::vector<std::unique_ptr<CMemoryStream>> streams(requests.size());
+	std::atomic<std::size_t> next(0);
+	std::mutex errorLock;
+	std::exception_ptr error;
+
+	// Workers pull the next file index until the list runs out, the calling thread joins in.
+	// A file that throws, such as on a failed allocation, comes back null.
+	auto work = [&](){
+		for(std::size_t i = next++; i < requests.size(); i = next++){
+			try {
+				streams[i].reset(readFile(requests[i]));
+			} catch(...) {
+				streams[i].reset();
+			}
+			if(!callback) continue;
+			try {
+				callback(i, streams[i].get());
+			} catch(...) {
+				std::lock_guard<std::mutex> lock(errorLock);
+				if(!error) error = std::current_exception();
+			}
+		}
+	};
+
+	std::size_t count = (mThreads < requests.size() ? mThreads : requests.size());
+	{
+		std::lock_guard<std::mutex> lock(mLock);
+		// Fewer workers than asked for is fine if the system won't start more
+		try {
+			while(mWorkers.size() + 1 < count){
+				mWorkers.emplace_back(&CFileLoader::workerLoop, this);
+			}
+		} catch(...) {}
+		// Every worker takes part in the batch, mBusy counts them out again
+		if(count > 1 && !mWorkers.empty()){
+			mBatch = work;
+			mBatchId++;
+			mBusy = mWorkers.size();
+		}
+	}
+	mWake.notify_all();
+	work();
+
+	// The workers hold references into this frame, wait for every one to leave the batch
+	std::unique_lock<std::mutex> lock(mLock);
+	mIdle.wait(lock, [&](){ return mBusy == 0; });
+	mBatch = nullptr;
+	lock.unlock();
+
+	if(error) std::rethrow_exception(error);
+	return streams;
 }
 
-void CMemoryStream::setOrder(Endianess e){
-    order = e;
+std::vector<std::unique_ptr<CMemoryStream>> CFileLoader::load(const std::vector<std::string>& paths, Endianess order, Callback callback){
+	std::vector<LoadRequest> requests;
+	requests.reserve(paths.size());
+	for(const std::string& path : paths){
+		requests.push_back({ path, order });
+	}
+	return load(requests, callback);
 }
 
 }
@@ -0,0 +1,66 @@
+// Per-field checked reads against one ensure per record followed by unchecked field reads
+#include "test.h"
+
+#include <chrono>
+
+struct Record {
+	uint32_t id;
+	uint16_t flags;
+	uint16_t material;
+	float position[3];
+	uint64_t offset;
+};
+
+static const std::size_t RecordSize = 4 + 2 + 2 + 12 + 8;
+
+static double elapsed(std::chrono::steady_clock::time_point start){
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+TEST(checkedAgainstEnsured){
+	const std::size_t count = 4000000;
+	bStream::CMemoryStream out(count * RecordSize, bStream::Endianess::Big, bStream::OpenMode::Out);
+	for(std::size_t i = 0; i < count; i++){
+		out.writeUInt32(i);
+		out.writeUInt16(1);
+		out.writeUInt16(2);
+		for(int c = 0; c < 3; c++) out.writeFloat(1.0f);
+		out.writeUInt64(i);
+	}
+	out.changeMode(bStream::OpenMode::In);
+
+	for(int round = 0; round < 3; round++){
+		uint64_t sum = 0;
+		Record r;
+		out.seek(0);
+		auto start = std::chrono::steady_clock::now();
+		for(std::size_t i = 0; i < count; i++){
+			r.id = out.readUInt32();
+			r.flags = out.readUInt16();
+			r.material = out.readUInt16();
+			for(int c = 0; c < 3; c++) r.position[c] = out.readFloat();
+			r.offset = out.readUInt64();
+			sum += r.id + r.flags + r.material + r.offset + (uint64_t)r.position[2];
+		}
+		double checked = elapsed(start);
+		CHECK(out.good());
+
+		uint64_t ensuredSum = 0;
+		out.seek(0);
+		start = std::chrono::steady_clock::now();
+		for(std::size_t i = 0; i < count; i++){
+			if(!out.ensure(RecordSize)) break;
+			r.id = out.readUnchecked<uint32_t>();
+			r.flags = out.readUnchecked<uint16_t>();
+			r.material = out.readUnchecked<uint16_t>();
+			for(int c = 0; c < 3; c++) r.position[c] = out.readUnchecked<float>();
+			r.offset = out.readUnchecked<uint64_t>();
+			ensuredSum += r.id + r.flags + r.material + r.offset + (uint64_t)r.position[2];
+		}
+		double ensured = elapsed(start);
+		CHECK(sum == ensuredSum);
+
+		std::printf("checked fields   %8.1f M records/s\n", count / checked / 1e6);
+		std::printf("ensured records  %8.1f M records/s\n", count / ensured / 1e6);
+	}
+}
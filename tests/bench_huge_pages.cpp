@@ -0,0 +1,43 @@
+// Random 8 byte peeks over a large buffer, the access pattern where TLB misses dominate
+#include "test.h"
+
+#include <chrono>
+#include <random>
+
+static double measure(bStream::PageBacking backing, std::size_t size, const std::vector<std::size_t>& offsets){
+	bStream::CMemoryStream stream(size, bStream::Endianess::Little, bStream::OpenMode::Out, backing);
+	memset(stream.getBuffer(), 1, size);
+	stream.changeMode(bStream::OpenMode::In);
+
+	auto start = std::chrono::steady_clock::now();
+	uint64_t sum = 0;
+	for(std::size_t offset : offsets) sum += stream.peekUInt64(offset);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	CHECK(sum == offsets.size() * 0x0101010101010101ull);
+	return offsets.size() / seconds / 1e6;
+}
+
+TEST(randomPeeks){
+	const std::size_t size = std::size_t(512) << 20;
+	std::mt19937_64 random(42);
+	std::vector<std::size_t> offsets(20000000);
+	for(std::size_t& offset : offsets) offset = (random() % (size / 8)) * 8;
+
+	for(int round = 0; round < 2; round++){
+		std::printf("normal pages %8.1f M peeks/s\n", measure(bStream::PageBacking::NormalPages, size, offsets));
+		std::printf("huge pages   %8.1f M peeks/s\n", measure(bStream::PageBacking::HugePages, size, offsets));
+	}
+}
+
+TEST(smallAllocations){
+	const int count = 20000;
+	for(bStream::PageBacking backing : { bStream::PageBacking::NormalPages, bStream::PageBacking::HugePages }){
+		auto start = std::chrono::steady_clock::now();
+		for(int i = 0; i < count; i++){
+			bStream::CMemoryStream stream(4096, bStream::Endianess::Little, bStream::OpenMode::Out, backing);
+			stream.writeUInt32(i);
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::printf("%s 4 KiB streams %8.2f us each\n", backing == bStream::PageBacking::HugePages ? "huge  " : "normal", seconds / count * 1e6);
+	}
+}
@@ -0,0 +1,47 @@
+// Sequential and random I/O on either side of the 4 GiB mark of a sparse file
+#include "test.h"
+
+#include <chrono>
+#include <random>
+
+static const std::size_t FarOffset = std::size_t(6) << 30;
+static const std::size_t Span = std::size_t(256) << 20;
+
+static double elapsed(std::chrono::steady_clock::time_point start){
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+TEST(sequentialAndRandom){
+	std::string path = bStreamTest::tempPath("bench_large.bin");
+	std::vector<uint8_t> block(0x10000, 0xA5);
+	{
+		bStream::CFileStream out(path, bStream::Endianess::Little, bStream::OpenMode::Out);
+		for(std::size_t base : { std::size_t(0), FarOffset }){
+			out.seek(base);
+			auto start = std::chrono::steady_clock::now();
+			for(std::size_t done = 0; done < Span; done += block.size()) out.writeBytes(block.data(), block.size());
+			out.getStream().flush();
+			std::printf("write at %5zu MiB %8.1f MiB/s\n", base >> 20, (Span >> 20) / elapsed(start));
+		}
+		CHECK(out.good());
+	}
+
+	bStream::CFileStream in(path, bStream::Endianess::Little, bStream::OpenMode::In);
+	CHECK(in.getSize() == FarOffset + Span);
+	std::mt19937_64 random(7);
+	for(std::size_t base : { std::size_t(0), FarOffset }){
+		in.seek(base);
+		auto start = std::chrono::steady_clock::now();
+		for(std::size_t done = 0; done < Span; done += block.size()) in.readBytesTo(block.data(), block.size());
+		std::printf("read at  %5zu MiB %8.1f MiB/s\n", base >> 20, (Span >> 20) / elapsed(start));
+		CHECK(block[0] == 0xA5);
+
+		const int count = 200000;
+		uint64_t sum = 0;
+		start = std::chrono::steady_clock::now();
+		for(int i = 0; i < count; i++) sum += in.peekUInt64(base + (random() % (Span / 8)) * 8);
+		std::printf("peek at  %5zu MiB %8.1f K peeks/s\n", base >> 20, count / elapsed(start) / 1e3);
+		CHECK(sum == count * 0xA5A5A5A5A5A5A5A5ull);
+	}
+	std::filesystem::remove(path);
+}
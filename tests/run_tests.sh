@@ -0,0 +1,30 @@
+#!/bin/sh
+# Builds and runs every test_*.cpp in this directory, or every bench_*.cpp when called with "bench".
+# CXX and CXXFLAGS override the compiler and flags.
+cd "$(dirname "$0")" || exit 1
+
+kind=${1:-test}
+CXX=${CXX:-c++}
+if [ "$kind" = bench ]; then
+	CXXFLAGS=${CXXFLAGS:--std=c++20 -O2 -pthread}
+else
+	CXXFLAGS=${CXXFLAGS:--std=c++20 -O1 -g -Wall -Wno-parentheses -pthread}
+fi
+
+out=${TMPDIR:-/tmp}/bstream_$kind
+mkdir -p "$out"
+
+status=0
+for src in "$kind"_*.cpp; do
+	[ -e "$src" ] || continue
+	name=${src%.cpp}
+	echo "== $name"
+	if ! $CXX $CXXFLAGS -o "$out/$name" "$src"; then
+		echo "BUILD FAILED $name"
+		status=1
+		continue
+	fi
+	"$out/$name" || status=1
+done
+
+exit $status
@@ -0,0 +1,57 @@
+// Minimal harness shared by the tests, every test_*.cpp builds into its own program.
+// Define any bStream feature macros before including this header.
+#pragma once
+
+#define BSTREAM_IMPLEMENTATION
+#include "../bstream.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace bStreamTest {
+
+struct Case {
+	const char* name;
+	void (*run)();
+};
+
+inline std::vector<Case>& cases(){
+	static std::vector<Case> list;
+	return list;
+}
+
+inline int& failures(){
+	static int count = 0;
+	return count;
+}
+
+struct Register {
+	Register(const char* name, void (*run)()){ cases().push_back({ name, run }); }
+};
+
+// Unique per process so tests can run side by side
+inline std::string tempPath(const std::string& name){
+	return (std::filesystem::temp_directory_path() / ("bstream_" + std::to_string(getpid()) + "_" + name)).string();
+}
+
+}
+
+#define TEST(name) static void name(); static bStreamTest::Register name##Register(#name, name); static void name()
+
+#define CHECK(cond) do { \
+	if(!(cond)){ \
+		std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+		bStreamTest::failures()++; \
+	} \
+} while(0)
+
+int main(){
+	for(auto& test : bStreamTest::cases()){
+		int before = bStreamTest::failures();
+		test.run();
+		std::printf("%s %s\n", bStreamTest::failures() == before ? "PASS" : "FAIL", test.name);
+	}
+	return bStreamTest::failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#define BSTREAM_ASYNC
+#include "test.h"
+
+#include <stdexcept>
+
+static std::string writeSample(){
+	std::string path = bStreamTest::tempPath("async.bin");
+	bStream::CFileStream out(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+	out.writeUInt32(0xCAFEBABE);
+	out.writeUInt16(0x1234);
+	out.writeUInt8(7);
+	return path;
+}
+
+static bStream::CTask<void> readValues(bStream::CAsyncFileStream& in, uint32_t& a, uint16_t& b, uint8_t& c){
+	a = co_await in.readUInt32Async();
+	b = co_await in.readUInt16Async();
+	c = co_await in.readUInt8Async();
+}
+
+TEST(valueReads){
+	std::string path = writeSample();
+	bStream::CAsyncContext context(2);
+	bStream::CAsyncFileStream in(context, path, bStream::Endianess::Big);
+	uint32_t a = 0;
+	uint16_t b = 0;
+	uint8_t c = 0;
+	context.spawn(readValues(in, a, b, c));
+	context.run();
+	CHECK(a == 0xCAFEBABE);
+	CHECK(b == 0x1234);
+	CHECK(c == 7);
+	std::filesystem::remove(path);
+}
+
+static bStream::CTask<void> readPastEnd(bStream::CAsyncFileStream& in, bool& threw){
+	in.seek(5);
+	try {
+		co_await in.readUInt32Async();
+	} catch(const std::out_of_range&) {
+		threw = true;
+	}
+}
+
+TEST(shortValueReadThrowsInCoroutine){
+	std::string path = writeSample();
+	bStream::CAsyncContext context(2);
+	bStream::CAsyncFileStream in(context, path, bStream::Endianess::Big);
+	bool threw = false;
+	context.spawn(readPastEnd(in, threw));
+	context.run();
+	CHECK(threw);
+	std::filesystem::remove(path);
+}
+
+static bStream::CTask<void> readShortBytes(bStream::CAsyncFileStream& in, std::size_t& got){
+	std::vector<uint8_t> bytes = co_await in.readAtAsync(4, 100);
+	got = bytes.size();
+}
+
+TEST(shortByteReadReturnsWhatWasRead){
+	std::string path = writeSample();
+	bStream::CAsyncContext context(2);
+	bStream::CAsyncFileStream in(context, path, bStream::Endianess::Big);
+	std::size_t got = 0;
+	context.spawn(readShortBytes(in, got));
+	context.run();
+	CHECK(got == 3);
+	std::filesystem::remove(path);
+}
+
+static bStream::CTask<uint32_t> failingChild(bStream::CAsyncFileStream& in){
+	in.seek(6);
+	uint32_t v = co_await in.readUInt32Async();
+	co_return v;
+}
+
+static bStream::CTask<void> uncaught(bStream::CAsyncFileStream& in, bool& finished){
+	co_await failingChild(in);
+	finished = true;
+}
+
+static bStream::CTask<void> sibling(bStream::CAsyncFileStream& in, uint8_t& value){
+	value = co_await in.readUInt8Async();
+}
+
+TEST(spawnedTaskExceptionReachesRun){
+	std::string path = writeSample();
+	bStream::CAsyncContext context(2);
+	bStream::CAsyncFileStream failing(context, path, bStream::Endianess::Big);
+	bStream::CAsyncFileStream other(context, path, bStream::Endianess::Big);
+	bool finished = false, threw = false;
+	uint8_t value = 0;
+	context.spawn(uncaught(failing, finished));
+	context.spawn(sibling(other, value));
+	try {
+		context.run();
+	} catch(const std::out_of_range&) {
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK(!finished);
+	CHECK(value == 0xCA);
+
+	// The context stays usable after rethrowing
+	value = 0;
+	context.spawn(sibling(other, value));
+	context.run();
+	CHECK(value == 0xFE);
+	std::filesystem::remove(path);
+}
+
+static bStream::CTask<void> throwsDirectly(){
+	throw std::runtime_error("boom");
+	co_return;
+}
+
+TEST(plainExceptionReachesRun){
+	bStream::CAsyncContext context(1);
+	bool threw = false;
+	context.spawn(throwsDirectly());
+	try {
+		context.run();
+	} catch(const std::runtime_error&) {
+		threw = true;
+	}
+	CHECK(threw);
+}
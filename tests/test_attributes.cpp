@@ -0,0 +1,85 @@
+#include "test.h"
+
+struct Vertex {
+	float position[3];
+	uint16_t color;
+	uint8_t pad[2];
+};
+
+static void writeVertices(bStream::CStream& out, std::size_t count){
+	for(std::size_t i = 0; i < count; i++){
+		for(int c = 0; c < 3; c++) out.writeFloat(float(i * 3 + c));
+		out.writeUInt16(uint16_t(i));
+		out.writeUInt16(0);
+	}
+}
+
+static bool checkVertices(const std::vector<float>& positions, const std::vector<uint16_t>& colors, std::size_t count){
+	for(std::size_t i = 0; i < count; i++){
+		if(colors[i] != i) return false;
+		for(int c = 0; c < 3; c++) if(positions[i * 3 + c] != float(i * 3 + c)) return false;
+	}
+	return true;
+}
+
+TEST(memoryStreamsSplitAttributes){
+	const std::size_t count = 5000;
+	bStream::CMemoryStream stream(count * sizeof(Vertex), bStream::Endianess::Big, bStream::OpenMode::Out);
+	writeVertices(stream, count);
+	stream.changeMode(bStream::OpenMode::In);
+	stream.seek(0);
+
+	std::vector<float> positions(count * 3);
+	std::vector<uint16_t> colors(count);
+	CHECK(stream.readAttributes(sizeof(Vertex), count, { { 0, 4, 3, positions.data() }, { 12, 2, 1, colors.data() } }));
+	CHECK(checkVertices(positions, colors, count));
+	CHECK(stream.tell() == count * sizeof(Vertex));
+}
+
+TEST(fileStreamsSplitAttributes){
+	const std::size_t count = 5000;
+	std::string path = bStreamTest::tempPath("attributes.bin");
+	{
+		bStream::CFileStream out(path, bStream::Endianess::Little, bStream::OpenMode::Out);
+		writeVertices(out, count);
+	}
+	bStream::CFileStream in(path, bStream::Endianess::Little, bStream::OpenMode::In);
+	std::vector<float> positions(count * 3);
+	std::vector<uint16_t> colors(count);
+	CHECK(in.readAttributes(sizeof(Vertex), count, { { 0, 4, 3, positions.data() }, { 12, 2, 1, colors.data() } }));
+	CHECK(checkVertices(positions, colors, count));
+	std::filesystem::remove(path);
+}
+
+TEST(shortStreamsFailWithoutReading){
+	std::string path = bStreamTest::tempPath("attributes_short.bin");
+	{
+		bStream::CFileStream out(path, bStream::Endianess::Little, bStream::OpenMode::Out);
+		writeVertices(out, 10);
+	}
+	bStream::CFileStream in(path, bStream::Endianess::Little, bStream::OpenMode::In);
+	in.skip(4);
+	std::vector<uint16_t> colors(10, 0xFFFF);
+	CHECK(!in.readAttributes(sizeof(Vertex), 10, { { 12, 2, 1, colors.data() } }));
+	CHECK(colors[0] == 0xFFFF);
+	CHECK(in.tell() == 4);
+	in.seek(0);
+	CHECK(in.readAttributes(sizeof(Vertex), 10, { { 12, 2, 1, colors.data() } }));
+	CHECK(colors[9] == 9);
+	std::filesystem::remove(path);
+
+	bStream::CMemoryStream memory(3 * sizeof(Vertex), bStream::Endianess::Little, bStream::OpenMode::Out);
+	writeVertices(memory, 3);
+	memory.changeMode(bStream::OpenMode::In);
+	memory.seek(0);
+	CHECK(!memory.readAttributes(sizeof(Vertex), 4, { { 12, 2, 1, colors.data() } }));
+	CHECK(memory.getError() == bStream::StreamError::OutOfBounds);
+}
+
+TEST(badLayoutsAreRejected){
+	bStream::CMemoryStream stream(64, bStream::Endianess::Little, bStream::OpenMode::In);
+	uint32_t out[4];
+	CHECK(!stream.readAttributes(0, 1, { { 0, 4, 1, out } }));
+	CHECK(!stream.readAttributes(8, 1, { { 6, 4, 1, out } }));
+	CHECK(!stream.readAttributes(8, 1, { { 0, 3, 1, out } }));
+}
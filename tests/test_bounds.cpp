@@ -0,0 +1,106 @@
+#include "test.h"
+
+#include <limits>
+
+static uint8_t Data[6] = { 1, 2, 3, 4, 5, 6 };
+
+TEST(readsInsideTheBuffer){
+	bStream::CMemoryStream in(Data, sizeof(Data), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.readUInt32() == 0x01020304);
+	CHECK(in.readUInt16() == 0x0506);
+	CHECK(in.good());
+}
+
+TEST(readPastEndFlagsErrorAndKeepsPosition){
+	bStream::CMemoryStream in(Data, sizeof(Data), bStream::Endianess::Big, bStream::OpenMode::In);
+	in.seek(4);
+	CHECK(in.readUInt32() == 0);
+	CHECK(in.getError() == bStream::StreamError::OutOfBounds);
+	CHECK(in.tell() == 4);
+	CHECK(in.readUInt64() == 0);
+	CHECK(in.readDouble() == 0);
+	CHECK(in.readFloat() == 0);
+	CHECK(in.tell() == 4);
+
+	in.clearError();
+	CHECK(in.readUInt16() == 0x0506);
+	CHECK(in.good());
+	CHECK(in.readUInt8() == 0);
+	CHECK(!in.good());
+}
+
+TEST(peeksAreBoundsChecked){
+	bStream::CMemoryStream in(Data, sizeof(Data), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.peekUInt16(4) == 0x0506);
+	CHECK(in.good());
+	CHECK(in.peekUInt32(4) == 0);
+	CHECK(!in.good());
+	in.clearError();
+	CHECK(in.peekUInt8(std::numeric_limits<std::size_t>::max()) == 0);
+	CHECK(!in.good());
+	in.clearError();
+	CHECK(in.peekInt64(std::numeric_limits<std::size_t>::max() - 2) == 0);
+	CHECK(!in.good());
+}
+
+TEST(peekStringChecksItsOwnOffset){
+	bStream::CMemoryStream in(Data, sizeof(Data), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.peekString(2, 3) == std::string("\x03\x04\x05"));
+	CHECK(in.good());
+
+	// The position is in bounds but the peeked range is not
+	CHECK(in.peekString(4, 8).empty());
+	CHECK(!in.good());
+	in.clearError();
+	CHECK(in.peekString(100, 1).empty());
+	CHECK(!in.good());
+}
+
+TEST(readBytesToLeavesOutputOnOverrun){
+	bStream::CMemoryStream in(Data, sizeof(Data), bStream::Endianess::Big, bStream::OpenMode::In);
+	uint8_t out[8] = { 9, 9, 9, 9, 9, 9, 9, 9 };
+	in.readBytesTo(out, sizeof(out));
+	CHECK(!in.good());
+	CHECK(out[0] == 9 && out[7] == 9);
+	CHECK(in.readString(7).empty());
+}
+
+TEST(ensureChecksWholeRecords){
+	bStream::CMemoryStream in(Data, sizeof(Data), bStream::Endianess::Little, bStream::OpenMode::In);
+	CHECK(in.ensure(6));
+	CHECK(!in.ensure(7));
+	CHECK(in.getError() == bStream::StreamError::OutOfBounds);
+	in.clearError();
+	CHECK(in.ensureAt(5, 1));
+	CHECK(!in.ensureAt(5, std::numeric_limits<std::size_t>::max()));
+}
+
+TEST(uncheckedReadsInsideAnEnsuredRegion){
+	uint8_t data[15] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 0x3F, 0x80, 0 };
+	bStream::CMemoryStream in(data, sizeof(data), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.ensure(15));
+	CHECK(in.readUnchecked<uint32_t>() == 0x01020304);
+	CHECK(in.readUnchecked<uint16_t>() == 0x0506);
+	CHECK(in.readUnchecked<int8_t>() == 7);
+	CHECK(in.readUnchecked<uint8_t>() == 8);
+	CHECK(in.readUnchecked<uint32_t>() == 0x090A0B0C);
+	in.seek(12);
+	CHECK(in.readUnchecked<uint16_t>() == 0x3F80);
+	in.seek(6);
+	CHECK(in.readUnchecked<uint64_t>() == 0x0708090A0B0C3F80ull);
+	CHECK(in.tell() == 14);
+	CHECK(in.good());
+
+	// Same answers as the checked reads, including for floats and little endian data
+	in.seek(12);
+	in.setOrder(bStream::Endianess::Little);
+	uint16_t checked = in.readUInt16();
+	in.seek(12);
+	CHECK(in.readUnchecked<uint16_t>() == checked);
+	in.setOrder(bStream::Endianess::Big);
+	in.seek(11);
+	float value = in.readFloat();
+	in.seek(11);
+	CHECK(in.ensure(4));
+	CHECK(in.readUnchecked<float>() == value);
+}
@@ -0,0 +1,77 @@
+#include "test.h"
+
+#include <thread>
+
+TEST(capacityRoundsUpToSizeClass){
+	bStream::CBufferPool& pool = bStream::CBufferPool::instance();
+	std::size_t capacity = 1000;
+	uint8_t* buffer = pool.acquire(capacity);
+	CHECK(buffer != nullptr);
+	CHECK(capacity == 1024);
+	memset(buffer, 0xAB, capacity);
+	pool.release(buffer, capacity);
+
+	std::size_t tiny = 1;
+	uint8_t* small = pool.acquire(tiny);
+	CHECK(tiny == 256);
+	pool.release(small, tiny);
+}
+
+TEST(releasedBuffersAreReused){
+	bStream::CBufferPool& pool = bStream::CBufferPool::instance();
+	std::size_t capacity = 4096;
+	uint8_t* first = pool.acquire(capacity);
+	pool.release(first, capacity);
+
+	bStream::CBufferPool::Stats before = pool.getStats();
+	std::size_t again = 4000;
+	uint8_t* second = pool.acquire(again);
+	bStream::CBufferPool::Stats after = pool.getStats();
+	CHECK(second == first);
+	CHECK(after.acquires == before.acquires + 1);
+	CHECK(after.hits == before.hits + 1);
+	pool.release(second, again);
+}
+
+TEST(pooledStreamsBehaveLikeOthers){
+	bStream::CBufferPool& pool = bStream::CBufferPool::instance();
+	{
+		bStream::CMemoryStream out(pool, 16, bStream::Endianess::Big, bStream::OpenMode::Out);
+		for(uint32_t i = 0; i < 1000; i++) out.writeUInt32(i);
+		CHECK(out.getSize() == 4000);
+
+		bStream::CMemoryStream in(out.getBuffer(), out.getSize(), bStream::Endianess::Big, bStream::OpenMode::In);
+		in.seek(3996);
+		CHECK(in.readUInt32() == 999);
+	}
+	CHECK(pool.getStats().retainedBytes > 0);
+}
+
+TEST(manyThreadsShareThePool){
+	bStream::CBufferPool& pool = bStream::CBufferPool::instance();
+	std::vector<std::thread> threads;
+	std::atomic<int> bad { 0 };
+	for(int t = 0; t < 4; t++){
+		threads.emplace_back([&pool, &bad, t]{
+			for(int i = 0; i < 2000; i++){
+				std::size_t capacity = 256 << (i % 6);
+				uint8_t* buffer = pool.acquire(capacity);
+				memset(buffer, t, capacity);
+				if(buffer[capacity - 1] != t) bad++;
+				pool.release(buffer, capacity);
+			}
+		});
+	}
+	for(std::thread& t : threads) t.join();
+	CHECK(bad == 0);
+}
+
+TEST(retentionLimit){
+	bStream::CBufferPool& pool = bStream::CBufferPool::instance();
+	pool.setMaxRetained(0);
+	std::size_t capacity = 1 << 20;
+	uint8_t* buffer = pool.acquire(capacity);
+	std::size_t retained = pool.getStats().retainedBytes;
+	pool.release(buffer, capacity);
+	CHECK(pool.getStats().retainedBytes <= retained);
+}
@@ -0,0 +1,71 @@
+#include "test.h"
+
+static const char Check[] = "123456789";
+
+TEST(knownValues){
+	bStream::CChecksum crc(bStream::ChecksumType::Crc32), crcc(bStream::ChecksumType::Crc32c);
+	crc.update(Check, 9);
+	crcc.update(Check, 9);
+	CHECK(crc.value() == 0xCBF43926);
+	CHECK(crcc.value() == 0xE3069283);
+}
+
+TEST(splitUpdatesMatchOneUpdate){
+	std::vector<uint8_t> data(1000);
+	for(std::size_t i = 0; i < data.size(); i++) data[i] = (uint8_t)(i * 7 + 3);
+
+	for(bStream::ChecksumType type : { bStream::ChecksumType::Crc32, bStream::ChecksumType::Crc32c }){
+		bStream::CChecksum whole(type), parts(type);
+		whole.update(data.data(), data.size());
+		for(std::size_t at = 0, step = 1; at < data.size(); at += step, step++){
+			parts.update(data.data() + at, std::min(step, data.size() - at));
+		}
+		CHECK(whole.value() == parts.value());
+	}
+}
+
+TEST(readsAndWritesAgree){
+	std::string path = bStreamTest::tempPath("checksum.bin");
+	bStream::CChecksum written(bStream::ChecksumType::Crc32c), read(bStream::ChecksumType::Crc32c), memory(bStream::ChecksumType::Crc32c);
+	{
+		bStream::CFileStream out(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+		out.setChecksum(&written);
+		out.writeUInt32(0xDEADBEEF);
+		out.writeString("bStream");
+		out.writeDouble(2.5);
+	}
+	{
+		bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+		in.setChecksum(&read);
+		in.readUInt32();
+		in.readString(7);
+		in.readDouble();
+	}
+	bStream::CMemoryStream out(8, bStream::Endianess::Big, bStream::OpenMode::Out);
+	out.setChecksum(&memory);
+	out.writeUInt32(0xDEADBEEF);
+	out.writeString("bStream");
+	out.writeDouble(2.5);
+
+	CHECK(written.value() == read.value());
+	CHECK(written.value() == memory.value());
+	std::filesystem::remove(path);
+}
+
+TEST(shortFileReadOnlyChecksumsBytesRead){
+	std::string path = bStreamTest::tempPath("short.bin");
+	{
+		bStream::CFileStream out(path, bStream::OpenMode::Out);
+		out.writeString(Check);
+	}
+	bStream::CChecksum read(bStream::ChecksumType::Crc32), expected(bStream::ChecksumType::Crc32);
+	expected.update(Check, 9);
+	{
+		bStream::CFileStream in(path, bStream::OpenMode::In);
+		in.setChecksum(&read);
+		uint8_t buffer[64];
+		in.readBytesTo(buffer, sizeof(buffer));
+	}
+	CHECK(read.value() == expected.value());
+	std::filesystem::remove(path);
+}
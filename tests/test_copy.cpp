@@ -0,0 +1,108 @@
+#include "test.h"
+
+static std::string writeFile(const std::string& name, std::size_t size){
+	std::string path = bStreamTest::tempPath(name);
+	bStream::CFileStream out(path, bStream::OpenMode::Out);
+	for(std::size_t i = 0; i < size; i++) out.writeUInt8((uint8_t)(i * 13));
+	return path;
+}
+
+static bool matchesPattern(const uint8_t* data, std::size_t size, std::size_t from = 0){
+	for(std::size_t i = 0; i < size; i++){
+		if(data[i] != (uint8_t)((from + i) * 13)) return false;
+	}
+	return true;
+}
+
+TEST(fileToFile){
+	std::string src = writeFile("copy_src.bin", 200000), dst = bStreamTest::tempPath("copy_dst.bin");
+	{
+		bStream::CFileStream in(src, bStream::OpenMode::In);
+		bStream::CFileStream out(dst, bStream::OpenMode::Out);
+		in.seek(100);
+		CHECK(in.copyTo(out, 150000) == 150000);
+		CHECK(in.tell() == 150100);
+	}
+	bStream::CFileStream check(dst, bStream::OpenMode::In);
+	CHECK(check.getSize() == 150000);
+	std::vector<uint8_t> data(150000);
+	check.readBytesTo(data.data(), data.size());
+	CHECK(matchesPattern(data.data(), data.size(), 100));
+	std::filesystem::remove(src);
+	std::filesystem::remove(dst);
+}
+
+TEST(fileToFileStopsAtEnd){
+	std::string src = writeFile("copy_short.bin", 4), dst = bStreamTest::tempPath("copy_short_dst.bin");
+	{
+		bStream::CFileStream in(src, bStream::OpenMode::In);
+		bStream::CFileStream out(dst, bStream::OpenMode::Out);
+		CHECK(in.copyTo(out, 100) == 4);
+		CHECK(in.copyTo(out, 100) == 0);
+	}
+	CHECK(std::filesystem::file_size(dst) == 4);
+	std::filesystem::remove(src);
+	std::filesystem::remove(dst);
+}
+
+TEST(fileToFileWithChecksumStopsAtEnd){
+	std::string src = writeFile("copy_sum.bin", 4), dst = bStreamTest::tempPath("copy_sum_dst.bin");
+	bStream::CChecksum sum;
+	{
+		bStream::CFileStream in(src, bStream::OpenMode::In);
+		bStream::CFileStream out(dst, bStream::OpenMode::Out);
+		in.setChecksum(&sum);
+		CHECK(in.copyTo(out, 100) == 4);
+	}
+	CHECK(std::filesystem::file_size(dst) == 4);
+	std::filesystem::remove(src);
+	std::filesystem::remove(dst);
+}
+
+TEST(fileToMemoryStopsAtEnd){
+	std::string src = writeFile("copy_mem.bin", 10);
+	bStream::CFileStream in(src, bStream::OpenMode::In);
+	bStream::CMemoryStream out(1, bStream::Endianess::Little, bStream::OpenMode::Out);
+	in.seek(6);
+	CHECK(in.copyTo(out, 100) == 4);
+	CHECK(out.tell() == 4);
+	CHECK(out.getSize() == 4);
+	CHECK(matchesPattern(out.getBuffer(), 4, 6));
+	std::filesystem::remove(src);
+}
+
+TEST(memoryToFileStopsAtEnd){
+	uint8_t data[16];
+	for(int i = 0; i < 16; i++) data[i] = (uint8_t)(i * 13);
+	std::string dst = bStreamTest::tempPath("copy_from_mem.bin");
+	{
+		bStream::CMemoryStream in(data, sizeof(data), bStream::Endianess::Little, bStream::OpenMode::In);
+		bStream::CFileStream out(dst, bStream::OpenMode::Out);
+		in.seek(8);
+		CHECK(in.copyTo(out, 100) == 8);
+	}
+	CHECK(std::filesystem::file_size(dst) == 8);
+	std::filesystem::remove(dst);
+}
+
+TEST(genericStreamsStopAtEnd){
+	uint8_t data[4] = { 1, 2, 3, 4 };
+	bStream::CMemoryStream target(data, sizeof(data), bStream::Endianess::Little, bStream::OpenMode::In);
+	bStream::CTraceStream in(target);
+	bStream::CMemoryStream out(1, bStream::Endianess::Little, bStream::OpenMode::Out);
+	CHECK(in.copyTo(out, 100) == 4);
+	CHECK(out.getSize() == 4);
+}
+
+TEST(memoryCopyOfEverythingLeft){
+	uint8_t data[16];
+	for(int i = 0; i < 16; i++) data[i] = (uint8_t)(i * 13);
+	bStream::CMemoryStream in(data, sizeof(data), bStream::Endianess::Little, bStream::OpenMode::In);
+	bStream::CMemoryStream out(1, bStream::Endianess::Little, bStream::OpenMode::Out);
+	in.seek(4);
+	CHECK(in.copyTo(out, SIZE_MAX) == 12);
+	CHECK(in.tell() == 16);
+	CHECK(out.getSize() == 12);
+	CHECK(matchesPattern(out.getBuffer(), 12, 4));
+	CHECK(in.copyTo(out, SIZE_MAX) == 0);
+}
@@ -0,0 +1,52 @@
+#include "test.h"
+
+static void serialize(bStream::CStream& out){
+	out.writeUInt32(0);
+	out.writeString("name");
+	out.alignTo(16);
+	out.writeOffsetAt32(0);
+	out.writeDouble(1.0);
+	out.writeUInt16(7);
+	out.alignTo(8);
+}
+
+TEST(measuresWhatTheWriterProduces){
+	bStream::CCountingStream counter;
+	serialize(counter);
+
+	bStream::CMemoryStream out(1, bStream::Endianess::Big, bStream::OpenMode::Out);
+	serialize(out);
+
+	CHECK(counter.getSize() == out.getSize());
+	CHECK(counter.getMaxAlignment() == 16);
+	CHECK(counter.getPatches().size() == 1);
+	CHECK(counter.getPatches()[0].at == 0);
+	CHECK(counter.getPatches()[0].value == 16);
+	CHECK(counter.getPatches()[0].width == 4);
+	CHECK(counter.good());
+}
+
+TEST(reserveOnceFromTheMeasurement){
+	bStream::CCountingStream counter;
+	serialize(counter);
+	bStream::CMemoryStream out(1, bStream::Endianess::Big, bStream::OpenMode::Out);
+	out.Reserve(counter.getSize());
+	std::size_t capacity = out.getCapacity();
+	serialize(out);
+	CHECK(out.getCapacity() == capacity);
+}
+
+TEST(offsetsPastFourGigabytesOverflow){
+	bStream::CCountingStream counter;
+	counter.skip(0x100000004ull);
+	counter.writeOffsetAt32(0);
+	CHECK(counter.getError() == bStream::StreamError::OffsetOverflow);
+	CHECK(counter.getPatches().empty());
+
+	counter.writeOffsetAt64(0);
+	CHECK(counter.getPatches().size() == 1);
+	CHECK(counter.getPatches()[0].value == 0x100000004ull);
+
+	counter.reset();
+	CHECK(counter.good());
+}
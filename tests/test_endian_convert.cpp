@@ -0,0 +1,118 @@
+#include "test.h"
+
+// Four big endian records of { uint32_t, uint16_t, uint16_t, uint64_t extra }, the layout below
+// only converts the first three fields
+static std::vector<uint8_t> table(){
+	bStream::CMemoryStream out(64, bStream::Endianess::Big, bStream::OpenMode::Out);
+	for(uint32_t i = 0; i < 4; i++){
+		out.writeUInt32(0x01000000 + i);
+		out.writeUInt16(0x0200 + i);
+		out.writeUInt16(0x0300 + i);
+		out.writeUInt64(0x1122334455667788ull + i);
+	}
+	return std::vector<uint8_t>(out.getBuffer(), out.getBuffer() + out.getSize());
+}
+
+static const bStream::SwapLayout Records { { 4, 2, 2 }, 16, 4 };
+
+TEST(convertedRegionsReadWithoutSwapping){
+	std::vector<uint8_t> data = table();
+	bStream::CMemoryStream in(data.data(), data.size(), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.convertToNative(0, Records));
+
+	uint32_t first;
+	memcpy(&first, data.data() + 16, sizeof(first));
+	CHECK(first == 0x01000001);
+
+	in.seek(32);
+	CHECK(in.readUInt32() == 0x01000002);
+	CHECK(in.readUInt16() == 0x0202);
+	CHECK(in.peekUInt16(54) == 0x0303);
+	// Bytes past the fields sit inside the converted region but were never swapped, so reads
+	// there still swap
+	CHECK(in.peekUInt64(8) == 0x1122334455667788ull);
+	CHECK(in.peekUInt16(44) == 0x5566);
+	in.seek(40);
+	CHECK(in.readUInt64() == 0x112233445566778Aull);
+	CHECK(in.readUInt32() == 0x01000003);
+}
+
+TEST(roundTripRestoresTheBuffer){
+	std::vector<uint8_t> data = table(), original = data;
+	bStream::CMemoryStream in(data.data(), data.size(), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.convertToNative(16, { { 4, 2, 2 }, 16, 2 }));
+	CHECK(data != original);
+	CHECK(in.convertFromNative(16, { { 4, 2, 2 }, 16, 2 }));
+	CHECK(data == original);
+	CHECK(in.peekUInt32(16) == 0x01000001);
+}
+
+TEST(convertingTwiceIsRejected){
+	std::vector<uint8_t> data = table();
+	bStream::CMemoryStream in(data.data(), data.size(), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.convertToNative(0, Records));
+	std::vector<uint8_t> converted = data;
+
+	CHECK(!in.convertToNative(0, Records));
+	CHECK(!in.convertToNative(20, { { 4 }, 4, 1 }));
+	CHECK(data == converted);
+	CHECK(in.peekUInt32(0) == 0x01000000);
+}
+
+TEST(adjacentRegionsAreAllowed){
+	std::vector<uint8_t> data = table();
+	bStream::CMemoryStream in(data.data(), data.size(), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.convertToNative(32, { { 4, 2, 2 }, 16, 2 }));
+	CHECK(in.convertToNative(0, { { 4, 2, 2 }, 16, 2 }));
+	for(uint32_t i = 0; i < 4; i++) CHECK(in.peekUInt32(i * 16) == 0x01000000 + i);
+	CHECK(in.convertFromNative(0, { { 4, 2, 2 }, 16, 2 }));
+	CHECK(in.peekUInt32(16) == 0x01000001);
+	CHECK(in.peekUInt32(48) == 0x01000003);
+}
+
+TEST(unconvertedRegionsCannotBeSwappedBack){
+	std::vector<uint8_t> data = table(), original = data;
+	bStream::CMemoryStream in(data.data(), data.size(), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(!in.convertFromNative(0, Records));
+	CHECK(data == original);
+
+	CHECK(in.convertToNative(0, Records));
+	CHECK(!in.convertFromNative(0, { { 4, 2, 2 }, 16, 3 }));
+	CHECK(!in.convertFromNative(16, { { 4, 2, 2 }, 16, 3 }));
+	CHECK(in.convertFromNative(0, Records));
+	CHECK(data == original);
+}
+
+TEST(writesInsideNativeRegionsStayNative){
+	std::vector<uint8_t> data = table();
+	bStream::CMemoryStream stream(data.data(), data.size(), bStream::Endianess::Big, bStream::OpenMode::Out);
+	CHECK(stream.convertToNative(0, Records));
+	stream.seek(16);
+	stream.writeUInt32(0xAABBCCDD);
+	uint32_t raw;
+	memcpy(&raw, data.data() + 16, sizeof(raw));
+	CHECK(raw == 0xAABBCCDD);
+}
+
+TEST(invalidLayoutsFail){
+	std::vector<uint8_t> data = table();
+	bStream::CMemoryStream in(data.data(), data.size(), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(!in.convertToNative(0, { { 3 }, 4, 1 }));
+	CHECK(!in.convertToNative(0, { { 4, 4 }, 4, 2 }));
+	CHECK(!in.convertToNative(0, { { 4 }, 16, 5 }));
+}
+
+TEST(manyRangesLookUpCorrectly){
+	std::vector<uint8_t> data(4096);
+	bStream::CMemoryStream in(data.data(), data.size(), bStream::Endianess::Big, bStream::OpenMode::In);
+	for(std::size_t at = 0; at < data.size(); at += 64) CHECK(in.convertToNative(at, { { 4 }, 4, 4 }));
+	for(std::size_t at = 0; at < data.size(); at += 64){
+		data[at] = 1;
+		data[at + 16] = 1;
+	}
+	bool ok = true;
+	for(std::size_t at = 4096 - 64; at < 4096; at -= 64){
+		ok = ok && in.peekUInt32(at) == 1 && in.peekUInt32(at + 16) == 0x01000000;
+	}
+	CHECK(ok);
+}
@@ -0,0 +1,86 @@
+#include "test.h"
+
+#include <set>
+#include <stdexcept>
+
+static std::vector<std::string> writeFiles(std::size_t count){
+	std::vector<std::string> paths;
+	for(std::size_t i = 0; i < count; i++){
+		paths.push_back(bStreamTest::tempPath("loader_" + std::to_string(i) + ".bin"));
+		bStream::CFileStream out(paths.back(), bStream::Endianess::Big, bStream::OpenMode::Out);
+		for(std::size_t v = 0; v < 64 + i * 300; v++) out.writeUInt32(uint32_t(i << 16 | v));
+	}
+	return paths;
+}
+
+static void removeFiles(const std::vector<std::string>& paths){
+	for(const std::string& path : paths) std::filesystem::remove(path);
+}
+
+static bool matches(bStream::CMemoryStream* stream, std::size_t i){
+	if(stream == nullptr || stream->getSize() != (64 + i * 300) * 4) return false;
+	return stream->peekUInt32(0) == uint32_t(i << 16) && stream->peekUInt32(stream->getSize() - 4) == uint32_t(i << 16 | (63 + i * 300));
+}
+
+TEST(loadsEveryFileInOrder){
+	std::vector<std::string> paths = writeFiles(24);
+	paths.push_back(bStreamTest::tempPath("loader_missing.bin"));
+
+	bStream::CFileLoader loader(6);
+	std::mutex lock;
+	std::set<std::size_t> seen;
+	auto streams = loader.load(paths, bStream::Endianess::Big, [&](std::size_t i, bStream::CMemoryStream* stream){
+		std::lock_guard<std::mutex> guard(lock);
+		CHECK(seen.insert(i).second);
+		CHECK((stream == nullptr) == (i == 24));
+	});
+	CHECK(seen.size() == paths.size());
+	for(std::size_t i = 0; i < 24; i++) CHECK(matches(streams[i].get(), i));
+	CHECK(streams[24] == nullptr);
+	removeFiles(paths);
+}
+
+TEST(perFileByteOrder){
+	std::vector<std::string> paths = writeFiles(2);
+	bStream::CFileLoader loader(2, &bStream::CBufferPool::instance());
+	auto streams = loader.load({ { paths[0], bStream::Endianess::Big }, { paths[1], bStream::Endianess::Little } });
+	CHECK(streams[0]->readUInt32() == 0);
+	CHECK(streams[1]->readUInt32() == 0x00000100);
+	removeFiles(paths);
+}
+
+TEST(callbackExceptionsReachTheCaller){
+	std::vector<std::string> paths = writeFiles(12);
+	bStream::CFileLoader loader(4);
+	std::atomic<int> calls(0);
+	bool threw = false;
+	try {
+		loader.load(paths, bStream::Endianess::Big, [&](std::size_t i, bStream::CMemoryStream*){
+			calls++;
+			if(i % 5 == 0) throw std::runtime_error("callback");
+		});
+	} catch(const std::runtime_error&) {
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK(calls == 12);
+
+	// The same workers serve the next batch
+	auto streams = loader.load(paths, bStream::Endianess::Big);
+	for(std::size_t i = 0; i < paths.size(); i++) CHECK(matches(streams[i].get(), i));
+	removeFiles(paths);
+}
+
+TEST(manySmallBatches){
+	std::vector<std::string> paths = writeFiles(5);
+	bStream::CFileLoader loader(8);
+	bool ok = true;
+	for(int round = 0; round < 300; round++){
+		std::size_t count = 1 + round % paths.size();
+		auto streams = loader.load(std::vector<std::string>(paths.begin(), paths.begin() + count), bStream::Endianess::Big);
+		for(std::size_t i = 0; i < count; i++) ok = ok && matches(streams[i].get(), i);
+	}
+	CHECK(ok);
+	CHECK(loader.load(std::vector<std::string>(), bStream::Endianess::Big).empty());
+	removeFiles(paths);
+}
@@ -0,0 +1,32 @@
+#include "test.h"
+
+static const std::size_t HugePage = 0x200000;
+
+TEST(smallBuffersStayOnTheHeap){
+	bStream::CMemoryStream stream(1000, bStream::Endianess::Little, bStream::OpenMode::Out, bStream::PageBacking::HugePages);
+	CHECK(stream.getCapacity() == 1000);
+	stream.writeUInt32(5);
+	CHECK(stream.getBuffer()[0] == 5);
+}
+
+TEST(largeBuffersRoundToWholePages){
+	bStream::CMemoryStream stream(HugePage + 1, bStream::Endianess::Little, bStream::OpenMode::Out, bStream::PageBacking::HugePages);
+	CHECK(stream.getCapacity() == 2 * HugePage);
+	CHECK(stream.getBuffer()[HugePage] == 0);
+	stream.seek(HugePage);
+	stream.writeUInt64(0x0102030405060708ull);
+	stream.changeMode(bStream::OpenMode::In);
+	CHECK(stream.peekUInt64(HugePage) == 0x0102030405060708ull);
+}
+
+TEST(growingPastAHugePageKeepsContents){
+	bStream::CMemoryStream stream(64, bStream::Endianess::Big, bStream::OpenMode::Out, bStream::PageBacking::HugePages);
+	for(uint32_t i = 0; i < HugePage / 2; i++) stream.writeUInt32(i);
+	CHECK(stream.getSize() == HugePage * 2);
+	CHECK(stream.getCapacity() % HugePage == 0);
+
+	bStream::CMemoryStream in(stream.getBuffer(), stream.getSize(), bStream::Endianess::Big, bStream::OpenMode::In);
+	bool ok = true;
+	for(uint32_t i = 0; i < HugePage / 2; i += 4097) ok = ok && in.peekUInt32(i * 4) == i;
+	CHECK(ok);
+}
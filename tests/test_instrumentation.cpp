@@ -0,0 +1,103 @@
+#define BSTREAM_INSTRUMENTATION
+#include "test.h"
+
+static std::string writeSample(){
+	std::string path = bStreamTest::tempPath("stats.bin");
+	{
+		bStream::CFileStream out(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+		out.writeUInt32(0x11223344);
+		out.writeUInt64(0x0102030405060708ull);
+		out.writeUInt16(0xBEEF);
+	}
+	return path;
+}
+
+TEST(fileReadsAreCounted){
+	std::string path = writeSample();
+	bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.readUInt32() == 0x11223344);
+	CHECK(in.readUInt64() == 0x0102030405060708ull);
+	CHECK(in.getStats().reads == 2);
+	CHECK(in.getStats().bytesRead == 12);
+	std::filesystem::remove(path);
+}
+
+TEST(filePeeksCountOnce){
+	std::string path = writeSample();
+	bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.peekUInt32(0) == 0x11223344);
+	CHECK(in.peekUInt16(12) == 0xBEEF);
+	CHECK(in.peekString(0, 2) == std::string("\x11\x22"));
+	CHECK(in.getStats().peeks == 3);
+	CHECK(in.getStats().reads == 0);
+	CHECK(in.getStats().bytesRead == 8);
+	CHECK(in.tell() == 0);
+	std::filesystem::remove(path);
+}
+
+TEST(filePeekPastEndKeepsStreamUsable){
+	std::string path = writeSample();
+	bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.peekUInt32(12) == 0xBEEF0000);
+	CHECK(in.readUInt32() == 0x11223344);
+	std::filesystem::remove(path);
+}
+
+TEST(filePeeksStayOutOfChecksum){
+	std::string path = writeSample();
+	bStream::CChecksum plain(bStream::ChecksumType::Crc32), peeked(bStream::ChecksumType::Crc32);
+	{
+		bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+		in.setChecksum(&plain);
+		in.readUInt32();
+	}
+	{
+		bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+		in.setChecksum(&peeked);
+		in.peekUInt64(4);
+		in.readUInt32();
+	}
+	CHECK(plain.value() == peeked.value());
+	std::filesystem::remove(path);
+}
+
+TEST(memoryPeeksMatchFilePeeks){
+	uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	bStream::CMemoryStream in(data, sizeof(data), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.peekUInt32(4) == 0x05060708);
+	CHECK(in.peekUInt16(0) == 0x0102);
+	CHECK(in.getStats().peeks == 2);
+	CHECK(in.getStats().reads == 0);
+	CHECK(in.getStats().bytesRead == 6);
+}
+
+TEST(memoryGrowthIsCounted){
+	bStream::CMemoryStream out(4, bStream::Endianess::Little, bStream::OpenMode::Out);
+	for(int i = 0; i < 64; i++) out.writeUInt32(i);
+	CHECK(out.getStats().writes == 64);
+	CHECK(out.getStats().bytesWritten == 256);
+	CHECK(out.getStats().reallocations > 0);
+}
+
+TEST(registryTotalsIncludeRetiredStreams){
+	bStream::StreamStats before = bStream::CStatsRegistry::instance().total();
+	{
+		bStream::CMemoryStream out(16, bStream::Endianess::Little, bStream::OpenMode::Out);
+		out.writeUInt32(1);
+	}
+	bStream::StreamStats after = bStream::CStatsRegistry::instance().total();
+	CHECK(after.writes == before.writes + 1);
+}
+
+TEST(failedMemoryReadsAreNotCounted){
+	uint8_t data[4] = { 1, 2, 3, 4 };
+	bStream::CMemoryStream in(data, sizeof(data), bStream::Endianess::Big, bStream::OpenMode::In);
+	uint8_t out[8];
+	in.readBytesTo(out, sizeof(out));
+	CHECK(in.readString(5).empty());
+	CHECK(in.readUInt64() == 0);
+	CHECK(in.getStats().reads == 0);
+	CHECK(in.getStats().bytesRead == 0);
+	in.readBytesTo(out, 4);
+	CHECK(in.getStats().bytesRead == 4);
+}
@@ -0,0 +1,64 @@
+#include "test.h"
+
+// Past the 32 bit limit, written sparse so the test needs no real disk space
+static const std::size_t FarOffset = (std::size_t(5) << 30) + 12;
+
+TEST(sparseFilesPastFourGigabytes){
+	std::string path = bStreamTest::tempPath("large_sparse.bin");
+	{
+		bStream::CFileStream out(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+		out.writeUInt64(0);
+		out.writeUInt32(0);
+		CHECK(out.seek(FarOffset));
+		CHECK(out.tell() == FarOffset);
+		out.writeOffsetAt64(0);
+		out.writeOffsetAt32(8);
+		CHECK(out.getError() == bStream::StreamError::OffsetOverflow);
+		out.clearError();
+		out.writeUInt64(0x0102030405060708ull);
+		out.writeInt64(-2);
+		CHECK(out.good());
+	}
+
+	bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.getSize() == FarOffset + 16);
+	CHECK(in.peekUInt64(0) == FarOffset);
+	CHECK(in.peekUInt32(8) == 0);
+	CHECK(in.peekUInt64(FarOffset) == 0x0102030405060708ull);
+	CHECK(in.peekInt64(FarOffset + 8) == -2);
+	CHECK(in.tell() == 0);
+	CHECK(in.seek(in.readUInt64()));
+	CHECK(in.readUInt64() == 0x0102030405060708ull);
+	CHECK(in.tell() == FarOffset + 8);
+
+	uint8_t raw[8] = {};
+	CHECK(in.readRanges({ { FarOffset, sizeof(raw), raw } }));
+	CHECK(raw[0] == 0x01 && raw[7] == 0x08);
+
+	bStream::CMappedFileStream mapped(path, bStream::Endianess::Big);
+	CHECK(mapped.getSize() == FarOffset + 16);
+	CHECK(mapped.peekUInt64(FarOffset) == 0x0102030405060708ull);
+	CHECK(mapped.seek(FarOffset + 8));
+	CHECK(mapped.readInt64() == -2);
+	std::filesystem::remove(path);
+}
+
+TEST(baseSixtyFourBitFallbacks){
+	// Qualified calls reach the CStream versions that subclasses without 64 bit overrides inherit
+	bStream::CMemoryStream stream(32, bStream::Endianess::Big, bStream::OpenMode::Out);
+	stream.CStream::writeUInt64(0x0102030405060708ull);
+	stream.CStream::writeInt64(-3);
+	stream.CStream::writeOffsetAt64(16);
+	CHECK(stream.tell() == 16);
+	stream.changeMode(bStream::OpenMode::In);
+	CHECK(stream.peekUInt64(0) == 0x0102030405060708ull);
+	CHECK(stream.peekInt64(8) == -3);
+	CHECK(stream.peekUInt64(16) == 16);
+
+	stream.seek(0);
+	CHECK(stream.CStream::readUInt64() == 0x0102030405060708ull);
+	CHECK(stream.CStream::readInt64() == -3);
+	CHECK(stream.CStream::peekUInt64(16) == 16);
+	CHECK(stream.CStream::peekInt64(8) == -3);
+	CHECK(stream.tell() == 16);
+}
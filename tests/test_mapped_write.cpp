@@ -0,0 +1,92 @@
+#include "test.h"
+
+static std::string writeSample(const std::string& name, std::size_t size){
+	std::string path = bStreamTest::tempPath(name);
+	bStream::CFileStream out(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+	for(std::size_t i = 0; i < size; i++) out.writeUInt8((uint8_t)i);
+	return path;
+}
+
+TEST(readOnlyMappingsRejectWrites){
+	std::string path = writeSample("mapped_ro.bin", 64);
+	{
+		bStream::CMappedFileStream stream(path, bStream::Endianess::Big);
+		CHECK(stream.isOpen());
+		CHECK(!stream.isWritable());
+		stream.writeUInt32(0xFFFFFFFF);
+		CHECK(stream.getError() == bStream::StreamError::ReadOnly);
+		CHECK(stream.tell() == 0);
+		stream.clearError();
+		stream.writeOffsetAt32(0);
+		stream.writeBytes((uint8_t*)"abcd", 4);
+		stream.writeStringSJIS("abcd");
+		CHECK(!stream.convertToNative(0, { { 4 }, 4, 4 }));
+		CHECK(stream.getError() == bStream::StreamError::ReadOnly);
+		CHECK(stream.getDirtyRanges().empty());
+		CHECK(!stream.changeMode(bStream::OpenMode::Out));
+		CHECK(stream.peekUInt32(0) == 0x00010203);
+	}
+	bStream::CFileStream check(path, bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(check.readUInt32() == 0x00010203);
+	std::filesystem::remove(path);
+}
+
+TEST(writableMappingsPatchAndGrow){
+	std::string path = writeSample("mapped_rw.bin", 8192);
+	{
+		bStream::CMappedFileStream stream(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+		CHECK(stream.isWritable());
+		stream.seek(4096);
+		stream.writeUInt32(0xDEADBEEF);
+		CHECK(stream.getDirtyRanges().size() == 1);
+		CHECK(stream.flush());
+		CHECK(stream.getDirtyRanges().empty());
+
+		stream.seek(8192);
+		for(int i = 0; i < 3000; i++) stream.writeUInt32(i);
+		stream.writeOffsetAt32(0);
+		CHECK(stream.good());
+	}
+	bStream::CFileStream check(path, bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(check.getSize() == 8192 + 12000);
+	CHECK(check.peekUInt32(0) == 8192 + 12000);
+	CHECK(check.peekUInt32(4096) == 0xDEADBEEF);
+	CHECK(check.peekUInt32(8192 + 4 * 2999) == 2999);
+	std::filesystem::remove(path);
+}
+
+TEST(createsMissingFiles){
+	std::string path = bStreamTest::tempPath("mapped_new.bin");
+	{
+		bStream::CMappedFileStream stream(path, bStream::Endianess::Little, bStream::OpenMode::Out);
+		CHECK(stream.isOpen());
+		stream.writeString("hello");
+	}
+	CHECK(std::filesystem::file_size(path) == 5);
+	std::filesystem::remove(path);
+}
+
+TEST(fixedBuffersRejectOverruns){
+	uint8_t data[12] = {};
+	bStream::CMemoryStream stream(data, 8, bStream::Endianess::Little, bStream::OpenMode::Out);
+	stream.writeUInt32(1);
+	stream.writeUInt64(2);
+	CHECK(stream.getError() == bStream::StreamError::OutOfBounds);
+	CHECK(stream.tell() == 4);
+	CHECK(data[4] == 0 && data[8] == 0);
+	stream.writeOffsetAt32(6);
+	CHECK(data[8] == 0);
+}
+
+TEST(streamsDeleteThroughTheBase){
+	bStream::CStream* stream = new bStream::CMemoryStream(bStream::CBufferPool::instance(), 64, bStream::Endianess::Big, bStream::OpenMode::Out);
+	stream->writeUInt32(1);
+	delete stream;
+
+	std::string path = bStreamTest::tempPath("mapped_base.bin");
+	stream = new bStream::CMappedFileStream(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+	stream->writeUInt16(7);
+	delete stream;
+	CHECK(std::filesystem::file_size(path) == 2);
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,77 @@
+#include "test.h"
+
+static std::string writeCounting(const std::string& name, std::size_t count){
+	std::string path = bStreamTest::tempPath(name);
+	bStream::CFileStream out(path, bStream::Endianess::Little, bStream::OpenMode::Out);
+	for(std::size_t i = 0; i < count; i++) out.writeUInt32(i);
+	return path;
+}
+
+TEST(fileRangesMatchPeeks){
+	std::string path = writeCounting("ranges.bin", 0x4000);
+	bStream::CFileStream in(path, bStream::Endianess::Little, bStream::OpenMode::In);
+	in.seek(12);
+
+	// Close neighbours share a call, the far one and the overlapping one get their own
+	uint32_t values[5] = {};
+	std::vector<bStream::ReadRange> ranges = {
+		{ 4 * 900, 4, &values[0] },
+		{ 4 * 3, 4, &values[1] },
+		{ 4 * 10, 4, &values[2] },
+		{ 4 * 10, 4, &values[3] },
+		{ 4 * 0x3FFF, 4, &values[4] },
+	};
+	std::vector<std::size_t> failed;
+	CHECK(in.readRanges(ranges, 0x100, &failed));
+	CHECK(failed.empty());
+	CHECK(values[0] == 900 && values[1] == 3 && values[2] == 10 && values[3] == 10 && values[4] == 0x3FFF);
+	CHECK(in.tell() == 12);
+	std::filesystem::remove(path);
+}
+
+TEST(fileRangesReportWhatWasNotRead){
+	std::string path = writeCounting("ranges_short.bin", 16);
+	bStream::CFileStream in(path, bStream::Endianess::Little, bStream::OpenMode::In);
+	uint32_t values[4] = {};
+	uint8_t straddle[8] = {};
+	std::vector<bStream::ReadRange> ranges = {
+		{ 4 * 2, 4, &values[0] },
+		{ 4 * 40, 4, &values[1] },
+		{ 60, sizeof(straddle), straddle },
+		{ 4 * 5, 4, &values[2] },
+	};
+	std::vector<std::size_t> failed;
+	CHECK(!in.readRanges(ranges, 0x1000, &failed));
+	std::sort(failed.begin(), failed.end());
+	CHECK(failed == std::vector<std::size_t>({ 1, 2 }));
+	CHECK(values[0] == 2 && values[2] == 5);
+	CHECK(!in.readRanges(ranges));
+	std::filesystem::remove(path);
+}
+
+TEST(memoryAndGenericRangesReportFailures){
+	bStream::CMemoryStream stream(64, bStream::Endianess::Little, bStream::OpenMode::Out);
+	for(uint32_t i = 0; i < 16; i++) stream.writeUInt32(i);
+	stream.changeMode(bStream::OpenMode::In);
+	stream.seek(8);
+
+	uint32_t values[3] = {};
+	std::vector<bStream::ReadRange> ranges = {
+		{ 4 * 7, 4, &values[0] },
+		{ 62, 4, &values[1] },
+		{ 4 * 1, 4, &values[2] },
+	};
+	std::vector<std::size_t> failed;
+	CHECK(!stream.readRanges(ranges, 0, &failed));
+	CHECK(failed == std::vector<std::size_t>({ 1 }));
+	CHECK(values[0] == 7 && values[2] == 1);
+	stream.clearError();
+
+	// The fallback every other stream inherits
+	values[0] = values[2] = 0;
+	failed.clear();
+	CHECK(!stream.CStream::readRanges(ranges, 0, &failed));
+	CHECK(failed == std::vector<std::size_t>({ 1 }));
+	CHECK(values[0] == 7 && values[2] == 1);
+	CHECK(stream.tell() == 8);
+}
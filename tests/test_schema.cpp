@@ -0,0 +1,135 @@
+#include "test.h"
+
+struct Child {
+	uint16_t id = 0;
+	float weight = 0;
+};
+
+struct Header {
+	uint32_t magic = 0;
+	int16_t values[3] = {};
+	Child child;
+	uint8_t flag = 0;
+};
+
+using ChildSchema = bStream::Schema<Child, bStream::Field<&Child::id>, bStream::Padding<2>, bStream::Field<&Child::weight>>;
+using HeaderSchema = bStream::Schema<Header,
+	bStream::Field<&Header::magic>, bStream::Array<&Header::values>, bStream::OffsetTo<&Header::child, ChildSchema>,
+	bStream::Field<&Header::flag>, bStream::Align<4>>;
+using WideSchema = bStream::Schema<Header,
+	bStream::Field<&Header::magic>, bStream::OffsetTo<&Header::child, ChildSchema, uint64_t>>;
+
+static_assert(ChildSchema::size == 8, "child layout");
+static_assert(HeaderSchema::size == 16, "header layout");
+static_assert(HeaderSchema::totalSize == 24, "header plus child");
+
+static Header sample(){
+	Header h;
+	h.magic = 0x48445230;
+	h.values[0] = -1;
+	h.values[1] = 2;
+	h.values[2] = 300;
+	h.child.id = 0xBEEF;
+	h.child.weight = 1.5f;
+	h.flag = 9;
+	return h;
+}
+
+static bool same(const Header& a, const Header& b){
+	return a.magic == b.magic && a.values[0] == b.values[0] && a.values[1] == b.values[1] && a.values[2] == b.values[2] &&
+		a.child.id == b.child.id && a.child.weight == b.child.weight && a.flag == b.flag;
+}
+
+TEST(roundTripBothOrders){
+	for(bStream::Endianess order : { bStream::Endianess::Big, bStream::Endianess::Little }){
+		bStream::CMemoryStream out(HeaderSchema::totalSize, order, bStream::OpenMode::Out);
+		HeaderSchema::write(out, sample());
+		CHECK(out.getSize() == HeaderSchema::totalSize);
+
+		bStream::CMemoryStream in(out.getBuffer(), out.getSize(), order, bStream::OpenMode::In);
+		Header h;
+		CHECK(HeaderSchema::read(in, h));
+		CHECK(same(h, sample()));
+		CHECK(in.tell() == HeaderSchema::size);
+	}
+}
+
+TEST(bigEndianLayoutOnDisk){
+	bStream::CMemoryStream out(HeaderSchema::totalSize, bStream::Endianess::Big, bStream::OpenMode::Out);
+	HeaderSchema::write(out, sample());
+	bStream::CMemoryStream in(out.getBuffer(), out.getSize(), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.peekUInt32(0) == 0x48445230);
+	CHECK(in.peekInt16(8) == 300);
+	CHECK(in.peekUInt32(10) == 16);
+	CHECK(in.peekUInt16(16) == 0xBEEF);
+}
+
+TEST(wideOffsets){
+	bStream::CMemoryStream out(16, bStream::Endianess::Big, bStream::OpenMode::Out);
+	WideSchema::write(out, sample());
+	bStream::CMemoryStream in(out.getBuffer(), out.getSize(), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.peekUInt64(4) == 12);
+	Header h;
+	CHECK(WideSchema::read(in, h));
+	CHECK(h.child.id == 0xBEEF);
+}
+
+TEST(zeroOffsetIsAbsent){
+	bStream::CMemoryStream out(HeaderSchema::totalSize, bStream::Endianess::Big, bStream::OpenMode::Out);
+	HeaderSchema::write(out, sample());
+	uint8_t* data = out.getBuffer();
+	memset(data + 10, 0, 4);
+
+	bStream::CMemoryStream in(data, HeaderSchema::size, bStream::Endianess::Big, bStream::OpenMode::In);
+	Header h;
+	h.child.id = 77;
+	CHECK(HeaderSchema::read(in, h));
+	CHECK(h.child.id == 77);
+	CHECK(h.flag == 9);
+	CHECK(in.good());
+}
+
+TEST(truncatedRecordConsumesNothing){
+	bStream::CMemoryStream out(HeaderSchema::totalSize, bStream::Endianess::Big, bStream::OpenMode::Out);
+	HeaderSchema::write(out, sample());
+	bStream::CMemoryStream in(out.getBuffer(), HeaderSchema::size - 1, bStream::Endianess::Big, bStream::OpenMode::In);
+	Header h;
+	CHECK(!HeaderSchema::read(in, h));
+	CHECK(in.tell() == 0);
+}
+
+TEST(truncatedChildFails){
+	bStream::CMemoryStream out(HeaderSchema::totalSize, bStream::Endianess::Big, bStream::OpenMode::Out);
+	HeaderSchema::write(out, sample());
+	bStream::CMemoryStream in(out.getBuffer(), HeaderSchema::totalSize - 2, bStream::Endianess::Big, bStream::OpenMode::In);
+	Header h;
+	CHECK(!HeaderSchema::read(in, h));
+}
+
+TEST(typeErasedStreamsStillFailShortReads){
+	bStream::CMemoryStream out(HeaderSchema::totalSize, bStream::Endianess::Big, bStream::OpenMode::Out);
+	HeaderSchema::write(out, sample());
+	bStream::CMemoryStream memory(out.getBuffer(), HeaderSchema::size - 1, bStream::Endianess::Big, bStream::OpenMode::In);
+	bStream::CStream& erased = memory;
+	Header h;
+	CHECK(!HeaderSchema::read(erased, h));
+
+	std::string path = bStreamTest::tempPath("schema.bin");
+	{
+		bStream::CFileStream file(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+		HeaderSchema::write(file, sample());
+	}
+	{
+		bStream::CFileStream file(path, bStream::Endianess::Big, bStream::OpenMode::In);
+		Header fromFile;
+		CHECK(HeaderSchema::read(file, fromFile));
+		CHECK(same(fromFile, sample()));
+	}
+	std::filesystem::resize_file(path, HeaderSchema::totalSize - 1);
+	{
+		bStream::CFileStream file(path, bStream::Endianess::Big, bStream::OpenMode::In);
+		Header fromFile;
+		CHECK(!HeaderSchema::read(file, fromFile));
+	}
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,122 @@
+#include "test.h"
+
+static const std::size_t Chunk = 0x10000;
+
+static void fill(bStream::CMemoryStream& stream, std::size_t words){
+	for(std::size_t i = 0; i < words; i++) stream.writeUInt32(uint32_t(i));
+}
+
+TEST(snapshotsKeepTheirContents){
+	bStream::CMemoryStream stream(4 * Chunk, bStream::Endianess::Little, bStream::OpenMode::Out);
+	fill(stream, Chunk);
+	std::unique_ptr<bStream::CMemoryStream> before = stream.snapshot();
+
+	// A write straddling a chunk boundary copies both chunks
+	stream.seek(Chunk - 2);
+	stream.writeUInt32(0xFFFFFFFF);
+	stream.seek(4 * Chunk);
+	stream.writeUInt64(7);
+	CHECK(stream.good());
+
+	before->seek(0);
+	before->writeUInt32(0xAAAAAAAA);
+	std::unique_ptr<bStream::CMemoryStream> after = stream.snapshot();
+
+	stream.changeMode(bStream::OpenMode::In);
+	before->changeMode(bStream::OpenMode::In);
+	after->changeMode(bStream::OpenMode::In);
+	CHECK(stream.peekUInt32(0) == 0);
+	CHECK(stream.peekUInt16(Chunk) == 0xFFFF);
+	CHECK(stream.peekUInt64(4 * Chunk) == 7);
+	CHECK(before->peekUInt32(0) == 0xAAAAAAAA);
+	CHECK(before->peekUInt32(Chunk - 4) == (Chunk - 4) / 4);
+	CHECK(before->peekUInt32(Chunk) == Chunk / 4);
+	CHECK(before->getSize() == 4 * Chunk);
+	CHECK(after->peekUInt16(Chunk) == 0xFFFF);
+	CHECK(after->getSize() == 4 * Chunk + 8);
+}
+
+TEST(releasedSlotsComeBackZeroed){
+	bStream::CMemoryStream stream(Chunk, bStream::Endianess::Little, bStream::OpenMode::Out);
+	fill(stream, Chunk / 4);
+	for(int round = 0; round < 4; round++){
+		std::unique_ptr<bStream::CMemoryStream> copy = stream.snapshot();
+		copy->seek(0);
+		fill(*copy, Chunk / 4);
+		copy->seek(2 * Chunk);
+		copy->writeUInt8(1);
+	}
+
+	// Growing takes the slots the snapshots gave back, which must read as zeros
+	stream.seek(3 * Chunk);
+	stream.writeUInt8(1);
+	stream.changeMode(bStream::OpenMode::In);
+	bool zero = true;
+	for(std::size_t at = Chunk; at < 3 * Chunk; at += 8) zero = zero && stream.peekUInt64(at) == 0;
+	CHECK(zero);
+}
+
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+
+TEST(staleSlotsAreClearedForZeroedUse){
+	bStream::CChunkStore store;
+	std::lock_guard<std::mutex> lock(store.mMutex);
+	int64_t slot = store.allocate();
+	CHECK(slot == 0);
+	std::vector<uint8_t> junk(Chunk, 0x5A);
+	CHECK(pwrite(store.mFd, junk.data(), Chunk, 0) == (ssize_t)Chunk);
+
+	// Pretend the hole punch failed, the slot is still reused but wiped first
+	store.release(0);
+	CHECK(store.mFree.size() == 1);
+	store.mStale[0] = 1;
+	CHECK(pwrite(store.mFd, junk.data(), Chunk, 0) == (ssize_t)Chunk);
+	CHECK(store.allocate() == 0);
+	CHECK(pread(store.mFd, junk.data(), Chunk, 0) == (ssize_t)Chunk);
+	CHECK(std::count(junk.begin(), junk.end(), 0) == (long)Chunk);
+}
+
+// Reaches the store of a stream so a test can break it
+struct ChunkProbe : bStream::CMemoryStream {
+	using bStream::CMemoryStream::CMemoryStream;
+	int storeFd() { return mChunks ? mChunks->mFd : -1; }
+};
+
+TEST(failedCopiesSkipTheWrite){
+	ChunkProbe stream(Chunk, bStream::Endianess::Big, bStream::OpenMode::Out);
+	fill(stream, Chunk / 4);
+	std::unique_ptr<bStream::CMemoryStream> before = stream.snapshot();
+	int fd = stream.storeFd();
+	CHECK(fd >= 0);
+
+	// Swap the memfd for a read only descriptor so copying the chunk fails
+	int saved = dup(fd);
+	int readOnly = open("/dev/null", O_RDONLY);
+	CHECK(dup2(readOnly, fd) == fd);
+	stream.seek(16);
+	stream.writeUInt32(0xFFFFFFFF);
+	CHECK(stream.getError() == bStream::StreamError::AllocationFailed);
+	CHECK(!stream.convertToNative(0, { { 4 }, 4, 4 }));
+	dup2(saved, fd);
+	close(saved);
+	close(readOnly);
+
+	before->changeMode(bStream::OpenMode::In);
+	CHECK(before->peekUInt32(16) == 4);
+	stream.clearError();
+	stream.seek(16);
+	stream.writeUInt32(0xFFFFFFFF);
+	CHECK(stream.good());
+	CHECK(before->peekUInt32(16) == 4);
+}
+
+#endif
+
+TEST(defaultStreamsAreEmpty){
+	bStream::CMemoryStream* stream = new bStream::CMemoryStream();
+	CHECK(stream->getSize() == 0);
+	CHECK(stream->tell() == 0);
+	CHECK(stream->getBuffer() == nullptr);
+	CHECK(stream->getOrder() == bStream::getSystemEndianess());
+	delete stream;
+}
@@ -0,0 +1,82 @@
+#include "test.h"
+
+static std::string decodeUtf16(const std::vector<uint8_t>& in){
+	std::string out(in.size() * 3, '\0');
+	out.resize(bStream::utf16beToUtf8(in.data(), in.size(), &out[0]));
+	return out;
+}
+
+static std::vector<uint8_t> encodeUtf16(const std::string& text){
+	std::vector<uint8_t> out(text.size() * 2);
+	out.resize(bStream::utf8ToUtf16be(text.data(), text.size(), out.data()));
+	return out;
+}
+
+TEST(asciiBlocksEndCleanly){
+	// 16 and 32 code units end exactly on the vectorized blocks
+	for(std::size_t units : { 8, 16, 32, 33 }){
+		std::string text;
+		for(std::size_t i = 0; i < units; i++) text += char('a' + i % 26);
+		std::vector<uint8_t> utf16 = encodeUtf16(text);
+		CHECK(utf16.size() == units * 2);
+		CHECK(decodeUtf16(utf16) == text);
+	}
+}
+
+TEST(oddTrailingByteIsReplaced){
+	std::vector<uint8_t> utf16 = encodeUtf16("abcdefghijklmnop");
+	utf16.push_back('q');
+	CHECK(decodeUtf16(utf16) == "abcdefghijklmnop\xEF\xBF\xBD");
+}
+
+TEST(surrogatePairs){
+	CHECK(decodeUtf16({ 0xD8, 0x3D, 0xDE, 0x00 }) == "\xF0\x9F\x98\x80");
+	CHECK(decodeUtf16({ 0xD8, 0x3D, 0x00, 0x41 }) == "\xEF\xBF\xBD" "A");
+	CHECK(decodeUtf16({ 0xDE, 0x00 }) == "\xEF\xBF\xBD");
+
+	std::string mixed = "0123456789abcdef\xE3\x81\x82\xF0\x9F\x98\x80xyz";
+	CHECK(decodeUtf16(encodeUtf16(mixed)) == mixed);
+}
+
+TEST(shiftJisRoundTrip){
+	std::string text = "model_\xE3\x81\x82\xE3\x81\x84_0123456789.bmd";
+	uint8_t sjis[64];
+	std::size_t size = bStream::utf8ToSjis(text.data(), text.size(), sjis);
+	CHECK(sjis[6] == 0x82 && sjis[7] == 0xA0);
+	char utf8[192];
+	CHECK(std::string(utf8, bStream::sjisToUtf8(sjis, size, utf8)) == text);
+}
+
+TEST(streamsReadAndWriteText){
+	bStream::CMemoryStream stream(64, bStream::Endianess::Big, bStream::OpenMode::Out);
+	std::size_t utf16 = stream.writeStringUTF16BE("abcdefghijklmnop");
+	std::size_t sjis = stream.writeStringSJIS("\xE3\x81\x82");
+	CHECK(utf16 == 32 && sjis == 2);
+	stream.changeMode(bStream::OpenMode::In);
+	stream.seek(0);
+	CHECK(stream.readStringUTF16BE(utf16) == "abcdefghijklmnop");
+	CHECK(stream.readStringSJIS(sjis) == "\xE3\x81\x82");
+}
+
+TEST(fileReadsStopAtTheEnd){
+	std::string path = bStreamTest::tempPath("text_short.bin");
+	{
+		bStream::CFileStream out(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+		out.writeString("AB");
+	}
+	{
+		bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+		CHECK(in.readStringSJIS(200) == "AB");
+	}
+	{
+		bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+		CHECK(in.readStringUTF16BE(200) == "\xE4\x85\x82");
+	}
+	{
+		bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+		in.skip(1);
+		char out[600];
+		CHECK(in.readStringSJIS(200, out) == 1 && out[0] == 'B');
+	}
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,79 @@
+#include "test.h"
+
+static bStream::CTraceLog recordSample(){
+	uint8_t data[64] = {};
+	bStream::CMemoryStream target(data, sizeof(data), bStream::Endianess::Big, bStream::OpenMode::In);
+	bStream::CTraceStream trace(target);
+	trace.readUInt32();
+	trace.readUInt32();
+	trace.seek(32);
+	trace.readUInt16();
+	trace.peekUInt8(0);
+	trace.seek(0);
+	trace.readUInt32();
+	return trace.getLog();
+}
+
+TEST(saveAndLoadRoundTrip){
+	bStream::CTraceLog log = recordSample();
+	bStream::CMemoryStream saved(16, bStream::Endianess::Big, bStream::OpenMode::Out);
+	log.save(saved);
+
+	bStream::CMemoryStream in(saved.getBuffer(), saved.getSize(), bStream::Endianess::Big, bStream::OpenMode::In);
+	bStream::CTraceLog loaded;
+	CHECK(loaded.load(in));
+	CHECK(loaded.getEntries().size() == log.getEntries().size());
+	for(std::size_t i = 0; i < log.getEntries().size() && i < loaded.getEntries().size(); i++){
+		CHECK(loaded.getEntries()[i].offset == log.getEntries()[i].offset);
+		CHECK(loaded.getEntries()[i].length == log.getEntries()[i].length);
+		CHECK(loaded.getEntries()[i].op == log.getEntries()[i].op);
+	}
+}
+
+TEST(analyzeCountsAccesses){
+	bStream::TraceStats stats = recordSample().analyze(16);
+	CHECK(stats.reads == 4);
+	CHECK(stats.peeks == 1);
+	CHECK(stats.seeks == 2);
+	CHECK(stats.bytesReRead > 0);
+}
+
+TEST(truncatedLogFails){
+	bStream::CTraceLog log = recordSample();
+	bStream::CMemoryStream saved(16, bStream::Endianess::Big, bStream::OpenMode::Out);
+	log.save(saved);
+
+	for(std::size_t cut = 0; cut < saved.getSize(); cut++){
+		bStream::CMemoryStream in(saved.getBuffer(), cut, bStream::Endianess::Big, bStream::OpenMode::In);
+		bStream::CTraceLog loaded;
+		CHECK(!loaded.load(in));
+		CHECK(loaded.getEntries().empty());
+	}
+}
+
+TEST(hugeCountFailsWithoutAllocating){
+	// A count of 2^62 followed by a single entry
+	uint8_t data[] = { 'B', 'S', 'T', 'R', 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0, 0, 4 };
+	bStream::CMemoryStream in(data, sizeof(data), bStream::Endianess::Big, bStream::OpenMode::In);
+	bStream::CTraceLog loaded;
+	CHECK(!loaded.load(in));
+	CHECK(loaded.getEntries().empty());
+}
+
+TEST(badOpAndOverlongVarintFail){
+	uint8_t badOp[] = { 'B', 'S', 'T', 'R', 1, 9, 0, 4 };
+	bStream::CMemoryStream first(badOp, sizeof(badOp), bStream::Endianess::Big, bStream::OpenMode::In);
+	bStream::CTraceLog loaded;
+	CHECK(!loaded.load(first));
+
+	uint8_t overlong[] = { 'B', 'S', 'T', 'R', 1, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 4 };
+	bStream::CMemoryStream second(overlong, sizeof(overlong), bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(!loaded.load(second));
+}
+
+TEST(wrongMagicFails){
+	uint8_t data[] = { 'B', 'S', 'T', 'X', 0 };
+	bStream::CMemoryStream in(data, sizeof(data), bStream::Endianess::Big, bStream::OpenMode::In);
+	bStream::CTraceLog loaded;
+	CHECK(!loaded.load(in));
+}
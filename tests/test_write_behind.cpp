@@ -0,0 +1,78 @@
+#include "test.h"
+
+static std::vector<uint8_t> readAll(const std::string& path){
+	bStream::CFileStream in(path, bStream::OpenMode::In);
+	std::vector<uint8_t> data(in.getSize());
+	in.readBytesTo(data.data(), data.size());
+	return data;
+}
+
+TEST(matchesUnbufferedOutput){
+	std::string plain = bStreamTest::tempPath("plain.bin"), buffered = bStreamTest::tempPath("buffered.bin");
+	for(const std::string& path : { plain, buffered }){
+		bStream::CFileStream out(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+		if(path == buffered) CHECK(out.enableWriteBehind(4096));
+		for(uint32_t i = 0; i < 10000; i++){
+			out.writeUInt32(i);
+			out.writeUInt8((uint8_t)i);
+			if(i % 1000 == 0) out.writeString("marker");
+		}
+		out.alignTo(32);
+		CHECK(out.tell() % 32 == 0);
+	}
+	CHECK(readAll(plain) == readAll(buffered));
+	std::filesystem::remove(plain);
+	std::filesystem::remove(buffered);
+}
+
+TEST(patchesReachFlushedData){
+	std::string path = bStreamTest::tempPath("patch.bin");
+	{
+		bStream::CFileStream out(path, bStream::Endianess::Big, bStream::OpenMode::Out);
+		CHECK(out.enableWriteBehind(64));
+		out.writeUInt32(0);
+		for(int i = 0; i < 100; i++) out.writeUInt32(0xAAAAAAAA);
+		// The first offset has long since been flushed, the second is still buffered
+		out.writeOffsetAt32(0);
+		out.writeUInt32(0);
+		out.writeOffsetAt32(out.tell() - 4);
+		CHECK(out.disableWriteBehind());
+	}
+	bStream::CFileStream in(path, bStream::Endianess::Big, bStream::OpenMode::In);
+	CHECK(in.getSize() == 408);
+	CHECK(in.peekUInt32(0) == 404);
+	CHECK(in.peekUInt32(404) == 408);
+	CHECK(in.peekUInt32(200) == 0xAAAAAAAA);
+	std::filesystem::remove(path);
+}
+
+TEST(seekBackAndOverwrite){
+	std::string path = bStreamTest::tempPath("seek.bin");
+	{
+		bStream::CFileStream out(path, bStream::Endianess::Little, bStream::OpenMode::Out);
+		CHECK(out.enableWriteBehind(16));
+		for(int i = 0; i < 64; i++) out.writeUInt8((uint8_t)i);
+		out.seek(10);
+		out.writeUInt8(0xFF);
+		CHECK(out.getSize() == 64);
+		out.seek(64);
+		out.writeUInt8(64);
+	}
+	std::vector<uint8_t> data = readAll(path);
+	CHECK(data.size() == 65);
+	CHECK(data[10] == 0xFF);
+	CHECK(data[11] == 11);
+	CHECK(data[64] == 64);
+	std::filesystem::remove(path);
+}
+
+TEST(preallocationIsTrimmed){
+	std::string path = bStreamTest::tempPath("prealloc.bin");
+	{
+		bStream::CFileStream out(path, bStream::OpenMode::Out);
+		CHECK(out.enableWriteBehind(1024, 1 << 20));
+		for(int i = 0; i < 1000; i++) out.writeUInt16((uint16_t)i);
+	}
+	CHECK(std::filesystem::file_size(path) == 2000);
+	std::filesystem::remove(path);
+}